@@ -44,12 +44,15 @@ typedef struct _mp_obj_btree_t {
     mp_obj_t end_key;
     #define FLAG_END_KEY_INCL 1
     #define FLAG_DESC 2
+    #define FLAG_REUSE 4
     #define FLAG_ITER_TYPE_MASK 0xc0
     #define FLAG_ITER_KEYS   0x40
     #define FLAG_ITER_VALUES 0x80
     #define FLAG_ITER_ITEMS  0xc0
     byte flags;
     byte next_flags;
+    // callee-owned tuple, returned by items() with FLAG_REUSE
+    mp_obj_t item;
 } mp_obj_btree_t;
 
 STATIC const mp_obj_type_t btree_type;
@@ -70,6 +73,7 @@ STATIC mp_obj_btree_t *btree_new(DB *db) {
     o->start_key = mp_const_none;
     o->end_key = mp_const_none;
     o->next_flags = 0;
+    o->item = MP_OBJ_NULL;
     return o;
 }
 
@@ -101,6 +105,44 @@ STATIC mp_obj_t btree_put(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(btree_put_obj, 3, 4, btree_put);
 
+STATIC void btree_put_pair(mp_obj_btree_t *self, mp_obj_t key_in, mp_obj_t val_in) {
+    DBT key, val;
+    key.data = (void*)mp_obj_str_get_data(key_in, &key.size);
+    val.data = (void*)mp_obj_str_get_data(val_in, &val.size);
+    int res = __bt_put(self->db, &key, &val, 0);
+    CHECK_ERROR(res);
+}
+
+// Store a batch of key/value pairs, given as a dict or an iterable of
+// pairs, and flush the database once at the end.  If the keys are in
+// ascending order then each one is appended to the last leaf page, and
+// full leaf pages are split by starting a new empty page, so the leaves
+// are left packed.
+STATIC mp_obj_t btree_update(mp_obj_t self_in, mp_obj_t items_in) {
+    mp_obj_btree_t *self = MP_OBJ_TO_PTR(self_in);
+    if (mp_obj_is_type(items_in, &mp_type_dict)) {
+        mp_map_t *map = mp_obj_dict_get_map(items_in);
+        for (size_t i = 0; i < map->alloc; i++) {
+            if (mp_map_slot_is_filled(map, i)) {
+                btree_put_pair(self, map->table[i].key, map->table[i].value);
+            }
+        }
+    } else {
+        mp_obj_iter_buf_t iter_buf;
+        mp_obj_t iterable = mp_getiter(items_in, &iter_buf);
+        mp_obj_t item;
+        while ((item = mp_iternext(iterable)) != MP_OBJ_STOP_ITERATION) {
+            mp_obj_t *pair;
+            mp_obj_get_array_fixed_n(item, 2, &pair);
+            btree_put_pair(self, pair[0], pair[1]);
+        }
+    }
+    int res = __bt_sync(self->db, 0);
+    CHECK_ERROR(res);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(btree_update_obj, btree_update);
+
 STATIC mp_obj_t btree_get(size_t n_args, const mp_obj_t *args) {
     mp_obj_btree_t *self = MP_OBJ_TO_PTR(args[0]);
     DBT key, val;
@@ -237,7 +279,15 @@ STATIC mp_obj_t btree_iternext(mp_obj_t self_in) {
         case FLAG_ITER_VALUES:
             return mp_obj_new_bytes(val.data, val.size);
         default: {
-            mp_obj_t pair_o = mp_obj_new_tuple(2, NULL);
+            mp_obj_t pair_o;
+            if (self->flags & FLAG_REUSE) {
+                if (self->item == MP_OBJ_NULL) {
+                    self->item = mp_obj_new_tuple(2, NULL);
+                }
+                pair_o = self->item;
+            } else {
+                pair_o = mp_obj_new_tuple(2, NULL);
+            }
             mp_obj_tuple_t *pair = MP_OBJ_TO_PTR(pair_o);
             pair->items[0] = mp_obj_new_bytes(key.data, key.size);
             pair->items[1] = mp_obj_new_bytes(val.data, val.size);
@@ -300,6 +350,7 @@ STATIC const mp_rom_map_elem_t btree_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&btree_flush_obj) },
     { MP_ROM_QSTR(MP_QSTR_get), MP_ROM_PTR(&btree_get_obj) },
     { MP_ROM_QSTR(MP_QSTR_put), MP_ROM_PTR(&btree_put_obj) },
+    { MP_ROM_QSTR(MP_QSTR_update), MP_ROM_PTR(&btree_update_obj) },
     { MP_ROM_QSTR(MP_QSTR_seq), MP_ROM_PTR(&btree_seq_obj) },
     { MP_ROM_QSTR(MP_QSTR_keys), MP_ROM_PTR(&btree_keys_obj) },
     { MP_ROM_QSTR(MP_QSTR_values), MP_ROM_PTR(&btree_values_obj) },
@@ -365,6 +416,7 @@ STATIC const mp_rom_map_elem_t mp_module_btree_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_open), MP_ROM_PTR(&mod_btree_open_obj) },
     { MP_ROM_QSTR(MP_QSTR_INCL), MP_ROM_INT(FLAG_END_KEY_INCL) },
     { MP_ROM_QSTR(MP_QSTR_DESC), MP_ROM_INT(FLAG_DESC) },
+    { MP_ROM_QSTR(MP_QSTR_REUSE), MP_ROM_INT(FLAG_REUSE) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_btree_globals, mp_module_btree_globals_table);
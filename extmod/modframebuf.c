@@ -39,6 +39,10 @@ typedef struct _mp_obj_framebuf_t {
     void *buf;
     uint16_t width, height, stride;
     uint8_t format;
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    // region drawn to since the last call to dirty(), empty if dirty_x1 is 0
+    uint16_t dirty_x0, dirty_y0, dirty_x1, dirty_y1;
+    #endif
 } mp_obj_framebuf_t;
 
 typedef void (*setpixel_t)(const mp_obj_framebuf_t*, int, int, uint32_t);
@@ -49,6 +53,8 @@ typedef struct _mp_framebuf_p_t {
     setpixel_t setpixel;
     getpixel_t getpixel;
     fill_rect_t fill_rect;
+    // bits per pixel if each row of pixels is stored in consecutive bytes, else 0
+    uint8_t row_bits;
 } mp_framebuf_p_t;
 
 // constants for formats
@@ -77,14 +83,29 @@ STATIC uint32_t mono_horiz_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
 STATIC void mono_horiz_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
     int reverse = fb->format == FRAMEBUF_MHMSB;
     int advance = fb->stride >> 3;
-    while (w--) {
-        uint8_t *b = &((uint8_t*)fb->buf)[(x >> 3) + y * advance];
-        int offset = reverse ?  x & 7 : 7 - (x & 7);
-        for (int hh = h; hh; --hh) {
-            *b = (*b & ~(0x01 << offset)) | ((col != 0) << offset);
-            b += advance;
+    // masks of the pixels to set in the first and last bytes of each row
+    int first = x >> 3;
+    int last = (x + w - 1) >> 3;
+    uint8_t first_mask, last_mask;
+    if (reverse) {
+        first_mask = 0xff << (x & 7);
+        last_mask = 0xff >> (7 - ((x + w - 1) & 7));
+    } else {
+        first_mask = 0xff >> (x & 7);
+        last_mask = 0xff << (7 - ((x + w - 1) & 7));
+    }
+    if (first == last) {
+        first_mask &= last_mask;
+    }
+    uint8_t col_byte = col ? 0xff : 0x00;
+    uint8_t *b = &((uint8_t*)fb->buf)[first + y * advance];
+    while (h--) {
+        b[0] = (b[0] & ~first_mask) | (col_byte & first_mask);
+        if (last > first) {
+            memset(b + 1, col_byte, last - first - 1);
+            b[last - first] = (b[last - first] & ~last_mask) | (col_byte & last_mask);
         }
-        ++x;
+        b += advance;
     }
 }
 
@@ -101,14 +122,23 @@ STATIC uint32_t mvlsb_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
 }
 
 STATIC void mvlsb_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
-    while (h--) {
+    uint8_t col_byte = col ? 0xff : 0x00;
+    while (h > 0) {
+        // set the rows of this page of 8 rows that are in the rectangle
         uint8_t *b = &((uint8_t*)fb->buf)[(y >> 3) * fb->stride + x];
-        uint8_t offset = y & 0x07;
-        for (int ww = w; ww; --ww) {
-            *b = (*b & ~(0x01 << offset)) | ((col != 0) << offset);
-            ++b;
+        int offset = y & 0x07;
+        int rows = MIN(h, 8 - offset);
+        uint8_t mask = (0xff >> (8 - rows)) << offset;
+        if (mask == 0xff) {
+            memset(b, col_byte, w);
+        } else {
+            for (int ww = w; ww; --ww) {
+                *b = (*b & ~mask) | (col_byte & mask);
+                ++b;
+            }
         }
-        ++y;
+        y += rows;
+        h -= rows;
     }
 }
 
@@ -124,11 +154,28 @@ STATIC uint32_t rgb565_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
 
 STATIC void rgb565_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
     uint16_t *b = &((uint16_t*)fb->buf)[x + y * fb->stride];
+    uint32_t col2 = (col & 0xffff) * 0x10001;
+    if (w == fb->stride) {
+        // the rows are contiguous so fill them as one
+        w *= h;
+        h = 1;
+    }
     while (h--) {
-        for (int ww = w; ww; --ww) {
-            *b++ = col;
+        // store pairs of pixels as 32-bit words, once b is word aligned
+        uint16_t *p = b;
+        int ww = w;
+        if (((uintptr_t)p & 2) && ww) {
+            *p++ = col;
+            --ww;
+        }
+        uint32_t *p2 = (uint32_t*)p;
+        for (; ww >= 2; ww -= 2) {
+            *p2++ = col2;
         }
-        b += fb->stride - w;
+        if (ww) {
+            *(uint16_t*)p2 = col;
+        }
+        b += fb->stride;
     }
 }
 
@@ -149,9 +196,18 @@ STATIC uint32_t gs2_hmsb_getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
 }
 
 STATIC void gs2_hmsb_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
-    for (int xx=x; xx < x+w; xx++) {
-        for (int yy=y; yy < y+h; yy++) {
-            gs2_hmsb_setpixel(fb, xx, yy, col);
+    uint8_t col_byte = (col & 0x3) * 0x55;
+    for (int yend = y + h; y < yend; ++y) {
+        // set the pixels up to a byte boundary, then whole bytes, then the rest
+        int xx = x;
+        int ww = w;
+        for (; (xx & 3) && ww; ++xx, --ww) {
+            gs2_hmsb_setpixel(fb, xx, y, col);
+        }
+        memset(&((uint8_t*)fb->buf)[(xx + y * fb->stride) >> 2], col_byte, ww >> 2);
+        xx += ww & ~3;
+        for (ww &= 3; ww; ++xx, --ww) {
+            gs2_hmsb_setpixel(fb, xx, y, col);
         }
     }
 }
@@ -227,13 +283,13 @@ STATIC void gs8_fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int
 }
 
 STATIC mp_framebuf_p_t formats[] = {
-    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect},
-    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect},
-    [FRAMEBUF_GS2_HMSB] = {gs2_hmsb_setpixel, gs2_hmsb_getpixel, gs2_hmsb_fill_rect},
-    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect},
-    [FRAMEBUF_GS8] = {gs8_setpixel, gs8_getpixel, gs8_fill_rect},
-    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
-    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect},
+    [FRAMEBUF_MVLSB] = {mvlsb_setpixel, mvlsb_getpixel, mvlsb_fill_rect, 0},
+    [FRAMEBUF_RGB565] = {rgb565_setpixel, rgb565_getpixel, rgb565_fill_rect, 16},
+    [FRAMEBUF_GS2_HMSB] = {gs2_hmsb_setpixel, gs2_hmsb_getpixel, gs2_hmsb_fill_rect, 2},
+    [FRAMEBUF_GS4_HMSB] = {gs4_hmsb_setpixel, gs4_hmsb_getpixel, gs4_hmsb_fill_rect, 4},
+    [FRAMEBUF_GS8] = {gs8_setpixel, gs8_getpixel, gs8_fill_rect, 8},
+    [FRAMEBUF_MHLSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, 1},
+    [FRAMEBUF_MHMSB] = {mono_horiz_setpixel, mono_horiz_getpixel, mono_horiz_fill_rect, 1},
 };
 
 static inline void setpixel(const mp_obj_framebuf_t *fb, int x, int y, uint32_t col) {
@@ -244,7 +300,38 @@ static inline uint32_t getpixel(const mp_obj_framebuf_t *fb, int x, int y) {
     return formats[fb->format].getpixel(fb, x, y);
 }
 
-STATIC void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
+// address of the byte holding pixel (x, y), for formats with a non-zero row_bits
+static inline uint8_t *row_byte(const mp_obj_framebuf_t *fb, int x, int y) {
+    return &((uint8_t*)fb->buf)[((size_t)x + (size_t)y * fb->stride) * formats[fb->format].row_bits >> 3];
+}
+
+#if MICROPY_PY_FRAMEBUF_DIRTY
+// Grow the dirty rectangle to include the given region, clipped to the framebuffer.
+STATIC void framebuf_mark(mp_obj_framebuf_t *fb, int x, int y, int w, int h) {
+    int xend = MIN(fb->width, x + w);
+    int yend = MIN(fb->height, y + h);
+    x = MAX(x, 0);
+    y = MAX(y, 0);
+    if (x >= xend || y >= yend) {
+        return;
+    }
+    if (fb->dirty_x1 == 0) {
+        fb->dirty_x0 = x;
+        fb->dirty_y0 = y;
+        fb->dirty_x1 = xend;
+        fb->dirty_y1 = yend;
+    } else {
+        fb->dirty_x0 = MIN(fb->dirty_x0, x);
+        fb->dirty_y0 = MIN(fb->dirty_y0, y);
+        fb->dirty_x1 = MAX(fb->dirty_x1, xend);
+        fb->dirty_y1 = MAX(fb->dirty_y1, yend);
+    }
+}
+#else
+#define framebuf_mark(fb, x, y, w, h) (void)0
+#endif
+
+STATIC void fill_rect(mp_obj_framebuf_t *fb, int x, int y, int w, int h, uint32_t col) {
     if (h < 1 || w < 1 || x + w <= 0 || y + h <= 0 || y >= fb->height || x >= fb->width) {
         // No operation needed.
         return;
@@ -257,6 +344,7 @@ STATIC void fill_rect(const mp_obj_framebuf_t *fb, int x, int y, int w, int h, u
     y = MAX(y, 0);
 
     formats[fb->format].fill_rect(fb, x, y, xend - x, yend - y, col);
+    framebuf_mark(fb, x, y, xend - x, yend - y);
 }
 
 STATIC mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -299,6 +387,10 @@ STATIC mp_obj_t framebuf_make_new(const mp_obj_type_t *type, size_t n_args, size
             mp_raise_ValueError("invalid format");
     }
 
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    o->dirty_x1 = 0;
+    #endif
+
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -315,6 +407,7 @@ STATIC mp_obj_t framebuf_fill(mp_obj_t self_in, mp_obj_t col_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t col = mp_obj_get_int(col_in);
     formats[self->format].fill_rect(self, 0, 0, self->width, self->height, col);
+    framebuf_mark(self, 0, 0, self->width, self->height);
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(framebuf_fill_obj, framebuf_fill);
@@ -346,6 +439,7 @@ STATIC mp_obj_t framebuf_pixel(size_t n_args, const mp_obj_t *args) {
         } else {
             // set
             setpixel(self, x, y, mp_obj_get_int(args[3]));
+            framebuf_mark(self, x, y, 1, 1);
         }
     }
     return mp_const_none;
@@ -411,6 +505,8 @@ STATIC mp_obj_t framebuf_line(size_t n_args, const mp_obj_t *args) {
     mp_int_t y2 = mp_obj_get_int(args[4]);
     mp_int_t col = mp_obj_get_int(args[5]);
 
+    framebuf_mark(self, MIN(x1, x2), MIN(y1, y2), MAX(x1, x2) - MIN(x1, x2) + 1, MAX(y1, y2) - MIN(y1, y2) + 1);
+
     mp_int_t dx = x2 - x1;
     mp_int_t sx;
     if (dx > 0) {
@@ -467,6 +563,116 @@ STATIC mp_obj_t framebuf_line(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_line_obj, 6, 6, framebuf_line);
 
+// Copy n rows of len bytes.  If reverse is set the rows are copied from the
+// bottom up, so that a region can be moved down within the same buffer.
+STATIC void copy_rows(uint8_t *dest, size_t dest_stride, const uint8_t *src, size_t src_stride, size_t len, int n, bool reverse) {
+    if (reverse) {
+        dest += (n - 1) * dest_stride;
+        src += (n - 1) * src_stride;
+    }
+    while (n-- > 0) {
+        memmove(dest, src, len);
+        if (reverse) {
+            dest -= dest_stride;
+            src -= src_stride;
+        } else {
+            dest += dest_stride;
+            src += src_stride;
+        }
+    }
+}
+
+// Blit a w x h region one pixel at a time, mapping colours through the palette if given.
+STATIC void blit_pixels(const mp_obj_framebuf_t *dest, const mp_obj_framebuf_t *source, const mp_obj_framebuf_t *palette,
+    int x0, int y0, int x1, int y1, int w, int h, uint32_t key) {
+    getpixel_t get = formats[source->format].getpixel;
+    setpixel_t set = formats[dest->format].setpixel;
+    // when moving a region within a buffer, go in the direction that reads
+    // each pixel before it is overwritten
+    int dy = 1;
+    int dx = 1;
+    if (source == dest && y0 > y1) {
+        y0 += h - 1;
+        y1 += h - 1;
+        dy = -1;
+    } else if (source == dest && y0 == y1 && x0 > x1) {
+        x0 += w - 1;
+        x1 += w - 1;
+        dx = -1;
+    }
+    for (; h > 0; --h, y0 += dy, y1 += dy) {
+        for (int i = 0; i < w; ++i) {
+            uint32_t col = get(source, x1 + i * dx, y1);
+            if (palette != NULL && col < palette->width) {
+                col = getpixel(palette, col, 0);
+            }
+            if (col != key) {
+                set(dest, x0 + i * dx, y0, col);
+            }
+        }
+    }
+}
+
+STATIC void blit_rgb565_key(const mp_obj_framebuf_t *dest, const mp_obj_framebuf_t *source,
+    int x0, int y0, int x1, int y1, int w, int h, uint32_t key) {
+    // within one buffer, go in the same direction as blit_pixels
+    int dy = 1;
+    int dx = 1;
+    if (source == dest && y0 > y1) {
+        y0 += h - 1;
+        y1 += h - 1;
+        dy = -1;
+    } else if (source == dest && y0 == y1 && x0 > x1) {
+        x0 += w - 1;
+        x1 += w - 1;
+        dx = -1;
+    }
+    for (; h > 0; --h, y0 += dy, y1 += dy) {
+        uint16_t *d = &((uint16_t*)dest->buf)[x0 + y0 * dest->stride];
+        const uint16_t *s = &((uint16_t*)source->buf)[x1 + y1 * source->stride];
+        for (int ww = w; ww; --ww, d += dx, s += dx) {
+            uint32_t col = *s;
+            if (col != key) {
+                *d = col;
+            }
+        }
+    }
+}
+
+// Blit a monochrome source to an RGB565 destination, drawing its 0 and 1
+// pixels with the colours pal[0] and pal[1].
+STATIC void blit_mono_rgb565(const mp_obj_framebuf_t *dest, const mp_obj_framebuf_t *source,
+    int x0, int y0, int x1, int y1, int w, int h, const uint32_t *pal, uint32_t key) {
+    for (; h > 0; --h, ++y0, ++y1) {
+        uint16_t *d = &((uint16_t*)dest->buf)[x0 + y0 * dest->stride];
+        if (source->format == FRAMEBUF_MVLSB) {
+            const uint8_t *s = &((uint8_t*)source->buf)[(y1 >> 3) * source->stride + x1];
+            int offset = y1 & 0x07;
+            for (int ww = w; ww; --ww, ++d) {
+                uint32_t col = pal[(*s++ >> offset) & 0x01];
+                if (col != key) {
+                    *d = col;
+                }
+            }
+        } else {
+            size_t index = x1 + y1 * source->stride;
+            const uint8_t *s = &((uint8_t*)source->buf)[index >> 3];
+            int reverse = source->format == FRAMEBUF_MHMSB;
+            int bit = index & 0x07;
+            for (int ww = w; ww; --ww, ++d) {
+                uint32_t col = pal[(*s >> (reverse ? bit : 7 - bit)) & 0x01];
+                if (col != key) {
+                    *d = col;
+                }
+                if (++bit == 8) {
+                    bit = 0;
+                    ++s;
+                }
+            }
+        }
+    }
+}
+
 STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(args[0]);
     mp_obj_framebuf_t *source = MP_OBJ_TO_PTR(args[1]);
@@ -476,6 +682,10 @@ STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     if (n_args > 4) {
         key = mp_obj_get_int(args[4]);
     }
+    mp_obj_framebuf_t *palette = NULL;
+    if (n_args > 5 && args[5] != mp_const_none) {
+        palette = MP_OBJ_TO_PTR(args[5]);
+    }
 
     if (
         (x >= self->width) ||
@@ -494,26 +704,76 @@ STATIC mp_obj_t framebuf_blit(size_t n_args, const mp_obj_t *args) {
     int y1 = MAX(0, -y);
     int x0end = MIN(self->width, x + source->width);
     int y0end = MIN(self->height, y + source->height);
-
-    for (; y0 < y0end; ++y0) {
-        int cx1 = x1;
-        for (int cx0 = x0; cx0 < x0end; ++cx0) {
-            uint32_t col = getpixel(source, cx1, y1);
-            if (col != (uint32_t)key) {
-                setpixel(self, cx0, y0, col);
+    int w = x0end - x0;
+    int h = y0end - y0;
+
+    framebuf_mark(self, x0, y0, w, h);
+
+    if (palette == NULL && key == -1 && source->format == self->format) {
+        // Plain copy: move whole bytes, leaving any pixels at the ends of the
+        // rows (or the bottom rows for MVLSB) which only fill part of a byte.
+        // Within one buffer this is only done if there are no such pixels,
+        // as the rows moved could overwrite them before they are copied.
+        bool reverse = source == self && y0 > y1;
+        int bits = formats[self->format].row_bits;
+        if (bits) {
+            int byte_mask = bits < 8 ? 8 / bits - 1 : 0;
+            if (((x0 | x1) & byte_mask) == 0 && !(source == self && (w & byte_mask))) {
+                int n = w & ~byte_mask;
+                copy_rows(row_byte(self, x0, y0), self->stride * bits >> 3,
+                    row_byte(source, x1, y1), source->stride * bits >> 3, n * bits >> 3, h, reverse);
+                x0 += n;
+                x1 += n;
+                w -= n;
             }
-            ++cx1;
+        } else if (((y0 | y1) & 0x07) == 0 && !(source == self && (h & 0x07))) {
+            int n = h & ~0x07;
+            copy_rows(&((uint8_t*)self->buf)[(y0 >> 3) * self->stride + x0], self->stride,
+                &((uint8_t*)source->buf)[(y1 >> 3) * source->stride + x1], source->stride, w, n >> 3, reverse);
+            y0 += n;
+            y1 += n;
+            h -= n;
         }
-        ++y1;
+    } else if (palette == NULL && self->format == FRAMEBUF_RGB565 && source->format == FRAMEBUF_RGB565) {
+        blit_rgb565_key(self, source, x0, y0, x1, y1, w, h, key);
+        return mp_const_none;
+    } else if (palette != NULL && palette->width >= 2 && self->format == FRAMEBUF_RGB565
+        && (source->format == FRAMEBUF_MVLSB || source->format == FRAMEBUF_MHLSB || source->format == FRAMEBUF_MHMSB)) {
+        uint32_t pal[2] = {getpixel(palette, 0, 0), getpixel(palette, 1, 0)};
+        blit_mono_rgb565(self, source, x0, y0, x1, y1, w, h, pal, key);
+        return mp_const_none;
     }
+
+    blit_pixels(self, source, palette, x0, y0, x1, y1, w, h, key);
     return mp_const_none;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 5, framebuf_blit);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_blit_obj, 4, 6, framebuf_blit);
 
 STATIC mp_obj_t framebuf_scroll(mp_obj_t self_in, mp_obj_t xstep_in, mp_obj_t ystep_in) {
     mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
     mp_int_t xstep = mp_obj_get_int(xstep_in);
     mp_int_t ystep = mp_obj_get_int(ystep_in);
+    if (xstep <= -self->width || xstep >= self->width || ystep <= -self->height || ystep >= self->height) {
+        // Everything is scrolled out, no-op.
+        return mp_const_none;
+    }
+
+    int w = self->width - (xstep < 0 ? -xstep : xstep);
+    int h = self->height - (ystep < 0 ? -ystep : ystep);
+    framebuf_mark(self, MAX(xstep, 0), MAX(ystep, 0), w, h);
+
+    int bits = formats[self->format].row_bits;
+    if (bits) {
+        int byte_mask = bits < 8 ? 8 / bits - 1 : 0;
+        if (((xstep | w) & byte_mask) == 0) {
+            // Whole bytes are moved, so scroll a row at a time.
+            size_t stride = self->stride * bits >> 3;
+            copy_rows(row_byte(self, MAX(xstep, 0), MAX(ystep, 0)), stride,
+                row_byte(self, MAX(-xstep, 0), MAX(-ystep, 0)), stride, w * bits >> 3, h, ystep > 0);
+            return mp_const_none;
+        }
+    }
+
     int sx, y, xend, yend, dx, dy;
     if (xstep < 0) {
         sx = 0;
@@ -553,6 +813,8 @@ STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
         col = mp_obj_get_int(args[4]);
     }
 
+    framebuf_mark(self, x0, y0, 8 * (int)strlen(str), 8);
+
     // loop over chars
     for (; *str; ++str) {
         // get char and make sure its in range of font
@@ -580,6 +842,24 @@ STATIC mp_obj_t framebuf_text(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(framebuf_text_obj, 4, 5, framebuf_text);
 
+#if MICROPY_PY_FRAMEBUF_DIRTY
+STATIC mp_obj_t framebuf_dirty(mp_obj_t self_in) {
+    mp_obj_framebuf_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->dirty_x1 == 0) {
+        return mp_const_none;
+    }
+    mp_obj_t tuple[4] = {
+        MP_OBJ_NEW_SMALL_INT(self->dirty_x0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_y0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_x1 - self->dirty_x0),
+        MP_OBJ_NEW_SMALL_INT(self->dirty_y1 - self->dirty_y0),
+    };
+    self->dirty_x1 = 0;
+    return mp_obj_new_tuple(4, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(framebuf_dirty_obj, framebuf_dirty);
+#endif
+
 STATIC const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_fill), MP_ROM_PTR(&framebuf_fill_obj) },
     { MP_ROM_QSTR(MP_QSTR_fill_rect), MP_ROM_PTR(&framebuf_fill_rect_obj) },
@@ -591,6 +871,9 @@ STATIC const mp_rom_map_elem_t framebuf_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_blit), MP_ROM_PTR(&framebuf_blit_obj) },
     { MP_ROM_QSTR(MP_QSTR_scroll), MP_ROM_PTR(&framebuf_scroll_obj) },
     { MP_ROM_QSTR(MP_QSTR_text), MP_ROM_PTR(&framebuf_text_obj) },
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    { MP_ROM_QSTR(MP_QSTR_dirty), MP_ROM_PTR(&framebuf_dirty_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(framebuf_locals_dict, framebuf_locals_dict_table);
 
@@ -619,6 +902,9 @@ STATIC mp_obj_t legacy_framebuffer1(size_t n_args, const mp_obj_t *args) {
     } else {
         o->stride = o->width;
     }
+    #if MICROPY_PY_FRAMEBUF_DIRTY
+    o->dirty_x1 = 0;
+    #endif
 
     return MP_OBJ_FROM_PTR(o);
 }
@@ -32,6 +32,60 @@
 #include "py/binary.h"
 #include "extmod/modubinascii.h"
 
+STATIC const char hex_digits[16] = "0123456789abcdef";
+
+STATIC const char base64_enc_table[64] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Sextet value of each base64 alphabet character, 0xff for anything else
+// (including the pad character)
+STATIC const byte base64_dec_table[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x3e, 0xff, 0xff, 0xff, 0x3f,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+    0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+};
+
+// Get a writable buffer for an _into function, checking it holds len bytes
+STATIC byte *binascii_get_out_buf(mp_obj_t buf_in, size_t len) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len < len) {
+        mp_raise_ValueError("buffer too small");
+    }
+    return bufinfo.buf;
+}
+
+STATIC size_t binascii_hexlify_len(size_t len, const char *sep) {
+    if (len == 0) {
+        return 0;
+    }
+    return len * 2 + (sep != NULL ? len - 1 : 0);
+}
+
+STATIC void binascii_hexlify(const byte *in, size_t len, const char *sep, byte *out) {
+    for (size_t i = len; i--;) {
+        byte b = *in++;
+        *out++ = hex_digits[b >> 4];
+        *out++ = hex_digits[b & 0xf];
+        if (sep != NULL && i != 0) {
+            *out++ = *sep;
+        }
+    }
+}
+
 mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
     // Second argument is for an extension to allow a separator to be used
     // between values.
@@ -45,34 +99,26 @@ mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
         return mp_const_empty_bytes;
     }
 
-    vstr_t vstr;
-    size_t out_len = bufinfo.len * 2;
     if (n_args > 1) {
         // 1-char separator between hex numbers
-        out_len += bufinfo.len - 1;
         sep = mp_obj_str_get_str(args[1]);
     }
-    vstr_init_len(&vstr, out_len);
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    for (mp_uint_t i = bufinfo.len; i--;) {
-        byte d = (*in >> 4);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        d = (*in++ & 0xf);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        if (sep != NULL && i != 0) {
-            *out++ = *sep;
-        }
-    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, binascii_hexlify_len(bufinfo.len, sep));
+    binascii_hexlify(bufinfo.buf, bufinfo.len, sep, (byte*)vstr.buf);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_obj, 1, 2, mod_binascii_hexlify);
 
+mp_obj_t mod_binascii_hexlify_into(mp_obj_t data, mp_obj_t buf) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    size_t len = binascii_hexlify_len(bufinfo.len, NULL);
+    binascii_hexlify(bufinfo.buf, bufinfo.len, NULL, binascii_get_out_buf(buf, len));
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_hexlify_into_obj, mod_binascii_hexlify_into);
+
 mp_obj_t mod_binascii_unhexlify(mp_obj_t data) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
@@ -102,38 +148,35 @@ mp_obj_t mod_binascii_unhexlify(mp_obj_t data) {
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_unhexlify_obj, mod_binascii_unhexlify);
 
-// If ch is a character in the base64 alphabet, and is not a pad character, then
-// the corresponding integer between 0 and 63, inclusively, is returned.
-// Otherwise, -1 is returned.
-static int mod_binascii_sextet(byte ch) {
-    if (ch >= 'A' && ch <= 'Z') {
-        return ch - 'A';
-    } else if (ch >= 'a' && ch <= 'z') {
-        return ch - 'a' + 26;
-    } else if (ch >= '0' && ch <= '9') {
-        return ch - '0' + 52;
-    } else if (ch == '+') {
-        return 62;
-    } else if (ch == '/') {
-        return 63;
-    } else {
-        return -1;
-    }
-}
-
-mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
-    byte *in = bufinfo.buf;
-
-    vstr_t vstr;
-    vstr_init(&vstr, (bufinfo.len / 4) * 3 + 1); // Potentially over-allocate
-    byte *out = (byte *)vstr.buf;
-
+// Decode base64 data into out, which holds out_max bytes, returning the
+// number of bytes written.  Each sextet yields 6 bits so at most len * 3 / 4
+// bytes are written.
+STATIC size_t binascii_a2b_base64(const byte *in, size_t len, byte *out, size_t out_max) {
+    size_t n = 0;
     uint shift = 0;
     int nbits = 0; // Number of meaningful bits in shift
     bool hadpad = false; // Had a pad character since last valid character
-    for (size_t i = 0; i < bufinfo.len; i++) {
+    for (size_t i = 0; i < len; i++) {
+        if (nbits == 0 && len - i >= 4) {
+            // Fast path for a whole group of 4 valid characters
+            uint a = base64_dec_table[in[i]];
+            uint b = base64_dec_table[in[i + 1]];
+            uint c = base64_dec_table[in[i + 2]];
+            uint d = base64_dec_table[in[i + 3]];
+            if (((a | b | c | d) & 0xc0) == 0) {
+                if (out_max - n < 3) {
+                    mp_raise_ValueError("buffer too small");
+                }
+                uint v = a << 18 | b << 12 | c << 6 | d;
+                out[n++] = v >> 16;
+                out[n++] = v >> 8;
+                out[n++] = v;
+                hadpad = false;
+                i += 3;
+                continue;
+            }
+        }
+
         if (in[i] == '=') {
             if ((nbits == 2) || ((nbits == 4) && hadpad)) {
                 nbits = 0;
@@ -142,8 +185,8 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
             hadpad = true;
         }
 
-        int sextet = mod_binascii_sextet(in[i]);
-        if (sextet == -1) {
+        uint sextet = base64_dec_table[in[i]];
+        if (sextet == 0xff) {
             continue;
         }
         hadpad = false;
@@ -151,8 +194,11 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
         nbits += 6;
 
         if (nbits >= 8) {
+            if (n == out_max) {
+                mp_raise_ValueError("buffer too small");
+            }
             nbits -= 8;
-            out[vstr.len++] = (shift >> nbits) & 0xFF;
+            out[n++] = (shift >> nbits) & 0xFF;
         }
     }
 
@@ -160,63 +206,77 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
         mp_raise_ValueError("incorrect padding");
     }
 
+    return n;
+}
+
+mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+
+    vstr_t vstr;
+    size_t max_len = bufinfo.len / 4 * 3 + (bufinfo.len % 4) * 3 / 4;
+    vstr_init(&vstr, max_len + 1); // +1 for the NUL added by mp_obj_new_str_from_vstr
+    vstr.len = binascii_a2b_base64(bufinfo.buf, bufinfo.len, (byte*)vstr.buf, max_len);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj, mod_binascii_a2b_base64);
 
-mp_obj_t mod_binascii_b2a_base64(mp_obj_t data) {
+mp_obj_t mod_binascii_a2b_base64_into(mp_obj_t data, mp_obj_t buf) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    mp_buffer_info_t outinfo;
+    mp_get_buffer_raise(buf, &outinfo, MP_BUFFER_WRITE);
+    size_t len = binascii_a2b_base64(bufinfo.buf, bufinfo.len, outinfo.buf, outinfo.len);
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_a2b_base64_into_obj, mod_binascii_a2b_base64_into);
 
-    vstr_t vstr;
-    vstr_init_len(&vstr, ((bufinfo.len != 0) ? (((bufinfo.len - 1) / 3) + 1) * 4 : 0) + 1);
+// Length of the base64 encoding of len bytes, including the trailing newline
+STATIC size_t binascii_b2a_base64_len(size_t len) {
+    return (len + 2) / 3 * 4 + 1;
+}
 
-    // First pass, we convert input buffer to numeric base 64 values
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    mp_uint_t i;
-    for (i = bufinfo.len; i >= 3; i -= 3) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-        *out++ = (in[1] & 0x0F) << 2 | (in[2] & 0xC0) >> 6;
-        *out++ = in[2] & 0x3F;
+STATIC void binascii_b2a_base64(const byte *in, size_t len, byte *out) {
+    for (; len >= 3; len -= 3) {
+        uint v = in[0] << 16 | in[1] << 8 | in[2];
+        out[0] = base64_enc_table[v >> 18];
+        out[1] = base64_enc_table[(v >> 12) & 0x3f];
+        out[2] = base64_enc_table[(v >> 6) & 0x3f];
+        out[3] = base64_enc_table[v & 0x3f];
         in += 3;
+        out += 4;
     }
-    if (i != 0) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        if (i == 2) {
-            *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-            *out++ = (in[1] & 0x0F) << 2;
-        }
-        else {
-            *out++ = (in[0] & 0x03) << 4;
-            *out++ = 64;
-        }
-        *out = 64;
-    }
-
-    // Second pass, we convert number base 64 values to actual base64 ascii encoding
-    out = (byte*)vstr.buf;
-    for (mp_uint_t j = vstr.len - 1; j--;) {
-        if (*out < 26) {
-            *out += 'A';
-        } else if (*out < 52) {
-            *out += 'a' - 26;
-        } else if (*out < 62) {
-            *out += '0' - 52;
-        } else if (*out == 62) {
-            *out ='+';
-        } else if (*out == 63) {
-            *out = '/';
-        } else {
-            *out = '=';
-        }
-        out++;
+    if (len != 0) {
+        uint v = in[0] << 16 | (len == 2 ? in[1] << 8 : 0);
+        out[0] = base64_enc_table[v >> 18];
+        out[1] = base64_enc_table[(v >> 12) & 0x3f];
+        out[2] = len == 2 ? base64_enc_table[(v >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        out += 4;
     }
     *out = '\n';
+}
+
+mp_obj_t mod_binascii_b2a_base64(mp_obj_t data) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, binascii_b2a_base64_len(bufinfo.len));
+    binascii_b2a_base64(bufinfo.buf, bufinfo.len, (byte*)vstr.buf);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_b2a_base64_obj, mod_binascii_b2a_base64);
 
+mp_obj_t mod_binascii_b2a_base64_into(mp_obj_t data, mp_obj_t buf) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    size_t len = binascii_b2a_base64_len(bufinfo.len);
+    binascii_b2a_base64(bufinfo.buf, bufinfo.len, binascii_get_out_buf(buf, len));
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_b2a_base64_into_obj, mod_binascii_b2a_base64_into);
+
 #if MICROPY_PY_UBINASCII_CRC32
 #include "uzlib/tinf.h"
 
@@ -238,6 +298,9 @@ STATIC const mp_rom_map_elem_t mp_module_binascii_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_unhexlify), MP_ROM_PTR(&mod_binascii_unhexlify_obj) },
     { MP_ROM_QSTR(MP_QSTR_a2b_base64), MP_ROM_PTR(&mod_binascii_a2b_base64_obj) },
     { MP_ROM_QSTR(MP_QSTR_b2a_base64), MP_ROM_PTR(&mod_binascii_b2a_base64_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hexlify_into), MP_ROM_PTR(&mod_binascii_hexlify_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_a2b_base64_into), MP_ROM_PTR(&mod_binascii_a2b_base64_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_b2a_base64_into), MP_ROM_PTR(&mod_binascii_b2a_base64_into_obj) },
     #if MICROPY_PY_UBINASCII_CRC32
     { MP_ROM_QSTR(MP_QSTR_crc32), MP_ROM_PTR(&mod_binascii_crc32_obj) },
     #endif
@@ -150,6 +150,82 @@ STATIC const mp_obj_type_t uhashlib_sha256_type = {
     .make_new = uhashlib_sha256_make_new,
     .locals_dict = (void*)&uhashlib_sha256_locals_dict,
 };
+
+// One-shot functions, which keep the hash state on the C stack
+
+#if MICROPY_SSL_MBEDTLS
+typedef mbedtls_sha256_context uhashlib_sha256_ctx_t;
+STATIC void uhashlib_sha256_begin(uhashlib_sha256_ctx_t *ctx) {
+    mbedtls_sha256_init(ctx);
+    mbedtls_sha256_starts_ret(ctx, 0);
+}
+#define uhashlib_sha256_feed mbedtls_sha256_update_ret
+#define uhashlib_sha256_end mbedtls_sha256_finish_ret
+#else
+typedef CRYAL_SHA256_CTX uhashlib_sha256_ctx_t;
+#define uhashlib_sha256_begin sha256_init
+#define uhashlib_sha256_feed sha256_update
+#define uhashlib_sha256_end sha256_final
+#endif
+
+STATIC mp_obj_t uhashlib_sha256_into(mp_obj_t data_in, mp_obj_t out_in) {
+    mp_buffer_info_t data, out;
+    mp_get_buffer_raise(data_in, &data, MP_BUFFER_READ);
+    mp_get_buffer_raise(out_in, &out, MP_BUFFER_WRITE);
+    if (out.len < 32) {
+        mp_raise_ValueError("buffer too small");
+    }
+    uhashlib_sha256_ctx_t ctx;
+    uhashlib_sha256_begin(&ctx);
+    uhashlib_sha256_feed(&ctx, data.buf, data.len);
+    uhashlib_sha256_end(&ctx, out.buf);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uhashlib_sha256_into_obj, uhashlib_sha256_into);
+
+// HMAC-SHA256 as specified in RFC 2104
+STATIC mp_obj_t uhashlib_hmac_sha256(mp_obj_t key_in, mp_obj_t msg_in) {
+    mp_buffer_info_t key, msg;
+    mp_get_buffer_raise(key_in, &key, MP_BUFFER_READ);
+    mp_get_buffer_raise(msg_in, &msg, MP_BUFFER_READ);
+    uhashlib_sha256_ctx_t ctx;
+    byte digest[32];
+    byte pad[64];
+
+    // keys longer than a block are replaced by their hash
+    const byte *key_buf = key.buf;
+    size_t key_len = key.len;
+    if (key_len > sizeof(pad)) {
+        uhashlib_sha256_begin(&ctx);
+        uhashlib_sha256_feed(&ctx, key_buf, key_len);
+        uhashlib_sha256_end(&ctx, digest);
+        key_buf = digest;
+        key_len = sizeof(digest);
+    }
+
+    // inner hash
+    memset(pad, 0x36, sizeof(pad));
+    for (size_t i = 0; i < key_len; ++i) {
+        pad[i] ^= key_buf[i];
+    }
+    uhashlib_sha256_begin(&ctx);
+    uhashlib_sha256_feed(&ctx, pad, sizeof(pad));
+    uhashlib_sha256_feed(&ctx, msg.buf, msg.len);
+    uhashlib_sha256_end(&ctx, digest);
+
+    // outer hash
+    for (size_t i = 0; i < sizeof(pad); ++i) {
+        pad[i] ^= 0x36 ^ 0x5c;
+    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, sizeof(digest));
+    uhashlib_sha256_begin(&ctx);
+    uhashlib_sha256_feed(&ctx, pad, sizeof(pad));
+    uhashlib_sha256_feed(&ctx, digest, sizeof(digest));
+    uhashlib_sha256_end(&ctx, (byte*)vstr.buf);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(uhashlib_hmac_sha256_obj, uhashlib_hmac_sha256);
 #endif
 
 #if MICROPY_PY_UHASHLIB_SHA1
@@ -330,6 +406,8 @@ STATIC const mp_rom_map_elem_t mp_module_uhashlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uhashlib) },
     #if MICROPY_PY_UHASHLIB_SHA256
     { MP_ROM_QSTR(MP_QSTR_sha256), MP_ROM_PTR(&uhashlib_sha256_type) },
+    { MP_ROM_QSTR(MP_QSTR_sha256_into), MP_ROM_PTR(&uhashlib_sha256_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_hmac_sha256), MP_ROM_PTR(&uhashlib_hmac_sha256_obj) },
     #endif
     #if MICROPY_PY_UHASHLIB_SHA1
     { MP_ROM_QSTR(MP_QSTR_sha1), MP_ROM_PTR(&uhashlib_sha1_type) },
@@ -25,33 +25,292 @@
  */
 
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 
 #include "py/objlist.h"
-#include "py/objstringio.h"
+#include "py/objstr.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
+#include "py/stackctrl.h"
 #include "py/stream.h"
 
 #if MICROPY_PY_UJSON
 
-STATIC mp_obj_t mod_ujson_dump(mp_obj_t obj, mp_obj_t stream) {
-    mp_get_stream_raise(stream, MP_STREAM_OP_WRITE);
-    mp_print_t print = {MP_OBJ_TO_PTR(stream), mp_stream_write_adaptor};
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
+// The functions below implement the JSON encoder.  The output is collected in
+// a vstr, and for dump it is written to the stream each time the vstr holds
+// MICROPY_PY_UJSON_BUF_SIZE bytes.  None, bools, small ints, floats, strs,
+// lists, tuples and dicts are encoded directly, and any other object is
+// printed by its type's print method.
+
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+#define UJSON_FLOAT_FAST_MAX (1e15)
+#elif MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_FLOAT
+#define UJSON_FLOAT_FAST_MAX (1e6)
+#endif
+
+typedef struct _ujson_enc_t {
+    vstr_t vstr;
+    mp_print_t print; // prints to vstr
+    mp_obj_t stream; // MP_OBJ_NULL for dumps
+    const char *item_sep;
+    const char *key_sep;
+    const char *indent; // NULL for indent_len spaces
+    size_t item_sep_len;
+    size_t key_sep_len;
+    size_t indent_len;
+    bool indented;
+    size_t depth;
+} ujson_enc_t;
+
+STATIC void ujson_enc_init(ujson_enc_t *e, mp_obj_t stream, size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_separators, ARG_indent };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_separators, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+        { MP_QSTR_indent, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_rom_obj = MP_ROM_PTR(&mp_const_none_obj)} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    e->stream = stream;
+    e->indented = args[ARG_indent].u_obj != mp_const_none;
+    e->indent = NULL;
+    e->indent_len = 0;
+    if (mp_obj_is_str(args[ARG_indent].u_obj)) {
+        e->indent = mp_obj_str_get_data(args[ARG_indent].u_obj, &e->indent_len);
+    } else if (e->indented) {
+        mp_int_t n = mp_obj_get_int(args[ARG_indent].u_obj);
+        e->indent_len = n < 0 ? 0 : n;
+    }
+    if (args[ARG_separators].u_obj == mp_const_none) {
+        // these are the defaults used by CPython
+        e->item_sep = e->indented ? "," : ", ";
+        e->item_sep_len = e->indented ? 1 : 2;
+        e->key_sep = ": ";
+        e->key_sep_len = 2;
+    } else {
+        mp_obj_t *seps;
+        mp_obj_get_array_fixed_n(args[ARG_separators].u_obj, 2, &seps);
+        e->item_sep = mp_obj_str_get_data(seps[0], &e->item_sep_len);
+        e->key_sep = mp_obj_str_get_data(seps[1], &e->key_sep_len);
+    }
+    e->depth = 0;
+    vstr_init_print(&e->vstr, MICROPY_PY_UJSON_BUF_SIZE + 16, &e->print);
+}
+
+STATIC void ujson_enc_flush(ujson_enc_t *e) {
+    mp_stream_write(e->stream, e->vstr.buf, e->vstr.len, MP_STREAM_RW_WRITE);
+    vstr_reset(&e->vstr);
+}
+
+STATIC void ujson_enc_newline(ujson_enc_t *e) {
+    vstr_add_byte(&e->vstr, '\n');
+    if (e->indent == NULL) {
+        size_t n = e->depth * e->indent_len;
+        memset(vstr_add_len(&e->vstr, n), ' ', n);
+    } else {
+        for (size_t i = 0; i < e->depth; ++i) {
+            vstr_add_strn(&e->vstr, e->indent, e->indent_len);
+        }
+    }
+}
+
+// Writes the digits of val, with a decimal point before the last n_frac of
+// them if n_frac is not negative.
+STATIC void ujson_enc_digits(ujson_enc_t *e, bool neg, mp_uint_t val, int n_frac) {
+    char buf[sizeof(mp_uint_t) * 3 + 4];
+    char *p = buf + sizeof(buf);
+    if (n_frac == 0) {
+        *--p = '0';
+    }
+    for (; n_frac > 0; --n_frac) {
+        *--p = '0' + val % 10;
+        val /= 10;
+    }
+    if (n_frac == 0) {
+        *--p = '.';
+    }
+    do {
+        *--p = '0' + val % 10;
+        val /= 10;
+    } while (val != 0);
+    if (neg) {
+        *--p = '-';
+    }
+    vstr_add_strn(&e->vstr, p, buf + sizeof(buf) - p);
+}
+
+#if MICROPY_PY_BUILTINS_FLOAT
+// Writes f in the form with the fewest decimal places (up to 6) that converts
+// back to f, which is also how CPython writes it.  Returns false if f needs
+// more digits than that or an exponent.
+STATIC bool ujson_enc_float(ujson_enc_t *e, mp_float_t f) {
+    static const mp_float_t pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+    mp_float_t a = f < 0 ? -f : f;
+    if (!(a >= (mp_float_t)1e-4 && a < (mp_float_t)UJSON_FLOAT_FAST_MAX)) {
+        return false;
+    }
+    for (int k = 0; k < (int)MP_ARRAY_SIZE(pow10); ++k) {
+        mp_float_t m = MICROPY_FLOAT_C_FUN(floor)(a * pow10[k] + (mp_float_t)0.5);
+        if (m >= (mp_float_t)UJSON_FLOAT_FAST_MAX || m >= (mp_float_t)MP_SMALL_INT_MAX) {
+            return false;
+        }
+        if (m / pow10[k] == a) {
+            ujson_enc_digits(e, f < 0, (mp_uint_t)m, k);
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+
+STATIC void ujson_enc_str(ujson_enc_t *e, const byte *str, size_t len) {
+    // for JSON spec, see http://www.ietf.org/rfc/rfc4627.txt
+    vstr_add_byte(&e->vstr, '"');
+    for (const byte *top = str + len; str < top;) {
+        // copy the run of chars that don't need escaping, including utf-8 chars
+        const byte *run = str;
+        while (str < top && *str >= 32 && *str != '"' && *str != '\\') {
+            ++str;
+        }
+        vstr_add_strn(&e->vstr, (const char*)run, str - run);
+        if (str == top) {
+            break;
+        }
+        byte c = *str++;
+        char *esc = vstr_add_len(&e->vstr, 2);
+        esc[0] = '\\';
+        if (c == '"' || c == '\\') {
+            esc[1] = c;
+        } else if (c == '\n') {
+            esc[1] = 'n';
+        } else if (c == '\r') {
+            esc[1] = 'r';
+        } else if (c == '\t') {
+            esc[1] = 't';
+        } else {
+            // other control chars
+            esc[1] = 'u';
+            esc = vstr_add_len(&e->vstr, 4);
+            esc[0] = '0';
+            esc[1] = '0';
+            esc[2] = "0123456789abcdef"[c >> 4];
+            esc[3] = "0123456789abcdef"[c & 15];
+        }
+    }
+    vstr_add_byte(&e->vstr, '"');
+}
+
+STATIC void ujson_enc_obj(ujson_enc_t *e, mp_obj_t obj) {
+    MP_STACK_CHECK();
+    if (obj == mp_const_none) {
+        vstr_add_strn(&e->vstr, "null", 4);
+    } else if (obj == mp_const_false) {
+        vstr_add_strn(&e->vstr, "false", 5);
+    } else if (obj == mp_const_true) {
+        vstr_add_strn(&e->vstr, "true", 4);
+    } else if (mp_obj_is_small_int(obj)) {
+        mp_int_t val = MP_OBJ_SMALL_INT_VALUE(obj);
+        ujson_enc_digits(e, val < 0, val < 0 ? -(mp_uint_t)val : (mp_uint_t)val, -1);
+    } else if (mp_obj_is_str_or_bytes(obj)) {
+        GET_STR_DATA_LEN(obj, str, len);
+        ujson_enc_str(e, str, len);
+    #if MICROPY_PY_BUILTINS_FLOAT
+    } else if (mp_obj_is_float(obj) && ujson_enc_float(e, mp_obj_float_get(obj))) {
+        // written by ujson_enc_float
+    #endif
+    } else if (mp_obj_is_type(obj, &mp_type_list) || mp_obj_is_type(obj, &mp_type_tuple)) {
+        vstr_add_byte(&e->vstr, '[');
+        e->depth += 1;
+        // the list is fetched again for each item in case it is changed by a print method
+        size_t len;
+        mp_obj_t *items;
+        for (size_t i = 0; mp_obj_get_array(obj, &len, &items), i < len; ++i) {
+            if (i != 0) {
+                vstr_add_strn(&e->vstr, e->item_sep, e->item_sep_len);
+            }
+            if (e->indented) {
+                ujson_enc_newline(e);
+            }
+            ujson_enc_obj(e, items[i]);
+        }
+        e->depth -= 1;
+        if (e->indented && len != 0) {
+            ujson_enc_newline(e);
+        }
+        vstr_add_byte(&e->vstr, ']');
+    } else if (mp_obj_is_type(obj, &mp_type_dict)
+        #if MICROPY_PY_COLLECTIONS_ORDEREDDICT
+        || mp_obj_is_type(obj, &mp_type_ordereddict)
+        #endif
+        ) {
+        mp_map_t *map = mp_obj_dict_get_map(obj);
+        bool first = true;
+        vstr_add_byte(&e->vstr, '{');
+        e->depth += 1;
+        for (size_t i = 0; i < map->alloc; ++i) {
+            if (!mp_map_slot_is_filled(map, i)) {
+                continue;
+            }
+            mp_map_elem_t *elem = &map->table[i];
+            if (!first) {
+                vstr_add_strn(&e->vstr, e->item_sep, e->item_sep_len);
+            }
+            first = false;
+            if (e->indented) {
+                ujson_enc_newline(e);
+            }
+            if (mp_obj_is_str_or_bytes(elem->key)) {
+                ujson_enc_obj(e, elem->key);
+            } else {
+                // JSON keys must be strings
+                vstr_add_byte(&e->vstr, '"');
+                ujson_enc_obj(e, elem->key);
+                vstr_add_byte(&e->vstr, '"');
+            }
+            vstr_add_strn(&e->vstr, e->key_sep, e->key_sep_len);
+            ujson_enc_obj(e, elem->value);
+        }
+        e->depth -= 1;
+        if (e->indented && !first) {
+            ujson_enc_newline(e);
+        }
+        vstr_add_byte(&e->vstr, '}');
+    } else {
+        mp_obj_print_helper(&e->print, obj, PRINT_JSON);
+    }
+    if (e->stream != MP_OBJ_NULL) {
+        if (e->vstr.len >= MICROPY_PY_UJSON_BUF_SIZE) {
+            ujson_enc_flush(e);
+        }
+    } else if (e->vstr.alloc - e->vstr.len < MICROPY_PY_UJSON_BUF_SIZE) {
+        // double the size of the output for dumps, rather than growing it a
+        // few bytes at a time
+        vstr_hint_size(&e->vstr, e->vstr.len);
+    }
+}
+
+STATIC mp_obj_t mod_ujson_dump(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    mp_get_stream_raise(pos_args[1], MP_STREAM_OP_WRITE);
+    ujson_enc_t e;
+    ujson_enc_init(&e, pos_args[1], n_args - 2, pos_args + 2, kw_args);
+    ujson_enc_obj(&e, pos_args[0]);
+    ujson_enc_flush(&e);
+    vstr_clear(&e.vstr);
     return mp_const_none;
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_ujson_dump_obj, mod_ujson_dump);
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_ujson_dump_obj, 2, mod_ujson_dump);
 
-STATIC mp_obj_t mod_ujson_dumps(mp_obj_t obj) {
-    vstr_t vstr;
-    mp_print_t print;
-    vstr_init_print(&vstr, 8, &print);
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
-    return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
+STATIC mp_obj_t mod_ujson_dumps(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    ujson_enc_t e;
+    ujson_enc_init(&e, MP_OBJ_NULL, n_args - 1, pos_args + 1, kw_args);
+    ujson_enc_obj(&e, pos_args[0]);
+    return mp_obj_new_str_from_vstr(&mp_type_str, &e.vstr);
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
+STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_ujson_dumps_obj, 1, mod_ujson_dumps);
 
-// The function below implements a simple non-recursive JSON parser.
+// The functions below implement a simple non-recursive JSON parser.
 //
 // The JSON specification is at http://www.ietf.org/rfc/rfc4627.txt
 // The parser here will parse any valid JSON and return the correct
@@ -63,51 +322,90 @@ STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
 // Most of the work is parsing the primitives (null, false, true, numbers,
 // strings).  It does 1 pass over the input stream.  It tries to be fast and
 // small in code size, while not using more RAM than necessary.
+//
+// The input is read from the stream in chunks, and strings and numbers that
+// lie within a chunk are converted directly from it.  For loads the whole
+// input is one chunk and no stream is used.
 
 typedef struct _ujson_stream_t {
     mp_obj_t stream_obj;
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
     int errcode;
     byte cur;
+    const byte *pos; // the byte after cur, if cur is in the current chunk
+    const byte *end; // the end of the current chunk
+    byte *buf;
+    size_t buf_size;
 } ujson_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
 #define S_END(s) ((s).cur == S_EOF)
 #define S_CUR(s) ((s).cur)
-#define S_NEXT(s) (ujson_stream_next(&(s)))
+#define S_NEXT(s) ((s).pos < (s).end ? ((s).cur = *(s).pos++) : ujson_stream_fill(&(s)))
 
-STATIC byte ujson_stream_next(ujson_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
-    }
-    if (ret == 0) {
-        s->cur = S_EOF;
+STATIC byte ujson_stream_fill(ujson_stream_t *s) {
+    s->cur = S_EOF;
+    if (s->stream_obj != MP_OBJ_NULL) {
+        mp_uint_t ret = s->read(s->stream_obj, s->buf, s->buf_size, &s->errcode);
+        if (s->errcode != 0) {
+            mp_raise_OSError(s->errcode);
+        }
+        if (ret != 0) {
+            s->pos = s->buf;
+            s->end = s->buf + ret;
+            s->cur = *s->pos++;
+        }
     }
     return s->cur;
 }
 
-STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
+STATIC void ujson_stream_init(ujson_stream_t *s, mp_obj_t stream_obj, byte *buf, size_t buf_size) {
     const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    ujson_stream_t s = {stream_obj, stream_p->read, 0, 0};
-    vstr_t vstr;
-    vstr_init(&vstr, 8);
-    mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
-    stack.len = 0;
-    stack.items = NULL;
-    mp_obj_t stack_top = MP_OBJ_NULL;
-    mp_obj_type_t *stack_top_type = NULL;
-    mp_obj_t stack_key = MP_OBJ_NULL;
-    S_NEXT(s);
+    s->stream_obj = stream_obj;
+    s->read = stream_p->read;
+    s->errcode = 0;
+    s->pos = buf;
+    s->end = buf;
+    s->buf = buf;
+    s->buf_size = buf_size;
+}
+
+STATIC mp_obj_t ujson_new_str(const byte *str, size_t len, bool key) {
+    #if MICROPY_PY_UJSON_QSTR_KEY_LEN
+    if (key && len <= MICROPY_PY_UJSON_QSTR_KEY_LEN) {
+        // only existing qstrs are used, so untrusted input can't fill the pool
+        qstr q = qstr_find_strn((const char*)str, len);
+        if (q != MP_QSTR_NULL) {
+            return MP_OBJ_NEW_QSTR(q);
+        }
+    }
+    #else
+    (void)key;
+    #endif
+    return mp_obj_new_str((const char*)str, len);
+}
+
+STATIC bool ujson_is_num_char(byte c, bool *flt) {
+    if (c == '.' || c == 'E' || c == 'e') {
+        *flt = true;
+        return true;
+    }
+    return c == '+' || c == '-' || unichar_isdigit(c);
+}
+
+// Skip whitespace and separators and parse the next token.  Returns S_EOF at
+// the end of the input, the bracket or brace for the start or end of a list or
+// dict, or 'v' with *value set for a primitive.  key says whether a string
+// would be a dict key.
+STATIC byte ujson_next_token(ujson_stream_t *s, vstr_t *vstr, bool key, mp_obj_t *value) {
     for (;;) {
-        cont:
-        if (S_END(s)) {
-            break;
+        byte cur = S_CUR(*s);
+        if (cur == S_EOF) {
+            return S_EOF;
         }
-        mp_obj_t next = MP_OBJ_NULL;
-        bool enter = false;
-        byte cur = S_CUR(s);
-        S_NEXT(s);
+        // the position of cur, valid while s->pos is tok + 2
+        const byte *tok = s->pos - 1;
+        S_NEXT(*s);
         switch (cur) {
             case ',':
             case ':':
@@ -115,37 +413,55 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
             case '\t':
             case '\n':
             case '\r':
-                goto cont;
+                continue;
+            case '[':
+            case '{':
+            case ']':
+            case '}':
+                return cur;
             case 'n':
-                if (S_CUR(s) == 'u' && S_NEXT(s) == 'l' && S_NEXT(s) == 'l') {
-                    S_NEXT(s);
-                    next = mp_const_none;
-                } else {
-                    goto fail;
+                if (S_CUR(*s) == 'u' && S_NEXT(*s) == 'l' && S_NEXT(*s) == 'l') {
+                    S_NEXT(*s);
+                    *value = mp_const_none;
+                    return 'v';
                 }
-                break;
+                goto fail;
             case 'f':
-                if (S_CUR(s) == 'a' && S_NEXT(s) == 'l' && S_NEXT(s) == 's' && S_NEXT(s) == 'e') {
-                    S_NEXT(s);
-                    next = mp_const_false;
-                } else {
-                    goto fail;
+                if (S_CUR(*s) == 'a' && S_NEXT(*s) == 'l' && S_NEXT(*s) == 's' && S_NEXT(*s) == 'e') {
+                    S_NEXT(*s);
+                    *value = mp_const_false;
+                    return 'v';
                 }
-                break;
+                goto fail;
             case 't':
-                if (S_CUR(s) == 'r' && S_NEXT(s) == 'u' && S_NEXT(s) == 'e') {
-                    S_NEXT(s);
-                    next = mp_const_true;
-                } else {
-                    goto fail;
+                if (S_CUR(*s) == 'r' && S_NEXT(*s) == 'u' && S_NEXT(*s) == 'e') {
+                    S_NEXT(*s);
+                    *value = mp_const_true;
+                    return 'v';
                 }
-                break;
-            case '"':
-                vstr_reset(&vstr);
-                for (; !S_END(s) && S_CUR(s) != '"';) {
-                    byte c = S_CUR(s);
+                goto fail;
+            case '"': {
+                vstr_reset(vstr);
+                if (s->pos == tok + 2) {
+                    // take the string straight from the chunk if it has no escapes
+                    const byte *p = tok + 1;
+                    while (p < s->end && *p != '"' && *p != '\\' && *p != S_EOF) {
+                        ++p;
+                    }
+                    if (p < s->end && *p == '"') {
+                        *value = ujson_new_str(tok + 1, p - (tok + 1), key);
+                        s->pos = p + 1;
+                        S_NEXT(*s);
+                        return 'v';
+                    }
+                    vstr_add_strn(vstr, (const char*)tok + 1, p - (tok + 1));
+                    s->pos = p;
+                    S_NEXT(*s);
+                }
+                for (; !S_END(*s) && S_CUR(*s) != '"';) {
+                    byte c = S_CUR(*s);
                     if (c == '\\') {
-                        c = S_NEXT(s);
+                        c = S_NEXT(*s);
                         switch (c) {
                             case 'b': c = 0x08; break;
                             case 'f': c = 0x0c; break;
@@ -155,50 +471,92 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                             case 'u': {
                                 mp_uint_t num = 0;
                                 for (int i = 0; i < 4; i++) {
-                                    c = (S_NEXT(s) | 0x20) - '0';
+                                    c = (S_NEXT(*s) | 0x20) - '0';
                                     if (c > 9) {
                                         c -= ('a' - ('9' + 1));
                                     }
                                     num = (num << 4) | c;
                                 }
-                                vstr_add_char(&vstr, num);
+                                vstr_add_char(vstr, num);
                                 goto str_cont;
                             }
                         }
                     }
-                    vstr_add_byte(&vstr, c);
+                    vstr_add_byte(vstr, c);
                 str_cont:
-                    S_NEXT(s);
+                    S_NEXT(*s);
                 }
-                if (S_END(s)) {
+                if (S_END(*s)) {
                     goto fail;
                 }
-                S_NEXT(s);
-                next = mp_obj_new_str(vstr.buf, vstr.len);
-                break;
+                S_NEXT(*s);
+                *value = ujson_new_str((const byte*)vstr->buf, vstr->len, key);
+                return 'v';
+            }
             case '-':
             case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
                 bool flt = false;
-                vstr_reset(&vstr);
-                for (;;) {
-                    vstr_add_byte(&vstr, cur);
-                    cur = S_CUR(s);
-                    if (cur == '.' || cur == 'E' || cur == 'e') {
-                        flt = true;
-                    } else if (cur == '+' || cur == '-' || unichar_isdigit(cur)) {
-                        // pass
-                    } else {
-                        break;
+                const char *str;
+                size_t len;
+                vstr_reset(vstr);
+                if (s->pos == tok + 2) {
+                    // convert the number straight from the chunk if it ends within it
+                    const byte *p = tok + 1;
+                    while (p < s->end && ujson_is_num_char(*p, &flt)) {
+                        ++p;
+                    }
+                    s->pos = p;
+                    if (p < s->end || s->stream_obj == MP_OBJ_NULL) {
+                        S_NEXT(*s);
+                        str = (const char*)tok;
+                        len = p - tok;
+                        goto num_done;
                     }
-                    S_NEXT(s);
+                    vstr_add_strn(vstr, (const char*)tok, p - tok);
+                    S_NEXT(*s);
+                } else {
+                    vstr_add_byte(vstr, cur);
+                }
+                while (ujson_is_num_char(S_CUR(*s), &flt)) {
+                    vstr_add_byte(vstr, S_CUR(*s));
+                    S_NEXT(*s);
                 }
+                str = vstr->buf;
+                len = vstr->len;
+            num_done:
                 if (flt) {
-                    next = mp_parse_num_decimal(vstr.buf, vstr.len, false, false, NULL);
+                    *value = mp_parse_num_decimal(str, len, false, false, NULL);
                 } else {
-                    next = mp_parse_num_integer(vstr.buf, vstr.len, 10, NULL);
+                    *value = mp_parse_num_integer(str, len, 10, NULL);
                 }
-                break;
+                return 'v';
             }
+            default:
+                goto fail;
+        }
+    }
+
+    fail:
+    mp_raise_ValueError("syntax error in JSON");
+}
+
+STATIC mp_obj_t ujson_load(ujson_stream_t *s) {
+    vstr_t vstr;
+    vstr_init(&vstr, 8);
+    mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
+    stack.len = 0;
+    stack.items = NULL;
+    mp_obj_t stack_top = MP_OBJ_NULL;
+    mp_obj_type_t *stack_top_type = NULL;
+    mp_obj_t stack_key = MP_OBJ_NULL;
+    S_NEXT(*s);
+    for (;;) {
+        mp_obj_t next = MP_OBJ_NULL;
+        bool enter = false;
+        bool key = stack_top_type == &mp_type_dict && stack_key == MP_OBJ_NULL;
+        switch (ujson_next_token(s, &vstr, key, &next)) {
+            case S_EOF:
+                goto success;
             case '[':
                 next = mp_obj_new_list(0, NULL);
                 enter = true;
@@ -220,10 +578,11 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                 stack.len -= 1;
                 stack_top = stack.items[stack.len];
                 stack_top_type = mp_obj_get_type(stack_top);
-                goto cont;
+                continue;
             }
             default:
-                goto fail;
+                // a primitive
+                break;
         }
         if (stack_top == MP_OBJ_NULL) {
             stack_top = next;
@@ -261,10 +620,10 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
     }
     success:
     // eat trailing whitespace
-    while (unichar_isspace(S_CUR(s))) {
-        S_NEXT(s);
+    while (unichar_isspace(S_CUR(*s))) {
+        S_NEXT(*s);
     }
-    if (!S_END(s)) {
+    if (!S_END(*s)) {
         // unexpected chars
         goto fail;
     }
@@ -278,23 +637,122 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
     fail:
     mp_raise_ValueError("syntax error in JSON");
 }
+
+STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
+    byte buf[MICROPY_PY_UJSON_BUF_SIZE];
+    ujson_stream_t s;
+    ujson_stream_init(&s, stream_obj, buf, sizeof(buf));
+    return ujson_load(&s);
+}
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_load_obj, mod_ujson_load);
 
 STATIC mp_obj_t mod_ujson_loads(mp_obj_t obj) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(obj, &bufinfo, MP_BUFFER_READ);
-    vstr_t vstr = {bufinfo.len, bufinfo.len, (char*)bufinfo.buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_ujson_load(MP_OBJ_FROM_PTR(&sio));
+    ujson_stream_t s = {MP_OBJ_NULL, NULL, 0, 0, bufinfo.buf, (byte*)bufinfo.buf + bufinfo.len, NULL, 0};
+    return ujson_load(&s);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_loads_obj, mod_ujson_loads);
 
+#if MICROPY_PY_UJSON_ITERLOAD
+
+// The iterator returned by iterload yields an (event, value) tuple for each
+// token of the document, and only keeps the stack of open lists and dicts.
+
+typedef struct _mp_obj_ujson_iter_t {
+    mp_obj_base_t base;
+    ujson_stream_t s;
+    vstr_t vstr;
+    vstr_t nest; // the opening bracket or brace of each open list or dict
+    bool key; // the next primitive is a dict key
+    bool done; // the top-level object is complete
+    byte buf[];
+} mp_obj_ujson_iter_t;
+
+STATIC mp_obj_t ujson_iter_iternext(mp_obj_t self_in) {
+    mp_obj_ujson_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t value = mp_const_none;
+    byte tok = ujson_next_token(&self->s, &self->vstr, self->key, &value);
+    if (tok == S_EOF) {
+        if (!self->done) {
+            goto fail;
+        }
+        return MP_OBJ_STOP_ITERATION;
+    }
+    if (self->done) {
+        // not exactly 1 object
+        goto fail;
+    }
+    size_t depth = self->nest.len;
+    bool in_dict = depth != 0 && self->nest.buf[depth - 1] == '{';
+    qstr event;
+    switch (tok) {
+        case '[':
+        case '{':
+            if (self->key) {
+                goto fail;
+            }
+            vstr_add_byte(&self->nest, tok);
+            self->key = tok == '{';
+            event = tok == '{' ? MP_QSTR_start_map : MP_QSTR_start_array;
+            break;
+        case ']':
+        case '}':
+            // the closing char is 2 after the opening one for both pairs
+            if (depth == 0 || self->nest.buf[depth - 1] != tok - 2 || (in_dict && !self->key)) {
+                goto fail;
+            }
+            vstr_cut_tail_bytes(&self->nest, 1);
+            depth -= 1;
+            self->key = depth != 0 && self->nest.buf[depth - 1] == '{';
+            event = tok == '}' ? MP_QSTR_end_map : MP_QSTR_end_array;
+            break;
+        default:
+            event = self->key ? MP_QSTR_map_key : MP_QSTR_value;
+            if (in_dict) {
+                self->key = !self->key;
+            }
+            break;
+    }
+    self->done = self->nest.len == 0;
+    mp_obj_t tuple[2] = {MP_OBJ_NEW_QSTR(event), value};
+    return mp_obj_new_tuple(2, tuple);
+
+    fail:
+    mp_raise_ValueError("syntax error in JSON");
+}
+
+STATIC const mp_obj_type_t ujson_iter_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = ujson_iter_iternext,
+};
+
+STATIC mp_obj_t mod_ujson_iterload(mp_obj_t stream_obj) {
+    mp_obj_ujson_iter_t *o = m_new_obj_var(mp_obj_ujson_iter_t, byte, MICROPY_PY_UJSON_BUF_SIZE);
+    o->base.type = &ujson_iter_type;
+    ujson_stream_init(&o->s, stream_obj, o->buf, MICROPY_PY_UJSON_BUF_SIZE);
+    vstr_init(&o->vstr, 8);
+    vstr_init(&o->nest, 8);
+    o->key = false;
+    o->done = false;
+    S_NEXT(o->s);
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_iterload_obj, mod_ujson_iterload);
+
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_ujson_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ujson) },
     { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&mod_ujson_dump_obj) },
     { MP_ROM_QSTR(MP_QSTR_dumps), MP_ROM_PTR(&mod_ujson_dumps_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&mod_ujson_load_obj) },
     { MP_ROM_QSTR(MP_QSTR_loads), MP_ROM_PTR(&mod_ujson_loads_obj) },
+    #if MICROPY_PY_UJSON_ITERLOAD
+    { MP_ROM_QSTR(MP_QSTR_iterload), MP_ROM_PTR(&mod_ujson_iterload_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_ujson_globals, mp_module_ujson_globals_table);
@@ -41,8 +41,17 @@
 
 #define FLAG_DEBUG 0x1000
 
+#if MICROPY_PY_URE_PIKEVM
+#define re1_5_exec re1_5_pikevm
+#else
+#define re1_5_exec re1_5_recursiveloopprog
+#endif
+
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_URE_CACHE
+    mp_obj_t pattern;
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -182,7 +191,7 @@ STATIC mp_obj_t ure_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
     mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
     memset((char*)match->caps, 0, caps_num * sizeof(char*));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    int res = re1_5_exec(&self->re, &subj, match->caps, caps_num, is_anchored);
     if (res == 0) {
         m_del_var(mp_obj_match_t, char*, caps_num, match);
         return mp_const_none;
@@ -223,7 +232,7 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char**)caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = re1_5_exec(&self->re, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
@@ -278,7 +287,7 @@ STATIC mp_obj_t re_sub_helper(mp_obj_t self_in, size_t n_args, const mp_obj_t *a
     for (;;) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char*)match->caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, false);
+        int res = re1_5_exec(&self->re, &subj, match->caps, caps_num, false);
 
         // If we didn't have a match, or had an empty match, it's time to stop
         if (!res || match->caps[0] == match->caps[1]) {
@@ -381,15 +390,56 @@ STATIC const mp_obj_type_t re_type = {
     .locals_dict = (void*)&re_locals_dict,
 };
 
+#if MICROPY_PY_URE_CACHE
+
+// The cache holds the most recently used patterns, most recent first
+STATIC mp_obj_t ure_cache_lookup(mp_obj_t pattern) {
+    size_t len;
+    const char *str = mp_obj_str_get_data(pattern, &len);
+    mp_obj_t *cache = MP_STATE_VM(ure_cache);
+    for (size_t i = 0; i < MICROPY_PY_URE_CACHE && cache[i] != MP_OBJ_NULL; ++i) {
+        mp_obj_re_t *o = MP_OBJ_TO_PTR(cache[i]);
+        size_t o_len;
+        const char *o_str = mp_obj_str_get_data(o->pattern, &o_len);
+        if (o->pattern == pattern || (o_len == len && memcmp(o_str, str, len) == 0)) {
+            memmove(&cache[1], &cache[0], i * sizeof(mp_obj_t));
+            cache[0] = MP_OBJ_FROM_PTR(o);
+            return cache[0];
+        }
+    }
+    return MP_OBJ_NULL;
+}
+
+STATIC void ure_cache_store(mp_obj_t re) {
+    mp_obj_t *cache = MP_STATE_VM(ure_cache);
+    memmove(&cache[1], &cache[0], (MICROPY_PY_URE_CACHE - 1) * sizeof(mp_obj_t));
+    cache[0] = re;
+}
+
+#endif
+
 STATIC mp_obj_t mod_re_compile(size_t n_args, const mp_obj_t *args) {
     (void)n_args;
     const char *re_str = mp_obj_str_get_str(args[0]);
+    #if MICROPY_PY_URE_CACHE
+    // compiling with flags is rare, and they only affect compilation
+    bool use_cache = n_args == 1 || mp_obj_get_int(args[1]) == 0;
+    if (use_cache) {
+        mp_obj_t re = ure_cache_lookup(args[0]);
+        if (re != MP_OBJ_NULL) {
+            return re;
+        }
+    }
+    #endif
     int size = re1_5_sizecode(re_str);
     if (size == -1) {
         goto error;
     }
     mp_obj_re_t *o = m_new_obj_var(mp_obj_re_t, char, size);
     o->base.type = &re_type;
+    #if MICROPY_PY_URE_CACHE
+    o->pattern = args[0];
+    #endif
     #if MICROPY_PY_URE_DEBUG
     int flags = 0;
     if (n_args > 1) {
@@ -406,6 +456,11 @@ error:
         re1_5_dumpcode(&o->re);
     }
     #endif
+    #if MICROPY_PY_URE_CACHE
+    if (use_cache) {
+        ure_cache_store(MP_OBJ_FROM_PTR(o));
+    }
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_compile_obj, 1, 2, mod_re_compile);
@@ -465,7 +520,13 @@ const mp_obj_module_t mp_module_ure = {
 #if MICROPY_PY_URE_DEBUG
 #include "re1.5/dumpcode.c"
 #endif
+#if MICROPY_PY_URE_PIKEVM
+#define re1_5_alloc(n) m_new(char, n)
+#define re1_5_free(p, n) m_del(char, p, n)
+#include "re1.5/pike.c"
+#else
 #include "re1.5/recursiveloop.c"
+#endif
 #include "re1.5/charclass.c"
 
 #endif //MICROPY_PY_URE
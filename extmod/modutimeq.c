@@ -59,14 +59,12 @@ STATIC mp_obj_utimeq_t *utimeq_get_heap(mp_obj_t heap_in) {
     return MP_OBJ_TO_PTR(heap_in);
 }
 
-STATIC bool time_less_than(struct qentry *item, struct qentry *parent) {
-    mp_uint_t item_tm = item->time;
-    mp_uint_t parent_tm = parent->time;
+STATIC bool ticks_less_than(mp_uint_t item_tm, mp_uint_t item_id, mp_uint_t parent_tm, mp_uint_t parent_id) {
     mp_uint_t res = parent_tm - item_tm;
     if (res == 0) {
         // TODO: This actually should use the same "ring" logic
         // as for time, to avoid artifacts when id's overflow.
-        return item->id < parent->id;
+        return item_id < parent_id;
     }
     if ((mp_int_t)res < 0) {
         res += MODULO;
@@ -74,6 +72,10 @@ STATIC bool time_less_than(struct qentry *item, struct qentry *parent) {
     return res && res < (MODULO / 2);
 }
 
+STATIC bool time_less_than(struct qentry *item, struct qentry *parent) {
+    return ticks_less_than(item->time, item->id, parent->time, parent->id);
+}
+
 STATIC mp_obj_t utimeq_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 1, 1, false);
     mp_uint_t alloc = mp_obj_get_int(args[0]);
@@ -215,9 +217,326 @@ STATIC const mp_obj_type_t utimeq_type = {
     .locals_dict = (void*)&utimeq_locals_dict,
 };
 
+#if MICROPY_PY_UTIMEQ_WHEEL
+
+// Hierarchical timing wheel with the same push/pop/peektime interface as
+// utimeq, plus O(1) cancellation of a pushed entry.
+//
+// Time is counted in wheel ticks, each a configurable number of units of the
+// pushed times (eg ms).  Each level has 32 slots, and a slot at level k covers
+// 32**k ticks.  An entry expiring at wheel tick e goes into the lowest level k
+// for which e and the current tick are in the same slot of level k + 1 (the
+// top level is a ring), so inserting and cancelling are O(1).  Finding the
+// earliest entry advances the current tick to the first occupied slot, using
+// a bitmap of occupied slots per level, and moves the entries of a higher
+// level slot down as the current tick enters it.  Entries within a level 0
+// slot are compared by their exact time, so the order of entries is the same
+// as with utimeq.
+
+#define WHEEL_BITS (5)
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_NIL (0xffff)
+#define WHEEL_MAX_ALLOC (0xffff)
+#define WHEEL_GEN_MASK (0x3fff)
+
+struct wentry {
+    mp_uint_t time;
+    mp_uint_t id;
+    mp_uint_t expiry; // in wheel ticks
+    mp_obj_t callback;
+    mp_obj_t args;
+    uint16_t next; // circular list of the entries in a slot, or free list
+    uint16_t prev;
+    uint16_t slot; // level * WHEEL_SLOTS + index, or WHEEL_NIL when free
+    uint16_t gen; // bumped each time the entry is freed, for stale handles
+};
+
+typedef struct _mp_obj_timerwheel_t {
+    mp_obj_base_t base;
+    mp_uint_t alloc;
+    mp_uint_t len;
+    mp_uint_t tick;
+    mp_uint_t cur; // current wheel tick
+    mp_uint_t cur_time; // time at the start of the current wheel tick
+    mp_uint_t levels;
+    uint16_t free;
+    uint16_t *heads; // levels * WHEEL_SLOTS list heads
+    uint32_t *occupied; // bitmap of non-empty slots, per level
+    struct wentry items[];
+} mp_obj_timerwheel_t;
+
+// Index of the lowest set bit of a non-zero value
+STATIC uint wheel_lowest_bit(uint32_t bits) {
+    static const uint8_t debruijn[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9,
+    };
+    return debruijn[((bits & -bits) * 0x077cb531u) >> 27];
+}
+
+STATIC mp_obj_t timerwheel_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 2, false);
+    mp_int_t alloc = mp_obj_get_int(args[0]);
+    mp_int_t tick = n_args > 1 ? mp_obj_get_int(args[1]) : 1;
+    if (alloc < 0 || alloc > WHEEL_MAX_ALLOC || tick <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+
+    // Entries are at most MODULO / 2 ms ahead of the current time, and the
+    // top level must span twice that so its ring can't alias the current slot
+    mp_uint_t max_ticks = MODULO / 2 / tick;
+    mp_uint_t levels = 1;
+    while (levels * WHEEL_BITS - 1 < sizeof(mp_uint_t) * 8 && (max_ticks >> (levels * WHEEL_BITS - 1)) != 0) {
+        levels += 1;
+    }
+
+    mp_obj_timerwheel_t *o = m_new_obj_var(mp_obj_timerwheel_t, struct wentry, alloc);
+    o->base.type = type;
+    memset(o->items, 0, sizeof(*o->items) * alloc);
+    o->alloc = alloc;
+    o->len = 0;
+    o->tick = tick;
+    o->cur = 0;
+    o->cur_time = 0;
+    o->levels = levels;
+    o->heads = m_new(uint16_t, levels * WHEEL_SLOTS);
+    memset(o->heads, 0xff, levels * WHEEL_SLOTS * sizeof(uint16_t));
+    o->occupied = m_new0(uint32_t, levels);
+    for (mp_int_t i = 0; i < alloc; i++) {
+        o->items[i].next = i + 1 < alloc ? i + 1 : WHEEL_NIL;
+        o->items[i].slot = WHEEL_NIL;
+    }
+    o->free = alloc > 0 ? 0 : WHEEL_NIL;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+// Add entry i to the slot for its expiry tick
+STATIC void timerwheel_link(mp_obj_timerwheel_t *self, uint i) {
+    struct wentry *e = &self->items[i];
+    mp_uint_t diff = e->expiry ^ self->cur;
+    uint level = 0;
+    while (level < self->levels - 1 && (diff >> ((level + 1) * WHEEL_BITS)) != 0) {
+        level += 1;
+    }
+    uint index = (e->expiry >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+    uint slot = level * WHEEL_SLOTS + index;
+    uint head = self->heads[slot];
+    e->slot = slot;
+    if (head == WHEEL_NIL) {
+        self->heads[slot] = i;
+        self->occupied[level] |= (uint32_t)1 << index;
+        e->next = i;
+        e->prev = i;
+    } else {
+        // append, so entries moved down keep their order
+        uint tail = self->items[head].prev;
+        e->next = head;
+        e->prev = tail;
+        self->items[tail].next = i;
+        self->items[head].prev = i;
+    }
+}
+
+STATIC void timerwheel_unlink(mp_obj_timerwheel_t *self, uint i) {
+    struct wentry *e = &self->items[i];
+    uint slot = e->slot;
+    if (e->next == i) {
+        self->heads[slot] = WHEEL_NIL;
+        self->occupied[slot / WHEEL_SLOTS] &= ~((uint32_t)1 << (slot % WHEEL_SLOTS));
+    } else {
+        self->items[e->prev].next = e->next;
+        self->items[e->next].prev = e->prev;
+        if (self->heads[slot] == i) {
+            self->heads[slot] = e->next;
+        }
+    }
+}
+
+STATIC void timerwheel_free(mp_obj_timerwheel_t *self, uint i) {
+    struct wentry *e = &self->items[i];
+    e->callback = MP_OBJ_NULL; // so we don't retain a pointer
+    e->args = MP_OBJ_NULL;
+    e->slot = WHEEL_NIL;
+    e->gen = (e->gen + 1) & WHEEL_GEN_MASK;
+    e->next = self->free;
+    self->free = i;
+    self->len -= 1;
+}
+
+// Advance the current tick to the first occupied slot, moving down the
+// entries of any higher level slot it enters, and return the earliest entry.
+// The queue must not be empty.
+STATIC uint timerwheel_first(mp_obj_timerwheel_t *self) {
+    for (;;) {
+        uint index = self->cur & (WHEEL_SLOTS - 1);
+        uint32_t bits = self->occupied[0] & ((uint32_t)-1 << index);
+        uint level = 0;
+        if (bits == 0) {
+            // the rest of level 0 is empty, look for the next occupied slot
+            // after the current one in the levels above
+            for (level = 1; level < self->levels; level++) {
+                index = (self->cur >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+                bits = self->occupied[level];
+                if (level < self->levels - 1) {
+                    bits &= (uint32_t)-2 << index;
+                } else if (bits != 0) {
+                    // the top level is a ring, rotate it so the current
+                    // slot is at bit 0
+                    if (index != 0) {
+                        bits = (bits >> index) | (bits << (WHEEL_SLOTS - index));
+                    }
+                    bits &= ~(uint32_t)1;
+                    index = 0;
+                }
+                if (bits != 0) {
+                    break;
+                }
+            }
+            assert(level < self->levels);
+        }
+
+        // advance the current tick to the start of the slot found
+        uint found = wheel_lowest_bit(bits);
+        uint shift = level * WHEEL_BITS;
+        mp_uint_t next = (self->cur & ~(((mp_uint_t)1 << shift) - 1)) + ((mp_uint_t)(found - index) << shift);
+        self->cur_time = (self->cur_time + (next - self->cur) * self->tick) & (MODULO - 1);
+        self->cur = next;
+
+        uint slot = level * WHEEL_SLOTS + ((next >> shift) & (WHEEL_SLOTS - 1));
+        uint head = self->heads[slot];
+        if (level == 0) {
+            // entries here may differ within the tick, pick the earliest
+            uint best = head;
+            for (uint i = self->items[head].next; i != head; i = self->items[i].next) {
+                struct wentry *e = &self->items[i];
+                if (ticks_less_than(e->time, e->id, self->items[best].time, self->items[best].id)) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // move the slot's entries down to the levels below
+        self->heads[slot] = WHEEL_NIL;
+        self->occupied[level] &= ~((uint32_t)1 << (slot % WHEEL_SLOTS));
+        uint i = head;
+        do {
+            uint next_i = self->items[i].next;
+            timerwheel_link(self, i);
+            i = next_i;
+        } while (i != head);
+    }
+}
+
+STATIC mp_obj_t mod_timerwheel_push(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    mp_obj_timerwheel_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (self->free == WHEEL_NIL) {
+        mp_raise_msg(&mp_type_IndexError, "queue overflow");
+    }
+    mp_uint_t time = MP_OBJ_SMALL_INT_VALUE(args[1]);
+    if (self->len == 0) {
+        // nothing is pending, so the wheel can start from this time
+        self->cur_time = time;
+    }
+    uint i = self->free;
+    struct wentry *e = &self->items[i];
+    self->free = e->next;
+    self->len += 1;
+    e->time = time;
+    e->id = utimeq_id++;
+    e->callback = args[2];
+    e->args = args[3];
+    // entries due before the current tick go in the current slot
+    mp_int_t delta = ((time - self->cur_time) & (MODULO - 1));
+    if (delta >= (mp_int_t)(MODULO / 2)) {
+        delta = 0;
+    }
+    e->expiry = self->cur + delta / self->tick;
+    timerwheel_link(self, i);
+    return MP_OBJ_NEW_SMALL_INT(((mp_uint_t)e->gen << 16) | i);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_timerwheel_push_obj, 4, 4, mod_timerwheel_push);
+
+STATIC mp_obj_t mod_timerwheel_pop(mp_obj_t self_in, mp_obj_t list_ref) {
+    mp_obj_timerwheel_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->len == 0) {
+        mp_raise_msg(&mp_type_IndexError, "empty heap");
+    }
+    mp_obj_list_t *ret = MP_OBJ_TO_PTR(list_ref);
+    if (!mp_obj_is_type(list_ref, &mp_type_list) || ret->len < 3) {
+        mp_raise_TypeError(NULL);
+    }
+
+    uint i = timerwheel_first(self);
+    struct wentry *e = &self->items[i];
+    ret->items[0] = MP_OBJ_NEW_SMALL_INT(e->time);
+    ret->items[1] = e->callback;
+    ret->items[2] = e->args;
+    timerwheel_unlink(self, i);
+    timerwheel_free(self, i);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_timerwheel_pop_obj, mod_timerwheel_pop);
+
+STATIC mp_obj_t mod_timerwheel_peektime(mp_obj_t self_in) {
+    mp_obj_timerwheel_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->len == 0) {
+        mp_raise_msg(&mp_type_IndexError, "empty heap");
+    }
+    return MP_OBJ_NEW_SMALL_INT(self->items[timerwheel_first(self)].time);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_timerwheel_peektime_obj, mod_timerwheel_peektime);
+
+// Remove the entry with the handle returned by push, returning whether it
+// was still pending
+STATIC mp_obj_t mod_timerwheel_cancel(mp_obj_t self_in, mp_obj_t handle_in) {
+    mp_obj_timerwheel_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_uint_t handle = mp_obj_get_int_truncated(handle_in);
+    mp_uint_t i = handle & 0xffff;
+    if (i >= self->alloc || self->items[i].slot == WHEEL_NIL || self->items[i].gen != handle >> 16) {
+        return mp_const_false;
+    }
+    timerwheel_unlink(self, i);
+    timerwheel_free(self, i);
+    return mp_const_true;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_timerwheel_cancel_obj, mod_timerwheel_cancel);
+
+STATIC mp_obj_t timerwheel_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
+    mp_obj_timerwheel_t *self = MP_OBJ_TO_PTR(self_in);
+    switch (op) {
+        case MP_UNARY_OP_BOOL: return mp_obj_new_bool(self->len != 0);
+        case MP_UNARY_OP_LEN: return MP_OBJ_NEW_SMALL_INT(self->len);
+        default: return MP_OBJ_NULL; // op not supported
+    }
+}
+
+STATIC const mp_rom_map_elem_t timerwheel_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_push), MP_ROM_PTR(&mod_timerwheel_push_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pop), MP_ROM_PTR(&mod_timerwheel_pop_obj) },
+    { MP_ROM_QSTR(MP_QSTR_peektime), MP_ROM_PTR(&mod_timerwheel_peektime_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cancel), MP_ROM_PTR(&mod_timerwheel_cancel_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(timerwheel_locals_dict, timerwheel_locals_dict_table);
+
+STATIC const mp_obj_type_t timerwheel_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_timerwheel,
+    .make_new = timerwheel_make_new,
+    .unary_op = timerwheel_unary_op,
+    .locals_dict = (void*)&timerwheel_locals_dict,
+};
+
+#endif // MICROPY_PY_UTIMEQ_WHEEL
+
 STATIC const mp_rom_map_elem_t mp_module_utimeq_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_utimeq) },
     { MP_ROM_QSTR(MP_QSTR_utimeq), MP_ROM_PTR(&utimeq_type) },
+    #if MICROPY_PY_UTIMEQ_WHEEL
+    { MP_ROM_QSTR(MP_QSTR_timerwheel), MP_ROM_PTR(&timerwheel_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_utimeq_globals, mp_module_utimeq_globals_table);
@@ -33,6 +33,7 @@
 
 #if MICROPY_PY_UZLIB
 
+#define UZLIB_CONF_CRC32_SLICE4 (MICROPY_PY_UZLIB_CRC32_SLICE4)
 #include "uzlib/tinf.h"
 
 #if 0 // print debugging info
@@ -46,24 +47,58 @@ typedef struct _mp_obj_decompio_t {
     mp_obj_t src_stream;
     TINF_DATA decomp;
     bool eof;
+    byte buf[MICROPY_PY_UZLIB_DECOMPIO_BUF_SIZE];
 } mp_obj_decompio_t;
 
+// Windows are only needed until the end of a stream, so they are kept for
+// reuse by the next DecompIO of the same window size rather than freed.
+STATIC byte *decompio_window_alloc(size_t size) {
+    #if MICROPY_PY_UZLIB_WINDOW_POOL
+    for (size_t i = 0; i < MICROPY_PY_UZLIB_WINDOW_POOL; ++i) {
+        byte *w = MP_STATE_VM(uzlib_window_pool)[i];
+        if (w != NULL && MP_STATE_VM(uzlib_window_pool_size)[i] == size) {
+            MP_STATE_VM(uzlib_window_pool)[i] = NULL;
+            // don't let an invalid stream see data from a previous one
+            memset(w, 0, size);
+            return w;
+        }
+    }
+    #endif
+    return m_new(byte, size);
+}
+
+STATIC void decompio_window_free(byte *w, size_t size) {
+    #if MICROPY_PY_UZLIB_WINDOW_POOL
+    for (size_t i = 0; i < MICROPY_PY_UZLIB_WINDOW_POOL; ++i) {
+        if (MP_STATE_VM(uzlib_window_pool)[i] == NULL) {
+            MP_STATE_VM(uzlib_window_pool)[i] = w;
+            MP_STATE_VM(uzlib_window_pool_size)[i] = size;
+            return;
+        }
+    }
+    #endif
+    m_del(byte, w, size);
+}
+
 STATIC int read_src_stream(TINF_DATA *data) {
     byte *p = (void*)data;
     p -= offsetof(mp_obj_decompio_t, decomp);
     mp_obj_decompio_t *self = (mp_obj_decompio_t*)p;
 
+    // Refill the whole buffer, so the decompressor can work from it directly.
+    // This may read past the end of the compressed data in src_stream.
     const mp_stream_p_t *stream = mp_get_stream(self->src_stream);
     int err;
-    byte c;
-    mp_uint_t out_sz = stream->read(self->src_stream, &c, 1, &err);
+    mp_uint_t out_sz = stream->read(self->src_stream, self->buf, sizeof(self->buf), &err);
     if (out_sz == MP_STREAM_ERROR) {
         mp_raise_OSError(err);
     }
     if (out_sz == 0) {
         nlr_raise(mp_obj_new_exception(&mp_type_EOFError));
     }
-    return c;
+    self->decomp.source = self->buf + 1;
+    self->decomp.source_limit = self->buf + out_sz;
+    return self->buf[0];
 }
 
 STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
@@ -94,12 +129,13 @@ STATIC mp_obj_t decompio_make_new(const mp_obj_type_t *type, size_t n_args, size
 header_error:
             mp_raise_ValueError("compression header");
         }
-        dict_sz = 1 << dict_opt;
+        // the header holds the window size as log2 minus 8
+        dict_sz = 1 << (dict_opt + 8);
     } else {
         dict_sz = 1 << -dict_opt;
     }
 
-    uzlib_uncompress_init(&o->decomp, m_new(byte, dict_sz), dict_sz);
+    uzlib_uncompress_init(&o->decomp, decompio_window_alloc(dict_sz), dict_sz);
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -114,6 +150,20 @@ STATIC mp_uint_t decompio_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *er
     int st = uzlib_uncompress_chksum(&o->decomp);
     if (st == TINF_DONE) {
         o->eof = true;
+        decompio_window_free(o->decomp.dict_ring, o->decomp.dict_size);
+        o->decomp.dict_ring = NULL;
+
+        // If input was read past the end of the compressed data then try to
+        // put src_stream back to just after it, ignoring any error
+        mp_uint_t unused = o->decomp.source_limit - o->decomp.source;
+        const mp_stream_p_t *stream = mp_get_stream(o->src_stream);
+        if (unused != 0 && stream->ioctl != NULL) {
+            struct mp_stream_seek_t seek_s;
+            seek_s.offset = -(mp_off_t)unused;
+            seek_s.whence = MP_SEEK_CUR;
+            int err;
+            stream->ioctl(o->src_stream, MP_STREAM_SEEK, (uintptr_t)&seek_s, &err);
+        }
     }
     if (st < 0) {
         *errcode = MP_EINVAL;
@@ -182,11 +232,13 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
         if (st == TINF_DONE) {
             break;
         }
+        // grow geometrically so that large outputs aren't copied many times
         size_t offset = decomp->dest - dest_buf;
-        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + 256);
-        dest_buf_size += 256;
+        size_t grow = dest_buf_size / 2 < 256 ? 256 : dest_buf_size / 2;
+        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + grow);
+        dest_buf_size += grow;
         decomp->dest = dest_buf + offset;
-        decomp->dest_limit = decomp->dest + 256;
+        decomp->dest_limit = dest_buf + dest_buf_size;
     }
 
     mp_uint_t final_sz = decomp->dest - dest_buf;
@@ -201,10 +253,235 @@ error:
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_decompress_obj, 1, 3, mod_uzlib_decompress);
 
+#if MICROPY_PY_UZLIB_COMPRESS
+
+#define COMPIO_FORMAT_RAW (0)
+#define COMPIO_FORMAT_ZLIB (1)
+#define COMPIO_FORMAT_GZIP (2)
+
+typedef struct _mp_obj_compio_t {
+    mp_obj_base_t base;
+    mp_obj_t dest_stream; // MP_OBJ_NULL once closed
+    struct uzlib_comp comp;
+    uint8_t format;
+    uint32_t checksum;
+    uint32_t isize;
+    byte buf[64];
+} mp_obj_compio_t;
+
+STATIC void compio_write_byte(mp_obj_compio_t *o, byte b) {
+    outbits(&o->comp.out, b, 8);
+}
+
+STATIC void compio_write_uint32_le(mp_obj_compio_t *o, uint32_t v) {
+    for (int i = 0; i < 4; ++i) {
+        compio_write_byte(o, v >> (8 * i));
+    }
+}
+
+// Set up the compressor and write the header for the format selected by wbits,
+// which has the same meaning as for decompression: 8..15 for zlib, 16 + 8..15
+// for gzip and -8..-15 for a raw DEFLATE stream.  The output buffer and its
+// flush callback must already be set up.
+STATIC void compio_init(mp_obj_compio_t *o, mp_int_t wbits) {
+    if (wbits >= 16 + 8 && wbits <= 16 + 15) {
+        o->format = COMPIO_FORMAT_GZIP;
+        wbits -= 16;
+    } else if (wbits >= 8 && wbits <= 15) {
+        o->format = COMPIO_FORMAT_ZLIB;
+    } else if (wbits >= -15 && wbits <= -8) {
+        o->format = COMPIO_FORMAT_RAW;
+        wbits = -wbits;
+    } else {
+        mp_raise_ValueError(NULL);
+    }
+
+    // Hash chains are 16 bits per window byte, the hash table is kept smaller
+    // than the window since most of its entries would be stale anyway
+    unsigned int dict_sz = 1 << wbits;
+    unsigned int hash_bits = wbits - 1;
+    if (hash_bits < 8) {
+        hash_bits = 8;
+    } else if (hash_bits > 13) {
+        hash_bits = 13;
+    }
+    uzlib_compress_init(&o->comp, m_new(byte, UZLIB_COMP_WINDOW_SIZE(dict_sz)),
+        m_new(uint16_t, 1 << hash_bits), m_new(uint16_t, dict_sz), wbits, hash_bits);
+    o->isize = 0;
+
+    if (o->format == COMPIO_FORMAT_ZLIB) {
+        byte cmf = ((wbits - 8) << 4) | 8;
+        compio_write_byte(o, cmf);
+        compio_write_byte(o, 31 - (cmf << 8) % 31);
+        o->checksum = 1;
+    } else if (o->format == COMPIO_FORMAT_GZIP) {
+        // no flags, no modification time, unknown OS
+        static const byte gzip_header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+        for (size_t i = 0; i < sizeof(gzip_header); ++i) {
+            compio_write_byte(o, gzip_header[i]);
+        }
+        o->checksum = ~0;
+    }
+    zlib_start_block(&o->comp.out);
+}
+
+STATIC void compio_update(mp_obj_compio_t *o, const byte *buf, size_t len) {
+    if (o->format == COMPIO_FORMAT_ZLIB) {
+        o->checksum = uzlib_adler32(buf, len, o->checksum);
+    } else if (o->format == COMPIO_FORMAT_GZIP) {
+        o->checksum = uzlib_crc32(buf, len, o->checksum);
+    }
+    o->isize += len;
+    uzlib_compress(&o->comp, buf, len);
+}
+
+// End the stream with its trailer and free the compressor's buffers.
+STATIC void compio_finish(mp_obj_compio_t *o) {
+    uzlib_compress_flush(&o->comp, 1);
+    if (o->format == COMPIO_FORMAT_ZLIB) {
+        for (int i = 3; i >= 0; --i) {
+            compio_write_byte(o, o->checksum >> (8 * i));
+        }
+    } else if (o->format == COMPIO_FORMAT_GZIP) {
+        compio_write_uint32_le(o, ~o->checksum);
+        compio_write_uint32_le(o, o->isize);
+    }
+    unsigned int dict_sz = o->comp.dict_size;
+    m_del(byte, o->comp.window, UZLIB_COMP_WINDOW_SIZE(dict_sz));
+    m_del(uint16_t, o->comp.hash_table, 1 << o->comp.hash_bits);
+    m_del(uint16_t, o->comp.prev, dict_sz);
+}
+
+STATIC void compio_flush_dest(struct Outbuf *out) {
+    byte *p = (void*)out;
+    p -= offsetof(mp_obj_compio_t, comp.out);
+    mp_obj_compio_t *self = (mp_obj_compio_t*)p;
+
+    mp_stream_write(self->dest_stream, out->outbuf, out->outlen, MP_STREAM_RW_WRITE);
+    out->outlen = 0;
+}
+
+STATIC mp_obj_t compio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+    mp_obj_compio_t *o = m_new_obj(mp_obj_compio_t);
+    o->base.type = type;
+    o->dest_stream = args[0];
+    memset(&o->comp.out, 0, sizeof(o->comp.out));
+    o->comp.out.outbuf = o->buf;
+    o->comp.out.outsize = sizeof(o->buf);
+    o->comp.out.flush = compio_flush_dest;
+    compio_init(o, n_args > 1 ? mp_obj_get_int(args[1]) : 10);
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_uint_t compio_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    if (o->dest_stream == MP_OBJ_NULL) {
+        *errcode = MP_EBADF;
+        return MP_STREAM_ERROR;
+    }
+    compio_update(o, buf, size);
+    return size;
+}
+
+STATIC mp_uint_t compio_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    (void)arg;
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    if (request == MP_STREAM_FLUSH || request == MP_STREAM_CLOSE) {
+        if (o->dest_stream == MP_OBJ_NULL) {
+            if (request == MP_STREAM_CLOSE) {
+                return 0;
+            }
+            *errcode = MP_EBADF;
+            return MP_STREAM_ERROR;
+        }
+        if (request == MP_STREAM_FLUSH) {
+            // a sync flush, so everything written so far can be decompressed
+            uzlib_compress_flush(&o->comp, 0);
+        } else {
+            compio_finish(o);
+        }
+        compio_flush_dest(&o->comp.out);
+        if (request == MP_STREAM_CLOSE) {
+            // the underlying stream is left open
+            o->dest_stream = MP_OBJ_NULL;
+        }
+        return 0;
+    } else {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+}
+
+STATIC mp_obj_t compio___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    return mp_stream_close(args[0]);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(compio___exit___obj, 4, 4, compio___exit__);
+
+STATIC const mp_rom_map_elem_t compio_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&mp_stream_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&mp_stream_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&compio___exit___obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(compio_locals_dict, compio_locals_dict_table);
+
+STATIC const mp_stream_p_t compio_stream_p = {
+    .write = compio_write,
+    .ioctl = compio_ioctl,
+};
+
+STATIC const mp_obj_type_t compio_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_CompressIO,
+    .make_new = compio_make_new,
+    .protocol = &compio_stream_p,
+    .locals_dict = (void*)&compio_locals_dict,
+};
+
+STATIC void compress_grow_buf(struct Outbuf *out) {
+    out->outbuf = m_renew(byte, out->outbuf, out->outsize, out->outsize * 2);
+    out->outsize *= 2;
+}
+
+STATIC mp_obj_t mod_uzlib_compress(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+
+    mp_obj_compio_t o;
+    memset(&o.comp.out, 0, sizeof(o.comp.out));
+    // text such as logs typically compresses to well under half its size
+    o.comp.out.outsize = bufinfo.len / 2 + 64;
+    o.comp.out.outbuf = m_new(byte, o.comp.out.outsize);
+    o.comp.out.flush = compress_grow_buf;
+    compio_init(&o, n_args > 1 ? mp_obj_get_int(args[1]) : 10);
+    compio_update(&o, bufinfo.buf, bufinfo.len);
+    compio_finish(&o);
+
+    vstr_t vstr = {
+        .alloc = o.comp.out.outsize,
+        .len = o.comp.out.outlen,
+        .buf = (char*)o.comp.out.outbuf,
+        .fixed_buf = false,
+    };
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_compress_obj, 1, 2, mod_uzlib_compress);
+
+#endif // MICROPY_PY_UZLIB_COMPRESS
+
 STATIC const mp_rom_map_elem_t mp_module_uzlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uzlib) },
     { MP_ROM_QSTR(MP_QSTR_decompress), MP_ROM_PTR(&mod_uzlib_decompress_obj) },
     { MP_ROM_QSTR(MP_QSTR_DecompIO), MP_ROM_PTR(&decompio_type) },
+    #if MICROPY_PY_UZLIB_COMPRESS
+    { MP_ROM_QSTR(MP_QSTR_compress), MP_ROM_PTR(&mod_uzlib_compress_obj) },
+    { MP_ROM_QSTR(MP_QSTR_CompressIO), MP_ROM_PTR(&compio_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_uzlib_globals, mp_module_uzlib_globals_table);
@@ -222,5 +499,9 @@ const mp_obj_module_t mp_module_uzlib = {
 #include "uzlib/tinfgzip.c"
 #include "uzlib/adler32.c"
 #include "uzlib/crc32.c"
+#if MICROPY_PY_UZLIB_COMPRESS
+#include "uzlib/defl_static.c"
+#include "uzlib/lz77.c"
+#endif
 
 #endif // MICROPY_PY_UZLIB
@@ -8,6 +8,12 @@
     ((code ? memmove(code + at + num, code + at, pc - at) : 0), pc += num)
 #define REL(at, to) (to - at - 2)
 #define EMIT(at, byte) (code ? (code[at] = byte) : (at))
+// jump offsets are stored in a signed byte, so fail if one doesn't fit
+#define EMIT_REL(at, rel) do { \
+        int r_ = (rel); \
+        if (r_ < -128 || r_ > 127) return NULL; \
+        EMIT(at, r_); \
+    } while (0)
 #define PC (prog->bytelen)
 
 static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
@@ -97,7 +103,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(term, Split);
             }
-            EMIT(term + 1, REL(term, PC));
+            EMIT_REL(term + 1, REL(term, PC));
             prog->len++;
             term = PC;
             break;
@@ -105,7 +111,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             if (PC == term) return NULL; // nothing to repeat
             INSERT_CODE(term, 2, PC);
             EMIT(PC, Jmp);
-            EMIT(PC + 1, REL(PC, term));
+            EMIT_REL(PC + 1, REL(PC, term));
             PC += 2;
             if (re[1] == '?') {
                 EMIT(term, RSplit);
@@ -113,7 +119,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(term, Split);
             }
-            EMIT(term + 1, REL(term, PC));
+            EMIT_REL(term + 1, REL(term, PC));
             prog->len += 2;
             term = PC;
             break;
@@ -125,20 +131,20 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
             } else {
                 EMIT(PC, RSplit);
             }
-            EMIT(PC + 1, REL(PC, term));
+            EMIT_REL(PC + 1, REL(PC, term));
             PC += 2;
             prog->len++;
             term = PC;
             break;
         case '|':
             if (alt_label) {
-                EMIT(alt_label, REL(alt_label, PC) + 1);
+                EMIT_REL(alt_label, REL(alt_label, PC) + 1);
             }
             INSERT_CODE(start, 2, PC);
             EMIT(PC++, Jmp);
             alt_label = PC++;
             EMIT(start, Split);
-            EMIT(start + 1, REL(start, PC));
+            EMIT_REL(start + 1, REL(start, PC));
             prog->len += 2;
             term = PC;
             break;
@@ -156,7 +162,7 @@ static const char *_compilecode(const char *re, ByteProg *prog, int sizecode)
     }
 
     if (alt_label) {
-        EMIT(alt_label, REL(alt_label, PC) + 1);
+        EMIT_REL(alt_label, REL(alt_label, PC) + 1);
     }
     return re;
 }
@@ -206,6 +212,17 @@ int re1_5_compilecode(ByteProg *prog, const char *re)
     return 0;
 }
 
+// Return the byte every match must start with, or -1 if there is none, so
+// that a search can skip to its occurrences
+int re1_5_literalprefix(ByteProg *prog)
+{
+    const char *pc = prog->insts + NON_ANCHORED_PREFIX;
+    while (*pc == Save) {
+        pc += 2;
+    }
+    return *pc == Char ? (unsigned char)pc[1] : -1;
+}
+
 #if 0
 int main(int argc, char *argv[])
 {
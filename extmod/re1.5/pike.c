@@ -0,0 +1,213 @@
+// Copyright 2007-2009 Russ Cox.  All Rights Reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: all threads of the program are run in lock step over the input,
+// with at most one thread per instruction, so matching takes time linear in
+// the length of the input and needs no recursion.  The threads for each input
+// position are kept in priority order, which gives the same match, and the
+// same submatches, as the backtracking matchers.
+
+// the scratch memory grows with the length of the program, so it must not be
+// put on the C stack
+#ifndef re1_5_alloc
+#define re1_5_alloc(n) malloc(n)
+#define re1_5_free(p, n) free(p)
+#endif
+
+typedef struct {
+    int n;
+    const char **pc;
+    // nsub entries for each thread
+    const char **sub;
+} ThreadList;
+
+typedef struct {
+    // instruction to add, or NULL to restore sub[save] to old
+    const char *pc;
+    int save;
+    const char *old;
+} Job;
+
+typedef struct {
+    const char *insts;
+    Subject *input;
+    int nsub;
+    unsigned int gen;
+    // gen of the list each instruction was last added to
+    unsigned int *mark;
+    Job *stack;
+} PikeVM;
+
+// Add the thread at pc to list l, following jumps, splits and saves, and
+// checking assertions, until it reaches instructions which consume input
+static void addthread(PikeVM *vm, ThreadList *l, const char *pc, const char *sp, const char **sub)
+{
+    int top = 0;
+    vm->stack[top].pc = pc;
+    top++;
+
+    while (top) {
+        Job *j = &vm->stack[--top];
+        if (j->pc == NULL) {
+            sub[j->save] = j->old;
+            continue;
+        }
+        pc = j->pc;
+        for (;;) {
+            int off = pc - vm->insts;
+            if (vm->mark[off] == vm->gen) {
+                // already added, with a higher priority
+                break;
+            }
+            vm->mark[off] = vm->gen;
+            switch (*pc) {
+            case Jmp:
+                pc += 2 + (signed char)pc[1];
+                continue;
+            case Split:
+                vm->stack[top].pc = pc + 2 + (signed char)pc[1];
+                top++;
+                pc += 2;
+                continue;
+            case RSplit:
+                vm->stack[top].pc = pc + 2;
+                top++;
+                pc += 2 + (signed char)pc[1];
+                continue;
+            case Save:
+                off = (unsigned char)pc[1];
+                if (off < vm->nsub) {
+                    vm->stack[top].pc = NULL;
+                    vm->stack[top].save = off;
+                    vm->stack[top].old = sub[off];
+                    top++;
+                    sub[off] = sp;
+                }
+                pc += 2;
+                continue;
+            case Bol:
+                if (sp != vm->input->begin) {
+                    break;
+                }
+                pc++;
+                continue;
+            case Eol:
+                if (sp != vm->input->end) {
+                    break;
+                }
+                pc++;
+                continue;
+            default:
+                // a consumer or Match
+                l->pc[l->n] = pc;
+                memcpy((char*)&l->sub[l->n * vm->nsub], sub, vm->nsub * sizeof(*sub));
+                l->n++;
+                break;
+            }
+            break;
+        }
+    }
+}
+
+int
+re1_5_pikevm(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored)
+{
+    // threads only wait on consumers and Match, each at most once per list
+    int cap = prog->len + 1;
+    size_t list_size = cap * (1 + nsubp) * sizeof(char*);
+    size_t size = 2 * list_size + nsubp * sizeof(char*) + cap * sizeof(Job) + prog->bytelen * sizeof(unsigned int);
+    char *mem = re1_5_alloc(size);
+
+    // new threads are started here rather than running the search prefix
+    const char *start = prog->insts + NON_ANCHORED_PREFIX;
+    int lit = is_anchored ? -1 : re1_5_literalprefix(prog);
+    ThreadList lists[2], *clist = &lists[0], *nlist = &lists[1];
+    PikeVM vm;
+    const char **sub0;
+    const char *sp;
+    int matched = 0;
+
+    lists[0].pc = (const char**)mem;
+    lists[0].sub = lists[0].pc + cap;
+    lists[1].pc = (const char**)(mem + list_size);
+    lists[1].sub = lists[1].pc + cap;
+    sub0 = (const char**)(mem + 2 * list_size);
+    vm.stack = (Job*)(sub0 + nsubp);
+    vm.mark = (unsigned int*)(vm.stack + cap);
+    vm.insts = prog->insts;
+    vm.input = input;
+    vm.nsub = nsubp;
+    vm.gen = 1;
+    memset((char*)sub0, 0, nsubp * sizeof(*sub0));
+    memset(vm.mark, 0, prog->bytelen * sizeof(unsigned int));
+
+    clist->n = 0;
+    for (sp = input->begin;; sp++) {
+        if (!matched && (!is_anchored || sp == input->begin)) {
+            // start a thread here, with the lowest priority
+            if (clist->n == 0 && lit >= 0) {
+                // no thread can match before the next occurrence of lit
+                sp = memchr(sp, lit, input->end - sp);
+                if (sp == NULL) {
+                    break;
+                }
+            }
+            addthread(&vm, clist, start, sp, sub0);
+        }
+        if (clist->n == 0) {
+            break;
+        }
+
+        vm.gen++;
+        nlist->n = 0;
+        for (int i = 0; i < clist->n; i++) {
+            const char *pc = clist->pc[i];
+            const char **sub = &clist->sub[i * nsubp];
+            if (*pc == Match) {
+                memcpy((char*)subp, sub, nsubp * sizeof(*sub));
+                matched = 1;
+                // cut off the lower priority threads
+                break;
+            }
+            if (sp >= input->end) {
+                continue;
+            }
+            switch (*pc) {
+            case Char:
+                if (*sp == pc[1]) {
+                    addthread(&vm, nlist, pc + 2, sp + 1, sub);
+                }
+                break;
+            case Any:
+                addthread(&vm, nlist, pc + 1, sp + 1, sub);
+                break;
+            case Class:
+            case ClassNot:
+                if (_re1_5_classmatch(pc + 1, sp)) {
+                    addthread(&vm, nlist, pc + 2 + *(unsigned char*)(pc + 1) * 2, sp + 1, sub);
+                }
+                break;
+            case NamedClass:
+                if (_re1_5_namedclassmatch(pc + 1, sp)) {
+                    addthread(&vm, nlist, pc + 2, sp + 1, sub);
+                }
+                break;
+            default:
+                re1_5_fatal("pikevm");
+            }
+        }
+
+        ThreadList *t = clist;
+        clist = nlist;
+        nlist = t;
+        if (sp >= input->end) {
+            break;
+        }
+    }
+
+    re1_5_free(mem, size);
+    return matched;
+}
@@ -82,5 +82,17 @@ recursiveloop(char *pc, const char *sp, Subject *input, const char **subp, int n
 int
 re1_5_recursiveloopprog(ByteProg *prog, Subject *input, const char **subp, int nsubp, int is_anchored)
 {
+	int lit = is_anchored ? -1 : re1_5_literalprefix(prog);
+	if(lit >= 0) {
+		// search by trying an anchored match at each occurrence of lit
+		const char *pc = HANDLE_ANCHORED(prog->insts, 1);
+		const char *sp = input->begin;
+		while((sp = memchr(sp, lit, input->end - sp)) != nil) {
+			if(recursiveloop((char*)pc, sp, input, subp, nsubp))
+				return 1;
+			sp++;
+		}
+		return 0;
+	}
 	return recursiveloop(HANDLE_ANCHORED(prog->insts, is_anchored), input->begin, input, subp, nsubp);
 }
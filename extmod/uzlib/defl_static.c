@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) uzlib authors
+ *
+ * This software is provided 'as-is', without any express
+ * or implied warranty.  In no event will the authors be
+ * held liable for any damages arising from the use of
+ * this software.
+ *
+ * Permission is granted to anyone to use this software
+ * for any purpose, including commercial applications,
+ * and to alter it and redistribute it freely, subject to
+ * the following restrictions:
+ *
+ * 1. The origin of this software must not be
+ *    misrepresented; you must not claim that you
+ *    wrote the original software. If you use this
+ *    software in a product, an acknowledgment in
+ *    the product documentation would be appreciated
+ *    but is not required.
+ *
+ * 2. Altered source versions must be plainly marked
+ *    as such, and must not be misrepresented as
+ *    being the original software.
+ *
+ * 3. This notice may not be removed or altered from
+ *    any source distribution.
+ */
+
+/* Encoder for DEFLATE blocks using the static Huffman codes (BTYPE=01),
+   which needs no tables of its own beyond the length and distance bases
+   shared with the decoder in tinflate.c. */
+
+#include "tinf.h"
+
+extern const unsigned char length_bits[30];
+extern const unsigned short length_base[30];
+extern const unsigned char dist_bits[30];
+extern const unsigned short dist_base[30];
+
+/* Huffman codes are sent most-significant bit first, while everything else
+   is sent least-significant bit first, so codes are reversed before sending */
+static unsigned int mirror_bits(unsigned int code, int nbits)
+{
+    unsigned int r = 0;
+    while (nbits--) {
+        r = (r << 1) | (code & 1);
+        code >>= 1;
+    }
+    return r;
+}
+
+void outbits(struct Outbuf *out, unsigned long bits, int nbits)
+{
+    out->outbits |= bits << out->noutbits;
+    out->noutbits += nbits;
+    while (out->noutbits >= 8) {
+        if (out->outlen >= out->outsize) {
+            out->flush(out);
+        }
+        out->outbuf[out->outlen++] = (unsigned char)out->outbits;
+        out->outbits >>= 8;
+        out->noutbits -= 8;
+    }
+}
+
+void zlib_start_block(struct Outbuf *out)
+{
+    /* BFINAL=0, BTYPE=01 */
+    outbits(out, 2, 3);
+}
+
+void zlib_finish_block(struct Outbuf *out)
+{
+    /* the end-of-block symbol 256 has the 7-bit code 0 */
+    outbits(out, 0, 7);
+}
+
+void zlib_literal(struct Outbuf *out, unsigned char c)
+{
+    if (c <= 143) {
+        /* 0x30 - 0xbf, 8 bits */
+        outbits(out, mirror_bits(0x30 + c, 8), 8);
+    } else {
+        /* 0x190 - 0x1ff, 9 bits */
+        outbits(out, mirror_bits(0x190 - 144 + c, 9), 9);
+    }
+}
+
+/* find the code i with base[i] <= val < base[i + 1] */
+static int find_code(const unsigned short *base, int n, int val)
+{
+    int lo = 0;
+    while (n > 1) {
+        int half = n / 2;
+        if (base[lo + half] <= val) {
+            lo += half;
+            n -= half;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+void zlib_match(struct Outbuf *out, int distance, int len)
+{
+    /* 3 <= len <= 258, 1 <= distance <= 32768 */
+    int code = find_code(length_base, 29, len);
+    int sym = 257 + code;
+    if (sym <= 279) {
+        /* 7 bits */
+        outbits(out, mirror_bits(sym - 256, 7), 7);
+    } else {
+        /* 0xc0 - 0xc7, 8 bits */
+        outbits(out, mirror_bits(0xc0 - 280 + sym, 8), 8);
+    }
+    if (length_bits[code]) {
+        outbits(out, len - length_base[code], length_bits[code]);
+    }
+
+    code = find_code(dist_base, 30, distance);
+    outbits(out, mirror_bits(code, 5), 5);
+    if (dist_bits[code]) {
+        outbits(out, distance - dist_base[code], dist_bits[code]);
+    }
+}
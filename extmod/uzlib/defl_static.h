@@ -35,7 +35,9 @@ struct Outbuf {
     int outlen, outsize;
     unsigned long outbits;
     int noutbits;
-    int comp_disabled;
+    /* Called when outbuf is full, it must make room in outbuf by either
+       growing it or consuming some of the data. */
+    void (*flush)(struct Outbuf *out);
 };
 
 void outbits(struct Outbuf *out, unsigned long bits, int nbits);
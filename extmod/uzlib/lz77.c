@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) uzlib authors
+ *
+ * This software is provided 'as-is', without any express
+ * or implied warranty.  In no event will the authors be
+ * held liable for any damages arising from the use of
+ * this software.
+ *
+ * Permission is granted to anyone to use this software
+ * for any purpose, including commercial applications,
+ * and to alter it and redistribute it freely, subject to
+ * the following restrictions:
+ *
+ * 1. The origin of this software must not be
+ *    misrepresented; you must not claim that you
+ *    wrote the original software. If you use this
+ *    software in a product, an acknowledgment in
+ *    the product documentation would be appreciated
+ *    but is not required.
+ *
+ * 2. Altered source versions must be plainly marked
+ *    as such, and must not be misrepresented as
+ *    being the original software.
+ *
+ * 3. This notice may not be removed or altered from
+ *    any source distribution.
+ */
+
+/* LZ77 matcher for the DEFLATE encoder.  Input is buffered in a window
+   holding up to dict_size bytes of history, and each position is linked
+   into a chain of earlier positions with the same hash of its first 3
+   bytes.  Chain entries are 16-bit positions so the memory needed is
+   2 * dict_size + 2 << hash_bits bytes plus the window itself, and the
+   number of entries tried for each position is bounded by max_chain. */
+
+#include <string.h>
+#include "tinf.h"
+
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+
+/* a match of MIN_MATCH bytes further back than this costs more bits than
+   the literals it replaces */
+#define TOO_FAR 4096
+
+static inline unsigned int hash3(const struct uzlib_comp *c, const uint8_t *p)
+{
+    uint32_t v = p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16);
+    return (v * 2654435761u) >> (32 - c->hash_bits);
+}
+
+/* link window position p into its hash chain, returning the previous head */
+static inline unsigned int insert(struct uzlib_comp *c, unsigned int p)
+{
+    unsigned int h = hash3(c, c->window + p);
+    uint16_t pos = (uint16_t)(c->win_start + p);
+    unsigned int head = c->hash_table[h];
+    c->prev[pos & (c->dict_size - 1)] = head;
+    c->hash_table[h] = pos;
+    return head;
+}
+
+/* find the longest match for window position p longer than best, walking
+   the chain from cand; returns its length, or best if there is none */
+static unsigned int longest_match(struct uzlib_comp *c, unsigned int p, unsigned int cand, unsigned int best, unsigned int *dist_out)
+{
+    const uint8_t *s = c->window + p;
+    uint16_t pos = (uint16_t)(c->win_start + p);
+    unsigned int max_len = c->win_len - p;
+    unsigned int max_dist = p < c->dict_size ? p : c->dict_size;
+    unsigned int last_dist = 0;
+    unsigned int chain = c->max_chain;
+
+    if (max_len > MAX_MATCH) {
+        max_len = MAX_MATCH;
+    }
+    if (best >= max_len) {
+        return best;
+    }
+
+    while (chain--) {
+        /* entries get strictly further away along a valid chain, anything
+           else is a stale entry from a position that has left the window */
+        unsigned int dist = (uint16_t)(pos - cand);
+        if (dist <= last_dist || dist > max_dist) {
+            break;
+        }
+        const uint8_t *m = s - dist;
+        if (m[best] == s[best] && m[0] == s[0] && m[1] == s[1]) {
+            unsigned int len = 2;
+            while (len < max_len && m[len] == s[len]) {
+                len++;
+            }
+            if (len > best) {
+                best = len;
+                *dist_out = dist;
+                if (len >= max_len) {
+                    break;
+                }
+            }
+        }
+        last_dist = dist;
+        cand = c->prev[cand & (c->dict_size - 1)];
+    }
+
+    return best;
+}
+
+/* encode window positions while there is enough lookahead to find the
+   longest match, or all of them if flushing */
+static void deflate_window(struct uzlib_comp *c, int flush)
+{
+    unsigned int limit = c->win_len;
+    if (!flush) {
+        if (limit < MAX_MATCH) {
+            return;
+        }
+        limit -= MAX_MATCH;
+    }
+
+    while (c->win_pos < limit) {
+        unsigned int p = c->win_pos;
+        unsigned int len = MIN_MATCH - 1;
+        unsigned int dist = 0;
+
+        if (p + MIN_MATCH <= c->win_len) {
+            unsigned int cand = insert(c, p);
+            len = longest_match(c, p, cand, MIN_MATCH - 1, &dist);
+            if (len == MIN_MATCH && dist > TOO_FAR) {
+                len = MIN_MATCH - 1;
+            }
+        }
+
+        if (c->match_avail && c->prev_len >= MIN_MATCH && len <= c->prev_len) {
+            /* the match at p - 1 is at least as good, take it */
+            unsigned int end = p - 1 + c->prev_len;
+            zlib_match(&c->out, c->prev_dist, c->prev_len);
+            for (p++; p < end && p + MIN_MATCH <= c->win_len; p++) {
+                insert(c, p);
+            }
+            c->win_pos = end;
+            c->match_avail = 0;
+        } else {
+            if (c->match_avail) {
+                zlib_literal(&c->out, c->window[p - 1]);
+            }
+            c->prev_len = len;
+            c->prev_dist = dist;
+            c->match_avail = 1;
+            c->win_pos = p + 1;
+        }
+    }
+
+    if (flush && c->match_avail) {
+        zlib_literal(&c->out, c->window[c->win_pos - 1]);
+        c->match_avail = 0;
+    }
+}
+
+void uzlib_compress_init(struct uzlib_comp *c, uint8_t *window, uint16_t *hash_table, uint16_t *prev, unsigned int dict_bits, unsigned int hash_bits)
+{
+    c->window = window;
+    c->hash_table = hash_table;
+    c->prev = prev;
+    c->hash_bits = hash_bits;
+    c->dict_size = 1 << dict_bits;
+    c->max_chain = 32;
+    c->win_start = 0;
+    c->win_pos = 0;
+    c->win_len = 0;
+    c->prev_len = 0;
+    c->prev_dist = 0;
+    c->match_avail = 0;
+    memset(hash_table, 0, sizeof(uint16_t) << hash_bits);
+    memset(prev, 0, sizeof(uint16_t) << dict_bits);
+}
+
+void uzlib_compress(struct uzlib_comp *c, const uint8_t *src, unsigned slen)
+{
+    unsigned int window_size = UZLIB_COMP_WINDOW_SIZE(c->dict_size);
+
+    while (slen) {
+        if (c->win_len == window_size) {
+            /* keep dict_size bytes of history before the next byte to encode */
+            unsigned int shift = c->win_pos - c->dict_size;
+            memmove(c->window, c->window + shift, c->win_len - shift);
+            c->win_start += shift;
+            c->win_pos -= shift;
+            c->win_len -= shift;
+        }
+        unsigned int n = window_size - c->win_len;
+        if (n > slen) {
+            n = slen;
+        }
+        memcpy(c->window + c->win_len, src, n);
+        c->win_len += n;
+        src += n;
+        slen -= n;
+        deflate_window(c, 0);
+    }
+}
+
+void uzlib_compress_flush(struct uzlib_comp *c, int final)
+{
+    deflate_window(c, 1);
+    zlib_finish_block(&c->out);
+    if (final) {
+        /* an empty final block, then pad to a byte boundary */
+        outbits(&c->out, 3, 3);
+        zlib_finish_block(&c->out);
+        outbits(&c->out, 0, (8 - c->out.noutbits) & 7);
+    } else {
+        /* an empty stored block aligns the output to a byte boundary and
+           its length fields are the 00 00 ff ff sync marker */
+        outbits(&c->out, 0, 3);
+        outbits(&c->out, 0, (8 - c->out.noutbits) & 7);
+        outbits(&c->out, 0, 16);
+        outbits(&c->out, 0xffff, 16);
+        zlib_start_block(&c->out);
+    }
+}
@@ -258,18 +258,19 @@ static int tinf_getbit(TINF_DATA *d)
 /* read a num bit value from a stream and add base */
 static unsigned int tinf_read_bits(TINF_DATA *d, int num, int base)
 {
-   unsigned int val = 0;
+   unsigned int val;
 
-   /* read num bits */
-   if (num)
+   /* load whole bytes until there are enough bits, least significant first */
+   while (d->bitcount < (unsigned int)num)
    {
-      unsigned int limit = 1 << (num);
-      unsigned int mask;
-
-      for (mask = 1; mask < limit; mask *= 2)
-         if (tinf_getbit(d)) val += mask;
+      d->tag |= (unsigned int)uzlib_get_byte(d) << d->bitcount;
+      d->bitcount += 8;
    }
 
+   val = d->tag & ((1u << num) - 1);
+   d->tag >>= num;
+   d->bitcount -= num;
+
    return val + base;
 }
 
@@ -302,6 +303,74 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
    return t->trans[sum];
 }
 
+#if UZLIB_CONF_FAST_BITS
+/* build the lookup table for the codes of the length/symbol tree which are
+   at most UZLIB_CONF_FAST_BITS long */
+static void tinf_build_fast_table(TINF_DATA *d, TINF_TREE *t)
+{
+   unsigned int len, i, k, code = 0, idx = 0;
+
+   for (i = 0; i < TINF_ARRAY_SIZE(d->lfast); ++i) d->lfast[i] = 0;
+
+   /* codes of each length are consecutive, in the order of trans */
+   for (len = 1; len <= UZLIB_CONF_FAST_BITS; ++len)
+   {
+      for (i = 0; i < t->table[len]; ++i, ++code, ++idx)
+      {
+         /* codes are stored most significant bit first */
+         unsigned int rev = 0, c = code;
+         for (k = 0; k < len; ++k)
+         {
+            rev = (rev << 1) | (c & 1);
+            c >>= 1;
+         }
+         /* fill every entry whose low bits are this code */
+         for (k = rev; k < TINF_ARRAY_SIZE(d->lfast); k += 1 << len)
+            d->lfast[k] = (len << 9) | t->trans[idx];
+      }
+      code <<= 1;
+   }
+}
+#endif
+
+/* decode a symbol from the length/symbol tree, using the lookup table if
+   enough input is buffered to peek at the next UZLIB_CONF_FAST_BITS bits */
+static int tinf_decode_lsym(TINF_DATA *d, TINF_TREE *lt)
+{
+#if UZLIB_CONF_FAST_BITS
+   const unsigned char *s = d->source;
+   unsigned int bits = d->tag, n = d->bitcount;
+
+   while (n < UZLIB_CONF_FAST_BITS && s < d->source_limit)
+   {
+      bits |= (unsigned int)*s++ << n;
+      n += 8;
+   }
+
+   if (n >= UZLIB_CONF_FAST_BITS)
+   {
+      unsigned int e = d->lfast[bits & ((1 << UZLIB_CONF_FAST_BITS) - 1)];
+      if (e)
+      {
+         n -= e >> 9;
+         bits >>= e >> 9;
+         /* put back any whole bytes which weren't needed */
+         while (n >= 8)
+         {
+            --s;
+            n -= 8;
+         }
+         d->source = s;
+         d->tag = bits & ((1u << n) - 1);
+         d->bitcount = n;
+         return e & 0x1ff;
+      }
+   }
+#endif
+
+   return tinf_decode_symbol(d, lt);
+}
+
 /* given a data stream, decode dynamic trees from it */
 static int tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 {
@@ -394,6 +463,9 @@ static int tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
    /* build dynamic trees */
    tinf_build_tree(lt, lengths, hlit);
    tinf_build_tree(dt, lengths + hlit, hdist);
+   #if UZLIB_CONF_FAST_BITS
+   tinf_build_fast_table(d, lt);
+   #endif
 
    return TINF_OK;
 }
@@ -402,90 +474,115 @@ static int tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
  * -- block inflate functions -- *
  * ----------------------------- */
 
-/* given a stream and two trees, inflate next byte of output */
+/* given a stream and two trees, inflate output until the end of the block
+   or of the output buffer */
 static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 {
-    if (d->curlen == 0) {
-        unsigned int offs;
-        int dist;
-        int sym = tinf_decode_symbol(d, lt);
-        //printf("huff sym: %02x\n", sym);
-
-        if (d->eof) {
-            return TINF_DATA_ERROR;
-        }
+    while (d->dest < d->dest_limit) {
+        if (d->curlen == 0) {
+            unsigned int offs;
+            int dist;
+            int sym = tinf_decode_lsym(d, lt);
+            //printf("huff sym: %02x\n", sym);
+
+            if (d->eof) {
+                return TINF_DATA_ERROR;
+            }
 
-        /* literal byte */
-        if (sym < 256) {
-            TINF_PUT(d, sym);
-            return TINF_OK;
-        }
+            /* literal byte */
+            if (sym < 256) {
+                TINF_PUT(d, sym);
+                continue;
+            }
 
-        /* end of block */
-        if (sym == 256) {
-            return TINF_DONE;
-        }
+            /* end of block */
+            if (sym == 256) {
+                return TINF_DONE;
+            }
 
-        /* substring from sliding dictionary */
-        sym -= 257;
-        if (sym >= 29) {
-            return TINF_DATA_ERROR;
-        }
+            /* substring from sliding dictionary */
+            sym -= 257;
+            if (sym >= 29) {
+                return TINF_DATA_ERROR;
+            }
 
-        /* possibly get more bits from length code */
-        d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
+            /* possibly get more bits from length code */
+            d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
 
-        dist = tinf_decode_symbol(d, dt);
-        if (dist >= 30) {
-            return TINF_DATA_ERROR;
-        }
+            dist = tinf_decode_symbol(d, dt);
+            if (dist >= 30) {
+                return TINF_DATA_ERROR;
+            }
 
-        /* possibly get more bits from distance code */
-        offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
+            /* possibly get more bits from distance code */
+            offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
 
-        /* calculate and validate actual LZ offset to use */
-        if (d->dict_ring) {
-            if (offs > d->dict_size) {
-                return TINF_DICT_ERROR;
-            }
-            /* Note: unlike full-dest-in-memory case below, we don't
-               try to catch offset which points to not yet filled
-               part of the dictionary here. Doing so would require
-               keeping another variable to track "filled in" size
-               of the dictionary. Appearance of such an offset cannot
-               lead to accessing memory outside of the dictionary
-               buffer, and clients which don't want to leak unrelated
-               information, should explicitly initialize dictionary
-               buffer passed to uzlib. */
-
-            d->lzOff = d->dict_idx - offs;
-            if (d->lzOff < 0) {
-                d->lzOff += d->dict_size;
-            }
-        } else {
-            /* catch trying to point before the start of dest buffer */
-            if (offs > d->dest - d->destStart) {
-                return TINF_DATA_ERROR;
+            /* calculate and validate actual LZ offset to use */
+            if (d->dict_ring) {
+                if (offs > d->dict_size) {
+                    return TINF_DICT_ERROR;
+                }
+                /* Note: unlike full-dest-in-memory case below, we don't
+                   try to catch offset which points to not yet filled
+                   part of the dictionary here. Doing so would require
+                   keeping another variable to track "filled in" size
+                   of the dictionary. Appearance of such an offset cannot
+                   lead to accessing memory outside of the dictionary
+                   buffer, and clients which don't want to leak unrelated
+                   information, should explicitly initialize dictionary
+                   buffer passed to uzlib. */
+
+                d->lzOff = d->dict_idx - offs;
+                if (d->lzOff < 0) {
+                    d->lzOff += d->dict_size;
+                }
+            } else {
+                /* catch trying to point before the start of dest buffer */
+                if (offs > d->dest - d->destStart) {
+                    return TINF_DATA_ERROR;
+                }
+                d->lzOff = -offs;
             }
-            d->lzOff = -offs;
         }
-    }
 
-    /* copy next byte from dict substring */
-    if (d->dict_ring) {
-        TINF_PUT(d, d->dict_ring[d->lzOff]);
-        if ((unsigned)++d->lzOff == d->dict_size) {
-            d->lzOff = 0;
+        /* copy as much of the dict substring as fits in the output */
+        unsigned int n = d->dest_limit - d->dest;
+        if (n > d->curlen) {
+            n = d->curlen;
+        }
+        d->curlen -= n;
+        if (d->dict_ring) {
+            unsigned char *p = d->dest;
+            unsigned char *ring = d->dict_ring;
+            unsigned int idx = d->dict_idx, off = d->lzOff, size = d->dict_size;
+            do {
+                unsigned char c = ring[off];
+                *p++ = c;
+                ring[idx] = c;
+                if (++idx == size) {
+                    idx = 0;
+                }
+                if (++off == size) {
+                    off = 0;
+                }
+            } while (--n);
+            d->dest = p;
+            d->dict_idx = idx;
+            d->lzOff = off;
+        } else {
+            unsigned char *p = d->dest;
+            do {
+                *p = p[d->lzOff];
+                p++;
+            } while (--n);
+            d->dest = p;
         }
-    } else {
-        d->dest[0] = d->dest[d->lzOff];
-        d->dest++;
     }
-    d->curlen--;
     return TINF_OK;
 }
 
-/* inflate next byte from uncompressed block of data */
+/* inflate output from uncompressed block of data until the end of the block
+   or of the output buffer */
 static int tinf_inflate_uncompressed_block(TINF_DATA *d)
 {
     if (d->curlen == 0) {
@@ -505,15 +602,18 @@ static int tinf_inflate_uncompressed_block(TINF_DATA *d)
         d->curlen = length + 1;
 
         /* make sure we start next block on a byte boundary */
+        d->tag = 0;
         d->bitcount = 0;
     }
 
-    if (--d->curlen == 0) {
-        return TINF_DONE;
-    }
+    while (d->dest < d->dest_limit) {
+        if (--d->curlen == 0) {
+            return TINF_DONE;
+        }
 
-    unsigned char c = uzlib_get_byte(d);
-    TINF_PUT(d, c);
+        unsigned char c = uzlib_get_byte(d);
+        TINF_PUT(d, c);
+    }
     return TINF_OK;
 }
 
@@ -539,6 +639,7 @@ void uzlib_init(void)
 void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
 {
    d->eof = 0;
+   d->tag = 0;
    d->bitcount = 0;
    d->bfinal = 0;
    d->btype = -1;
@@ -569,6 +670,9 @@ next_blk:
             if (d->btype == 1) {
                 /* build fixed huffman trees */
                 tinf_build_fixed_trees(&d->ltree, &d->dtree);
+                #if UZLIB_CONF_FAST_BITS
+                tinf_build_fast_table(d, &d->ltree);
+                #endif
             } else if (d->btype == 2) {
                 /* decode trees from stream */
                 res = tinf_decode_trees(d, &d->ltree, &d->dtree);
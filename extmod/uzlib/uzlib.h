@@ -119,6 +119,11 @@ struct uzlib_uncomp {
 
     TINF_TREE ltree; /* dynamic length/symbol tree */
     TINF_TREE dtree; /* dynamic distance tree */
+    #if UZLIB_CONF_FAST_BITS
+    /* lookup table for the short codes of ltree, indexed by the next input
+       bits: symbol in the low 9 bits and code length above, 0 if longer */
+    unsigned short lfast[1 << UZLIB_CONF_FAST_BITS];
+    #endif
 };
 
 #include "tinf_compat.h"
@@ -143,17 +148,44 @@ int TINFCC uzlib_gzip_parse_header(TINF_DATA *d);
 
 /* Compression API */
 
-typedef const uint8_t *uzlib_hash_entry_t;
+/* Size of the window buffer for a given dictionary size: the history plus
+   room to buffer input ahead of the position being encoded */
+#define UZLIB_COMP_WINDOW_SIZE(dict_size) \
+    ((dict_size) + ((dict_size) > 1024 ? (dict_size) : 1024))
 
 struct uzlib_comp {
     struct Outbuf out;
 
-    uzlib_hash_entry_t *hash_table;
+    /* caller-provided memory, see uzlib_compress_init() */
+    uint8_t *window;
+    uint16_t *hash_table;
+    uint16_t *prev;
     unsigned int hash_bits;
     unsigned int dict_size;
+
+    /* maximum number of hash chain entries tried for each position */
+    unsigned int max_chain;
+
+    /* window[0] is at position win_start of the input, window[win_pos] is
+       the next byte to encode, window[win_len] is where new input goes */
+    unsigned int win_start;
+    unsigned int win_pos;
+    unsigned int win_len;
+
+    /* lazy matching: the match found at win_pos - 1, if match_avail */
+    unsigned int prev_len;
+    unsigned int prev_dist;
+    int match_avail;
 };
 
+/* window must have UZLIB_COMP_WINDOW_SIZE(1 << dict_bits) bytes, hash_table
+   1 << hash_bits entries and prev 1 << dict_bits entries; c->out must be set
+   up by the caller, who also writes any header and calls zlib_start_block() */
+void TINFCC uzlib_compress_init(struct uzlib_comp *c, uint8_t *window, uint16_t *hash_table, uint16_t *prev, unsigned int dict_bits, unsigned int hash_bits);
 void TINFCC uzlib_compress(struct uzlib_comp *c, const uint8_t *src, unsigned slen);
+/* encode all buffered input; if final is zero end with a sync flush, so the
+   output so far is byte-aligned and decodable, otherwise end the stream */
+void TINFCC uzlib_compress_flush(struct uzlib_comp *c, int final);
 
 /* Checksum API */
 
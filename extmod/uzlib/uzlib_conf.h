@@ -19,4 +19,17 @@
 #define UZLIB_CONF_PARANOID_CHECKS 0
 #endif
 
+#ifndef UZLIB_CONF_FAST_BITS
+/* Decode literal/length codes of up to this many bits with a lookup
+   table, which takes 2 << UZLIB_CONF_FAST_BITS bytes in each decompressor.
+   0 disables the table and decodes every code bit by bit. */
+#define UZLIB_CONF_FAST_BITS 9
+#endif
+
+#ifndef UZLIB_CONF_CRC32_SLICE4
+/* Compute CRC32 4 bytes at a time using 4KB of tables, instead of a nibble
+   at a time using a 64 byte table. */
+#define UZLIB_CONF_CRC32_SLICE4 0
+#endif
+
 #endif /* UZLIB_CONF_H_INCLUDED */
@@ -11,6 +11,7 @@
 #include "py/mphal.h"
 #include "lib/utils/pyexec.h"
 #include "lib/mp-readline/readline.h"
+#include "lib/utils/gchelper.h"
 #include "extmod/vfs_fat.h"
 
 #include "mp_defs.h"
@@ -113,8 +114,13 @@ soft_reset:
     gc_init(heap, heap + sizeof(heap));
 #endif
 
+#if MICROPY_EMIT_THUMB || MICROPY_EMIT_INLINE_THUMB
+    gr55xx_native_code_init();
+#endif
+
 #if MICROPY_ENABLE_PYSTACK
-    static mp_obj_t pystack[512];
+    // sized for typical call depths, deeper calls grow the pystack into the heap
+    static mp_obj_t pystack[256];
     mp_pystack_init(pystack, &pystack[MP_ARRAY_SIZE(pystack)]);
 #endif
 
@@ -181,11 +187,15 @@ soft_reset:
 
 
 void gc_collect(void) {
-    // WARNING: This gc_collect implementation doesn't try to get root
-    // pointers from CPU registers, and thus may function incorrectly.
-    void *dummy;
     gc_collect_start();
-    gc_collect_root(&dummy, ((mp_uint_t)stack_top - (mp_uint_t)&dummy) / sizeof(mp_uint_t));
+
+    // get the registers and the sp; native code keeps objects in r4-r11
+    uintptr_t regs[10];
+    uintptr_t sp = gc_helper_get_regs_and_sp(regs);
+
+    // trace the stack, including the registers (since they live on the stack in this function)
+    gc_collect_root((void**)sp, ((mp_uint_t)stack_top - sp) / sizeof(mp_uint_t));
+
     gc_collect_end();
     gc_dump_info();
 }
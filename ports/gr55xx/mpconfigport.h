@@ -11,6 +11,7 @@
 #define MICROPY_MEM_STATS                   (1)
 #define MICROPY_STACK_CHECK                 (1)
 #define MICROPY_ENABLE_PYSTACK              (1)
+#define MICROPY_PYSTACK_GROW                (1)
 #define MICROPY_PY_MICROPYTHON_MEM_INFO     (1)
 #define MICROPY_PY_MICROPYTHON_STACK_USE    (1)
 
@@ -105,12 +106,17 @@
 #define MICROPY_ALLOC_PATH_MAX              (256)
 #define MICROPY_ALLOC_PARSE_CHUNK_INIT      (16)
 #define MICROPY_EMIT_X64                    (0)
-#define MICROPY_EMIT_THUMB                  (0)
-#define MICROPY_EMIT_INLINE_THUMB           (0)
+#define MICROPY_EMIT_THUMB                  (1)
+#define MICROPY_EMIT_INLINE_THUMB           (1)
+#define MICROPY_EMIT_NATIVE_FLOAT           (1)
+#define MICROPY_PERSISTENT_CODE_LOAD        (1)
+#define MICROPY_PERSISTENT_CODE_SAVE        (MICROPY_VFS)
+#define MICROPY_PERSISTENT_CODE_CACHE       (MICROPY_VFS)
 #define MICROPY_COMP_MODULE_CONST           (0)
 #define MICROPY_COMP_CONST                  (0)
 #define MICROPY_COMP_DOUBLE_TUPLE_ASSIGN    (0)
 #define MICROPY_COMP_TRIPLE_TUPLE_ASSIGN    (0)
+#define MICROPY_COMP_STREAM                 (1)
 #define MICROPY_DEBUG_PRINTERS              (0)
 #define MICROPY_ENABLE_GC                   (1)
 #define MICROPY_GC_ALLOC_THRESHOLD          (0)
@@ -141,6 +147,16 @@ typedef long                                mp_off_t;
 
 
 #define MP_PLAT_PRINT_STRN(str, len)        mp_hal_stdout_tx_strn_cooked(str, len)
+
+// native code is moved out of the GC heap into a dedicated region of RAM
+#ifndef MICROPY_GR55XX_NATIVE_CODE_SIZE
+#define MICROPY_GR55XX_NATIVE_CODE_SIZE     (8*1024)
+#endif
+#if MICROPY_EMIT_THUMB || MICROPY_EMIT_INLINE_THUMB
+void gr55xx_native_code_init(void);
+void *gr55xx_native_code_commit(void *buf, size_t len);
+#define MP_PLAT_COMMIT_EXEC(buf, len)       gr55xx_native_code_commit(buf, len)
+#endif
 #define MP_STATE_PORT                       MP_STATE_VM
 #define MICROPY_PORT_ROOT_POINTERS          const char *readline_hist[8];
     
@@ -0,0 +1,65 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2020 The MicroPython project contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <string.h>
+
+#include "py/runtime.h"
+
+#include "mp_defs.h"
+
+#if MICROPY_EMIT_THUMB || MICROPY_EMIT_INLINE_THUMB
+
+// Machine code from the native emitters and from .mpy files is built on the GC
+// heap and then committed here, to a dedicated region of RAM.  This keeps long
+// lived code out of the heap (so it doesn't fragment it), and the copy on the
+// heap becomes garbage.  The region is reset on soft reset, when there are no
+// functions left that refer to it.  If the region is full the code is left on
+// the heap, which is also executable.
+
+STATIC uint32_t native_code_buf[MICROPY_GR55XX_NATIVE_CODE_SIZE / sizeof(uint32_t)];
+STATIC size_t native_code_cur;
+
+void gr55xx_native_code_init(void) {
+    native_code_cur = 0;
+}
+
+void *gr55xx_native_code_commit(void *buf, size_t len) {
+    len = (len + 3) & ~3;
+    if (native_code_cur + len > sizeof(native_code_buf)) {
+        return buf;
+    }
+
+    void *dest = (byte*)native_code_buf + native_code_cur;
+    memcpy(dest, buf, len);
+    native_code_cur += len;
+
+    // make sure the new code is visible to instruction fetches
+    __asm volatile ("dsb\n isb" : : : "memory");
+
+    return dest;
+}
+
+#endif
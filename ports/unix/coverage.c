@@ -1,5 +1,7 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include "py/obj.h"
 #include "py/objstr.h"
@@ -13,9 +15,29 @@
 #include "py/stream.h"
 #include "py/binary.h"
 #include "py/bc.h"
+#include "py/persistentcode.h"
 
 #if defined(MICROPY_UNIX_COVERAGE)
 
+#if MICROPY_READER_MAP_FILE
+// in-place .mpy file, from "mpy-cross -minplace -mcache-lookup-bc" of:
+//   def f(a, *, b=1):
+//       return a + b
+//   print('inplace', f(41), f(1, b=2), 'str', b'\x00\xff', 1 << 70)
+STATIC const byte inplace_mpy[] = {
+    0x4d, 0x05, 0x03, 0x1f, 0x00, 0x05, 0x0a, 0x69, 0x6e, 0x70, 0x6c, 0x61, 0x63, 0x65, 0x2e, 0x70,
+    0x79, 0x01, 0x62, 0x01, 0x66, 0x07, 0x69, 0x6e, 0x70, 0x6c, 0x61, 0x63, 0x65, 0x01, 0x61, 0x42,
+    0x07, 0x00, 0x30, 0x00, 0x00, 0x00, 0x08, 0x07, 0x00, 0xa6, 0x00, 0x4e, 0x00, 0x00, 0xff, 0x18,
+    0x53, 0x00, 0x81, 0x16, 0xa7, 0x00, 0x54, 0x61, 0x02, 0x24, 0xa8, 0x00, 0x1b, 0x7b, 0x00, 0x00,
+    0x16, 0xa9, 0x00, 0x1b, 0xa8, 0x00, 0x00, 0xa9, 0x64, 0x01, 0x1b, 0xa8, 0x00, 0x00, 0x81, 0x16,
+    0xa7, 0x00, 0x82, 0x64, 0x82, 0x01, 0x16, 0x97, 0x00, 0x17, 0x00, 0x17, 0x01, 0x64, 0x06, 0x32,
+    0x11, 0x5b, 0x02, 0x01, 0x62, 0x02, 0x00, 0xff, 0x00, 0x69, 0x16, 0x31, 0x31, 0x38, 0x30, 0x35,
+    0x39, 0x31, 0x36, 0x32, 0x30, 0x37, 0x31, 0x37, 0x34, 0x31, 0x31, 0x33, 0x30, 0x33, 0x34, 0x32,
+    0x34, 0x00, 0x13, 0x04, 0x00, 0x08, 0x01, 0x01, 0x00, 0x08, 0xa8, 0x00, 0xa6, 0x00, 0x21, 0x00,
+    0x00, 0xff, 0x2c, 0x01, 0xf1, 0x5b, 0x00, 0x00, 0x81, 0x2a, 0x81, 0x27,
+};
+#endif
+
 // stream testing object
 typedef struct _mp_obj_streamtest_t {
     mp_obj_base_t base;
@@ -390,6 +412,29 @@ STATIC mp_obj_t extra_coverage(void) {
         mp_printf(&mp_plat_print, "%d %d\n", ret, mp_obj_get_type(code_state->state[0]) == &mp_type_NotImplementedError);
     }
 
+    #if MICROPY_READER_MAP_FILE
+    // in-place .mpy from a mapped file
+    {
+        mp_printf(&mp_plat_print, "# in-place .mpy\n");
+
+        char filename[] = "/tmp/micropython-inplace-XXXXXX";
+        int fd = mkstemp(filename);
+        size_t len;
+        mp_printf(&mp_plat_print, "%d\n", mp_reader_map_file(filename, &len) == NULL); // empty
+        mp_printf(&mp_plat_print, "%d\n", write(fd, inplace_mpy, sizeof(inplace_mpy)) == sizeof(inplace_mpy));
+        close(fd);
+        const byte *buf = mp_reader_map_file(filename, &len);
+        unlink(filename);
+        mp_printf(&mp_plat_print, "%d %d\n", buf != NULL && buf != inplace_mpy, len == sizeof(inplace_mpy));
+        mp_printf(&mp_plat_print, "%d\n", mp_reader_map_file(filename, &len) == NULL); // missing
+
+        // the bytecode is executed from the mapping, which is kept
+        mp_raw_code_t *rc = mp_raw_code_load_inplace(buf, len);
+        mp_printf(&mp_plat_print, "%d\n", (const byte*)rc->fun_data > buf && (const byte*)rc->fun_data < buf + len);
+        mp_call_function_0(mp_make_function_from_raw_code(rc, MP_OBJ_NULL, MP_OBJ_NULL));
+    }
+    #endif
+
     // scheduler
     {
         mp_printf(&mp_plat_print, "# scheduler\n");
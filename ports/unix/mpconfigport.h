@@ -28,9 +28,13 @@
 
 #define MICROPY_ALLOC_PATH_MAX      (PATH_MAX)
 #define MICROPY_PERSISTENT_CODE_LOAD (1)
+#define MICROPY_PERSISTENT_CODE_LOAD_INPLACE (1)
 #if !defined(MICROPY_EMIT_X64) && defined(__x86_64__)
     #define MICROPY_EMIT_X64        (1)
 #endif
+#if !defined(MICROPY_EMIT_NATIVE_FLOAT) && defined(__x86_64__)
+    #define MICROPY_EMIT_NATIVE_FLOAT (1)
+#endif
 #if !defined(MICROPY_EMIT_X86) && defined(__i386__)
     #define MICROPY_EMIT_X86        (1)
 #endif
@@ -70,6 +74,9 @@
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#define MICROPY_OPT_CACHE_TYPE_LOOKUP (1)
+#define MICROPY_OPT_MPZ_MUL         (1)
+#define MICROPY_OPT_FLOAT_TEMP (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_PY_FUNCTION_ATTRS   (1)
 #define MICROPY_PY_DESCRIPTORS      (1)
@@ -105,6 +112,7 @@
 #define MICROPY_PY_SYS_EXC_INFO     (1)
 #define MICROPY_PY_COLLECTIONS_DEQUE (1)
 #define MICROPY_PY_COLLECTIONS_ORDEREDDICT (1)
+#define MICROPY_PY_MAP_COMPACT      (1)
 #ifndef MICROPY_PY_MATH_SPECIAL_FUNCTIONS
 #define MICROPY_PY_MATH_SPECIAL_FUNCTIONS (1)
 #endif
@@ -126,10 +134,19 @@
 #define MICROPY_PY_UERRNO           (1)
 #define MICROPY_PY_UCTYPES          (1)
 #define MICROPY_PY_UZLIB            (1)
+#define MICROPY_PY_UZLIB_COMPRESS   (1)
+#define MICROPY_PY_UZLIB_DECOMPIO_BUF_SIZE (256)
+#define MICROPY_PY_UZLIB_WINDOW_POOL (2)
+#define MICROPY_PY_UZLIB_CRC32_SLICE4 (1)
 #define MICROPY_PY_UJSON            (1)
+#define MICROPY_PY_UJSON_QSTR_KEY_LEN (16)
+#define MICROPY_PY_UJSON_ITERLOAD   (1)
 #define MICROPY_PY_URE              (1)
+#define MICROPY_PY_URE_CACHE        (8)
+#define MICROPY_PY_URE_PIKEVM       (1)
 #define MICROPY_PY_UHEAPQ           (1)
 #define MICROPY_PY_UTIMEQ           (1)
+#define MICROPY_PY_UTIMEQ_WHEEL     (1)
 #define MICROPY_PY_UHASHLIB         (1)
 #if MICROPY_PY_USSL
 #define MICROPY_PY_UHASHLIB_MD5     (1)
@@ -74,8 +74,9 @@ STATIC void mp_thread_gc(int signo, siginfo_t *info, void *context) {
         // gc_collect_regs_and_stack function above
         //gc_collect_root((void**)context, sizeof(ucontext_t) / sizeof(uintptr_t));
         #if MICROPY_ENABLE_PYSTACK
-        void **ptrs = (void**)(void*)MP_STATE_THREAD(pystack_start);
-        gc_collect_root(ptrs, (MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start)) / sizeof(void*));
+        size_t len;
+        void **ptrs = mp_pystack_roots(&len);
+        gc_collect_root(ptrs, len);
         #endif
         #if defined (__APPLE__)
         sem_post(thread_signal_done_p);
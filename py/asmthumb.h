@@ -98,6 +98,34 @@ void asm_thumb_op32(asm_thumb_t *as, uint op1, uint op2);
 static inline void asm_thumb_it_cc(asm_thumb_t *as, uint cc, uint mask)
     { asm_thumb_op16(as, ASM_THUMB_OP_IT | (cc << 4) | mask); }
 
+// VFP single-precision instructions (needs an FPU, eg Cortex-M4F)
+
+#define ASM_THUMB_VFP_OP_MUL (0xee200a00)
+#define ASM_THUMB_VFP_OP_ADD (0xee300a00)
+#define ASM_THUMB_VFP_OP_SUB (0xee300a40)
+#define ASM_THUMB_VFP_OP_DIV (0xee800a00)
+#define ASM_THUMB_VFP_OP_CMP (0xeeb40a40)
+#define ASM_THUMB_VFP_OP_CVT_F32_S32 (0xeeb80ac0)
+#define ASM_THUMB_VFP_OP_CVT_S32_F32 (0xeebd0ac0) // rounds towards zero
+
+// sd = sn <op> sm
+static inline void asm_thumb_vfp_op_s_s_s(asm_thumb_t *as, uint32_t op, uint sd, uint sn, uint sm) {
+    asm_thumb_op32(as, (op >> 16) | (sd & 1) << 6 | sn >> 1,
+        (op & 0xffff) | (sd & 0x1e) << 11 | (sn & 1) << 7 | (sm & 1) << 5 | sm >> 1);
+}
+// sd = <op> sm, or compare sd with sm
+static inline void asm_thumb_vfp_op_s_s(asm_thumb_t *as, uint32_t op, uint sd, uint sm) {
+    asm_thumb_op32(as, (op >> 16) | (sd & 1) << 6,
+        (op & 0xffff) | (sd & 0x1e) << 11 | (sm & 1) << 5 | sm >> 1);
+}
+static inline void asm_thumb_vmov_s_reg(asm_thumb_t *as, uint sd, uint r_src)
+    { asm_thumb_op32(as, 0xee00 | sd >> 1, 0x0a10 | r_src << 12 | (sd & 1) << 7); }
+static inline void asm_thumb_vmov_reg_s(asm_thumb_t *as, uint r_dest, uint sn)
+    { asm_thumb_op32(as, 0xee10 | sn >> 1, 0x0a10 | r_dest << 12 | (sn & 1) << 7); }
+// copy the FPU condition flags to APSR
+static inline void asm_thumb_vmrs_apsr_fpscr(asm_thumb_t *as)
+    { asm_thumb_op32(as, 0xeef1, 0xfa10); }
+
 // FORMAT 1: move shifted register
 
 #define ASM_THUMB_FORMAT_1_LSL (0x0000)
@@ -85,6 +85,12 @@
 #define OPCODE_CALL_REL32        (0xe8)
 #define OPCODE_CALL_RM32         (0xff) /* /2 */
 #define OPCODE_LEAVE             (0xc9)
+#define OPCODE_NEG_RM64          (0xf7) /* /3 */
+#define OPCODE_MOVQ_RM64_TO_XMM  (0x6e) /* 0x66 0x0f 0x6e/r */
+#define OPCODE_MOVQ_XMM_TO_RM64  (0x7e) /* 0x66 0x0f 0x7e/r */
+#define OPCODE_CVTSI2S_RM64_TO_XMM (0x2a) /* 0xf2/0xf3 0x0f 0x2a/r */
+#define OPCODE_CVTTS2SI_XMM_TO_R64 (0x2c) /* 0xf2/0xf3 0x0f 0x2c/r */
+#define OPCODE_CMPS_XMM_WITH_XMM (0xc2) /* 0xf2/0xf3 0x0f 0xc2/r ib */
 
 #define MODRM_R64(x)    (((x) & 0x7) << 3)
 #define MODRM_RM_DISP0  (0x00)
@@ -94,6 +100,8 @@
 #define MODRM_RM_R64(x) ((x) & 0x7)
 
 #define OP_SIZE_PREFIX (0x66)
+#define SSE_PREFIX_SD  (0xf2)
+#define SSE_PREFIX_SS  (0xf3)
 
 #define REX_PREFIX  (0x40)
 #define REX_W       (0x08)  // width
@@ -400,6 +408,48 @@ void asm_x64_mul_r64_r64(asm_x64_t *as, int dest_r64, int src_r64) {
     asm_x64_write_byte_3(as, 0x0f, 0xaf, MODRM_R64(dest_r64) | MODRM_RM_REG | MODRM_RM_R64(src_r64));
 }
 
+void asm_x64_neg_r64(asm_x64_t *as, int dest_r64) {
+    asm_x64_generic_r64_r64(as, dest_r64, 3, OPCODE_NEG_RM64);
+}
+
+// Encodes an SSE instruction with a mandatory prefix, and a ModRM byte with
+// register operands (either of which may be an xmm register).
+STATIC void asm_x64_sse_generic(asm_x64_t *as, byte prefix, bool rex_w, byte op, int reg, int rm) {
+    uint8_t rex = (rex_w ? REX_W : 0) | REX_R_FROM_R64(reg) | REX_B_FROM_R64(rm);
+    asm_x64_write_byte_1(as, prefix);
+    if (rex != 0) {
+        asm_x64_write_byte_1(as, REX_PREFIX | rex);
+    }
+    asm_x64_write_byte_3(as, 0x0f, op, MODRM_R64(reg) | MODRM_RM_REG | MODRM_RM_R64(rm));
+}
+
+void asm_x64_mov_r64_to_xmm(asm_x64_t *as, int dest_xmm, int src_r64, bool is_64) {
+    // movq xmm, r64 (or movd xmm, r32)
+    asm_x64_sse_generic(as, OP_SIZE_PREFIX, is_64, OPCODE_MOVQ_RM64_TO_XMM, dest_xmm, src_r64);
+}
+
+void asm_x64_mov_xmm_to_r64(asm_x64_t *as, int dest_r64, int src_xmm, bool is_64) {
+    // movq r64, xmm (or movd r32, xmm, which zero extends)
+    asm_x64_sse_generic(as, OP_SIZE_PREFIX, is_64, OPCODE_MOVQ_XMM_TO_RM64, src_xmm, dest_r64);
+}
+
+void asm_x64_sse_op_xmm_xmm(asm_x64_t *as, int op, int dest_xmm, int src_xmm, bool is_double) {
+    asm_x64_sse_generic(as, is_double ? SSE_PREFIX_SD : SSE_PREFIX_SS, false, op, dest_xmm, src_xmm);
+}
+
+void asm_x64_sse_cmp_xmm_xmm(asm_x64_t *as, int pred, int dest_xmm, int src_xmm, bool is_double) {
+    asm_x64_sse_op_xmm_xmm(as, OPCODE_CMPS_XMM_WITH_XMM, dest_xmm, src_xmm, is_double);
+    asm_x64_write_byte_1(as, pred);
+}
+
+void asm_x64_cvtsi2s_r64_to_xmm(asm_x64_t *as, int dest_xmm, int src_r64, bool is_double) {
+    asm_x64_sse_generic(as, is_double ? SSE_PREFIX_SD : SSE_PREFIX_SS, true, OPCODE_CVTSI2S_RM64_TO_XMM, dest_xmm, src_r64);
+}
+
+void asm_x64_cvtts2si_xmm_to_r64(asm_x64_t *as, int dest_r64, int src_xmm, bool is_double) {
+    asm_x64_sse_generic(as, is_double ? SSE_PREFIX_SD : SSE_PREFIX_SS, true, OPCODE_CVTTS2SI_XMM_TO_R64, dest_r64, src_xmm);
+}
+
 /*
 void asm_x64_sub_i32_from_r32(asm_x64_t *as, int src_i32, int dest_r32) {
     if (SIGNED_FIT8(src_i32)) {
@@ -70,6 +70,23 @@
 #define ASM_X64_CC_JLE (0xe) // less or equal, signed
 #define ASM_X64_CC_JG  (0xf) // greater, signed
 
+// xmm registers, used for scalar floating-point arithmetic
+#define ASM_X64_REG_XMM0 (0)
+#define ASM_X64_REG_XMM1 (1)
+
+// scalar SSE ops, used for asm_x64_sse_op_xmm_xmm
+#define ASM_X64_SSE_OP_ADD (0x58)
+#define ASM_X64_SSE_OP_MUL (0x59)
+#define ASM_X64_SSE_OP_CVT (0x5a) // convert to the other precision
+#define ASM_X64_SSE_OP_SUB (0x5c)
+#define ASM_X64_SSE_OP_DIV (0x5e)
+
+// predicates for asm_x64_sse_cmp_xmm_xmm, which set dest to all ones if true
+#define ASM_X64_SSE_CMP_EQ  (0)
+#define ASM_X64_SSE_CMP_LT  (1)
+#define ASM_X64_SSE_CMP_LE  (2)
+#define ASM_X64_SSE_CMP_NEQ (4)
+
 typedef struct _asm_x64_t {
     mp_asm_base_t base;
     int num_locals;
@@ -102,6 +119,13 @@ void asm_x64_sar_r64_cl(asm_x64_t* as, int dest_r64);
 void asm_x64_add_r64_r64(asm_x64_t* as, int dest_r64, int src_r64);
 void asm_x64_sub_r64_r64(asm_x64_t* as, int dest_r64, int src_r64);
 void asm_x64_mul_r64_r64(asm_x64_t* as, int dest_r64, int src_r64);
+void asm_x64_neg_r64(asm_x64_t *as, int dest_r64);
+void asm_x64_mov_r64_to_xmm(asm_x64_t *as, int dest_xmm, int src_r64, bool is_64);
+void asm_x64_mov_xmm_to_r64(asm_x64_t *as, int dest_r64, int src_xmm, bool is_64);
+void asm_x64_sse_op_xmm_xmm(asm_x64_t *as, int op, int dest_xmm, int src_xmm, bool is_double);
+void asm_x64_sse_cmp_xmm_xmm(asm_x64_t *as, int pred, int dest_xmm, int src_xmm, bool is_double);
+void asm_x64_cvtsi2s_r64_to_xmm(asm_x64_t *as, int dest_xmm, int src_r64, bool is_double);
+void asm_x64_cvtts2si_xmm_to_r64(asm_x64_t *as, int dest_r64, int src_xmm, bool is_double);
 void asm_x64_cmp_r64_with_r64(asm_x64_t* as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r8_with_r8(asm_x64_t* as, int src_r64_a, int src_r64_b);
 void asm_x64_test_r64_with_r64(asm_x64_t *as, int src_r64_a, int src_r64_b);
@@ -292,11 +292,17 @@ continue2:;
 #if MICROPY_PERSISTENT_CODE_LOAD || MICROPY_PERSISTENT_CODE_SAVE
 
 // The following table encodes the number of bytes that a specific opcode
-// takes up.  There are 4 special opcodes that always have an extra byte:
+// takes up.  There are 10 special opcodes that always have an extra byte:
 //     MP_BC_UNWIND_JUMP
 //     MP_BC_MAKE_CLOSURE
 //     MP_BC_MAKE_CLOSURE_DEFARGS
 //     MP_BC_RAISE_VARARGS
+//     MP_BC_LOAD_FAST_LOAD_FAST
+//     MP_BC_BINARY_OP_SMALL_INT
+//     MP_BC_BINARY_OP_POP_JUMP_IF_TRUE
+//     MP_BC_BINARY_OP_POP_JUMP_IF_FALSE
+//     MP_BC_FOR_RANGE
+//     MP_BC_BINARY_OP_TEMP
 // There are 4 special opcodes that have an extra byte only when
 // MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE is enabled (and they take a qstr):
 //     MP_BC_LOAD_NAME
@@ -321,13 +327,13 @@ STATIC const byte opcode_format_table[64] = {
     OC4(B, B, V, V), // 0x20-0x23
     OC4(Q, Q, Q, B), // 0x24-0x27
     OC4(V, V, Q, Q), // 0x28-0x2b
-    OC4(U, U, U, U), // 0x2c-0x2f
+    OC4(B, B, V, V), // 0x2c-0x2f
     OC4(B, B, B, B), // 0x30-0x33
     OC4(B, O, O, O), // 0x34-0x37
-    OC4(O, O, U, U), // 0x38-0x3b
-    OC4(U, O, B, O), // 0x3c-0x3f
+    OC4(O, O, O, O), // 0x38-0x3b
+    OC4(O, O, B, O), // 0x3c-0x3f
     OC4(O, B, B, O), // 0x40-0x43
-    OC4(O, U, O, B), // 0x44-0x47
+    OC4(O, B, O, B), // 0x44-0x47
     OC4(U, U, U, U), // 0x48-0x4b
     OC4(U, U, U, U), // 0x4c-0x4f
     OC4(V, V, U, V), // 0x50-0x53
@@ -407,6 +413,12 @@ uint mp_opcode_format(const byte *ip, size_t *opcode_size, bool count_var_uint)
             || *ip == MP_BC_RAISE_VARARGS
             || *ip == MP_BC_MAKE_CLOSURE
             || *ip == MP_BC_MAKE_CLOSURE_DEFARGS
+            || *ip == MP_BC_LOAD_FAST_LOAD_FAST
+            || *ip == MP_BC_BINARY_OP_SMALL_INT
+            || *ip == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE
+            || *ip == MP_BC_BINARY_OP_POP_JUMP_IF_FALSE
+            || *ip == MP_BC_FOR_RANGE
+            || *ip == MP_BC_BINARY_OP_TEMP
         );
         ip += 1;
         if (f == MP_OPCODE_VAR_UINT) {
@@ -60,6 +60,15 @@
 //  const0          : obj
 //  constN          : obj
 
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+// Bytecode that is executed in place from a .mpy image can't have its qstrs
+// patched, so it refers to them by id instead: an id up to MP_QSTR_zip is a
+// static qstr (these are the same in every build) and a larger id indexes the
+// qstr table that was built when the image was loaded.
+#define MP_BC_INPLACE_QSTR(qstr_table, id) \
+    ((qstr_table) != NULL && (id) > MP_QSTR_zip ? (qstr)(qstr_table)[(id) - MP_QSTR_zip - 1] : (qstr)(id))
+#endif
+
 typedef struct _mp_bytecode_prelude_t {
     uint n_state;
     uint n_exc_stack;
@@ -59,6 +59,11 @@
 #define MP_BC_DELETE_NAME        (0x2a) // qstr
 #define MP_BC_DELETE_GLOBAL      (0x2b) // qstr
 
+#define MP_BC_LOAD_FAST_LOAD_FAST    (0x2c) // byte: local0 << 4 | local1
+#define MP_BC_BINARY_OP_SMALL_INT    (0x2d) // byte: op << 6 | (small int + 16)
+#define MP_BC_LOAD_FAST_ACCUM        (0x2e) // uint
+#define MP_BC_INPLACE_ADD_FAST       (0x2f) // uint
+
 #define MP_BC_DUP_TOP            (0x30)
 #define MP_BC_DUP_TOP_TWO        (0x31)
 #define MP_BC_POP_TOP            (0x32)
@@ -70,6 +75,9 @@
 #define MP_BC_POP_JUMP_IF_FALSE  (0x37) // rel byte code offset, 16-bit signed, in excess
 #define MP_BC_JUMP_IF_TRUE_OR_POP    (0x38) // rel byte code offset, 16-bit signed, in excess
 #define MP_BC_JUMP_IF_FALSE_OR_POP   (0x39) // rel byte code offset, 16-bit signed, in excess
+#define MP_BC_BINARY_OP_POP_JUMP_IF_TRUE  (0x3a) // rel byte code offset, 16-bit signed, in excess; then a byte
+#define MP_BC_BINARY_OP_POP_JUMP_IF_FALSE (0x3b) // rel byte code offset, 16-bit signed, in excess; then a byte
+#define MP_BC_FOR_RANGE          (0x3c) // rel byte code offset, 16-bit signed, in excess; then a signed byte
 #define MP_BC_SETUP_WITH         (0x3d) // rel byte code offset, 16-bit unsigned
 #define MP_BC_WITH_CLEANUP       (0x3e)
 #define MP_BC_SETUP_EXCEPT       (0x3f) // rel byte code offset, 16-bit unsigned
@@ -78,6 +86,7 @@
 #define MP_BC_GET_ITER           (0x42)
 #define MP_BC_FOR_ITER           (0x43) // rel byte code offset, 16-bit unsigned
 #define MP_BC_POP_EXCEPT_JUMP    (0x44) // rel byte code offset, 16-bit unsigned
+#define MP_BC_BINARY_OP_TEMP     (0x45) // byte: op | temp flags << 6
 #define MP_BC_UNWIND_JUMP        (0x46) // rel byte code offset, 16-bit signed, in excess; then a byte
 #define MP_BC_GET_ITER_STACK     (0x47)
 
@@ -115,4 +124,15 @@
 #define MP_BC_UNARY_OP_MULTI             (0xd0) // + op(<MP_UNARY_OP_NUM_BYTECODE)
 #define MP_BC_BINARY_OP_MULTI            (0xd7) // + op(<MP_BINARY_OP_NUM_BYTECODE)
 
+// The ops that MP_BC_BINARY_OP_SMALL_INT can encode in the top 2 bits of its argument
+#define MP_BC_BINARY_OP_SMALL_INT_ADD              (0)
+#define MP_BC_BINARY_OP_SMALL_INT_SUBTRACT         (1)
+#define MP_BC_BINARY_OP_SMALL_INT_INPLACE_ADD      (2)
+#define MP_BC_BINARY_OP_SMALL_INT_INPLACE_SUBTRACT (3)
+
+// The flags in the argument of MP_BC_BINARY_OP_TEMP, saying which operands
+// were pushed by another MP_BC_BINARY_OP_TEMP and are not referenced elsewhere
+#define MP_BC_BINARY_OP_TEMP_LHS (0x40)
+#define MP_BC_BINARY_OP_TEMP_RHS (0x80)
+
 #endif // MICROPY_INCLUDED_PY_BC0_H
@@ -36,6 +36,11 @@
 #include "py/builtin.h"
 #include "py/frozenmod.h"
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+#include "py/stream.h"
+#include "extmod/vfs.h"
+#endif
+
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_PRINT (1)
 #define DEBUG_printf DEBUG_printf
@@ -140,7 +145,11 @@ STATIC void do_load_from_lexer(mp_obj_t module_obj, mp_lexer_t *lex) {
 
     // parse, compile and execute the module in its context
     mp_obj_dict_t *mod_globals = mp_obj_module_get_globals(module_obj);
+    #if MICROPY_COMP_STREAM
+    mp_parse_compile_execute_stream(lex, mod_globals, mod_globals, false);
+    #else
     mp_parse_compile_execute(lex, MP_PARSE_FILE_INPUT, mod_globals, mod_globals);
+    #endif
 }
 #endif
 
@@ -181,6 +190,160 @@ STATIC void do_execute_raw_code(mp_obj_t module_obj, mp_raw_code_t *raw_code, co
 }
 #endif
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+
+// A .py file is cached as a .mpy file next to it.  The cache file is a normal
+// .mpy file followed by a trailer that records the size and mtime of the source
+// and the optimisation level it was compiled at, and it is only used if all of
+// these still match.  A file is only overwritten if it has such a trailer (or
+// can't be loaded), so that a .mpy file put there by the user is left alone.
+#define CACHE_TRAILER_LEN (12)
+#define CACHE_TRAILER_MAGIC "MPC"
+
+// Fill in the trailer that a valid cache file for the given source must have
+STATIC bool cache_make_trailer(const char *file_str, byte *trailer) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t *items;
+        mp_obj_get_array_fixed_n(mp_vfs_stat(mp_obj_new_str(file_str, strlen(file_str))), 10, &items);
+        mp_uint_t size = mp_obj_get_int_truncated(items[6]);
+        mp_uint_t mtime = mp_obj_get_int_truncated(items[8]);
+        nlr_pop();
+        for (int i = 0; i < 4; ++i) {
+            trailer[i] = size >> (8 * i);
+            trailer[4 + i] = mtime >> (8 * i);
+        }
+        trailer[8] = MP_STATE_VM(mp_optimise_value);
+        memcpy(trailer + 9, CACHE_TRAILER_MAGIC, 3);
+        return true;
+    } else {
+        // the filesystem can't tell us, so don't cache this file
+        return false;
+    }
+}
+
+// Load a .mpy image, returning NULL if it is invalid
+STATIC mp_raw_code_t *cache_load_mem(const byte *buf, size_t len) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_raw_code_t *raw_code = mp_raw_code_load_mem(buf, len);
+        nlr_pop();
+        return raw_code;
+    } else if (!mp_obj_is_subclass_fast(MP_OBJ_FROM_PTR(mp_obj_get_type(MP_OBJ_FROM_PTR(nlr.ret_val))),
+        MP_OBJ_FROM_PTR(&mp_type_ValueError))) {
+        // eg a MemoryError or KeyboardInterrupt, not an invalid file
+        nlr_jump(nlr.ret_val);
+    }
+    return NULL;
+}
+
+// Load the cache file, returning NULL if it doesn't exist or is out of date,
+// and setting *writable to whether it may be (re)written.  The whole file is
+// read first so that its size and trailer are checked before any of it is
+// parsed, because a write may have been interrupted.
+STATIC mp_raw_code_t *cache_load(const char *cache_str, const byte *trailer, bool *writable) {
+    if (mp_import_stat(cache_str) != MP_IMPORT_STAT_FILE) {
+        *writable = true;
+        return NULL;
+    }
+
+    mp_obj_t path = mp_obj_new_str(cache_str, strlen(cache_str));
+    mp_obj_t *items;
+    mp_obj_get_array_fixed_n(mp_vfs_stat(path), 10, &items);
+    size_t len = mp_obj_get_int_truncated(items[6]);
+    mp_obj_t args[2] = {path, MP_OBJ_NEW_QSTR(MP_QSTR_rb)};
+    mp_obj_t file = mp_vfs_open(MP_ARRAY_SIZE(args), args, (mp_map_t*)&mp_const_empty_map);
+    byte *buf = m_new(byte, len);
+    int errcode;
+    size_t n = mp_stream_read_exactly(file, buf, len, &errcode);
+    mp_stream_close(file);
+
+    mp_raw_code_t *raw_code = NULL;
+    if (errcode != 0 || n != len) {
+        // the file changed under us, leave it alone this time
+        *writable = false;
+    } else if (len >= CACHE_TRAILER_LEN && memcmp(buf + len - 3, CACHE_TRAILER_MAGIC, 3) == 0) {
+        // a cache file, which is only used if it is for this version of the source
+        *writable = true;
+        if (memcmp(buf + len - CACHE_TRAILER_LEN, trailer, CACHE_TRAILER_LEN) == 0) {
+            raw_code = cache_load_mem(buf, len - CACHE_TRAILER_LEN);
+        }
+    } else {
+        // a .mpy file from the user is never used, and only replaced if invalid
+        *writable = cache_load_mem(buf, len) == NULL;
+    }
+    m_del(byte, buf, len);
+    return raw_code;
+}
+
+// Write the cache to a temporary file which is then renamed into place, so
+// that an interrupted write never leaves a truncated cache file
+STATIC void cache_save(const char *cache_str, mp_raw_code_t *raw_code, const byte *trailer) {
+    vstr_t tmp;
+    vstr_init(&tmp, strlen(cache_str) + 5);
+    vstr_add_str(&tmp, cache_str);
+    vstr_add_str(&tmp, ".tmp");
+    mp_obj_t tmp_path = mp_obj_new_str(tmp.buf, tmp.len);
+    vstr_clear(&tmp);
+
+    mp_obj_t volatile file = MP_OBJ_NULL;
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_t args[2] = {tmp_path, MP_OBJ_NEW_QSTR(MP_QSTR_wb)};
+        file = mp_vfs_open(MP_ARRAY_SIZE(args), args, (mp_map_t*)&mp_const_empty_map);
+        mp_print_t print = {MP_OBJ_TO_PTR(file), mp_stream_write_adaptor};
+        mp_raw_code_save(raw_code, &print);
+        mp_stream_write(file, trailer, CACHE_TRAILER_LEN, MP_STREAM_RW_WRITE);
+        mp_obj_t f = file;
+        file = MP_OBJ_NULL;
+        mp_stream_close(f);
+        mp_vfs_rename(tmp_path, mp_obj_new_str(cache_str, strlen(cache_str)));
+        nlr_pop();
+    } else {
+        // the cache is best effort (eg the filesystem may be read-only or full)
+        // so ignore the error, and don't leave the temporary file behind
+        if (nlr_push(&nlr) == 0) {
+            if (file != MP_OBJ_NULL) {
+                mp_stream_close(file);
+            }
+            mp_vfs_remove(tmp_path);
+            nlr_pop();
+        }
+    }
+}
+
+STATIC void do_load_cached(mp_obj_t module_obj, const char *file_str, size_t len) {
+    byte trailer[CACHE_TRAILER_LEN];
+    if (!cache_make_trailer(file_str, trailer)) {
+        do_load_from_lexer(module_obj, mp_lexer_new_from_file(file_str));
+        return;
+    }
+
+    // the cache file is the source file with .py changed to .mpy
+    vstr_t cache;
+    vstr_init(&cache, len + 2);
+    vstr_add_strn(&cache, file_str, len);
+    vstr_ins_byte(&cache, len - 2, 'm');
+    const char *cache_str = vstr_null_terminated_str(&cache);
+
+    bool writable;
+    mp_raw_code_t *raw_code = cache_load(cache_str, trailer, &writable);
+    if (raw_code == NULL) {
+        mp_lexer_t *lex = mp_lexer_new_from_file(file_str);
+        qstr source_name = lex->source_name;
+        mp_parse_tree_t parse_tree = mp_parse(lex, MP_PARSE_FILE_INPUT);
+        raw_code = mp_compile_to_raw_code(&parse_tree, source_name, false);
+        if (writable) {
+            cache_save(cache_str, raw_code, trailer);
+        }
+    }
+    vstr_clear(&cache);
+
+    do_execute_raw_code(module_obj, raw_code, file_str);
+}
+
+#endif
+
 STATIC void do_load(mp_obj_t module_obj, vstr_t *file) {
     #if MICROPY_MODULE_FROZEN || MICROPY_ENABLE_COMPILER || (MICROPY_PERSISTENT_CODE_LOAD && MICROPY_HAS_FILE_READER)
     char *file_str = vstr_null_terminated_str(file);
@@ -221,6 +384,15 @@ STATIC void do_load(mp_obj_t module_obj, vstr_t *file) {
     }
     #endif
 
+    // If the import cache is enabled then load the code from the cache file,
+    // compiling it and writing the cache file first if needed.
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    if (MP_STATE_VM(mp_import_cache)) {
+        do_load_cached(module_obj, file_str, file->len);
+        return;
+    }
+    #endif
+
     // If we can compile scripts then load the file and compile and execute it.
     #if MICROPY_ENABLE_COMPILER
     {
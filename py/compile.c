@@ -172,6 +172,8 @@ typedef struct _compiler_t {
     uint16_t cur_except_level; // increased for SETUP_EXCEPT, SETUP_FINALLY; decreased for POP_BLOCK, POP_EXCEPT
     uint16_t break_continue_except_level;
 
+    uint8_t binary_op_temp; // the expression being compiled is an operand of a binary_op_temp
+
     scope_t *scope_head;
     scope_t *scope_cur;
 
@@ -205,6 +207,7 @@ STATIC void compile_trailer_paren_helper(compiler_t *comp, mp_parse_node_t pn_ar
 STATIC void compile_comprehension(compiler_t *comp, mp_parse_node_struct_t *pns, scope_kind_t kind);
 STATIC void compile_atom_brace_helper(compiler_t *comp, mp_parse_node_struct_t *pns, bool create_map);
 STATIC void compile_node(compiler_t *comp, mp_parse_node_t pn);
+STATIC mp_obj_t get_const_object(mp_parse_node_struct_t *pns);
 
 STATIC uint comp_next_label(compiler_t *comp) {
     return comp->next_label++;
@@ -281,6 +284,14 @@ STATIC void compile_load_id(compiler_t *comp, qstr qst) {
     if (comp->pass == MP_PASS_SCOPE) {
         mp_emit_common_get_id_for_load(comp->scope_cur, qst);
     } else {
+        if (SCOPE_IS_FUNC_LIKE(comp->scope_cur->kind)) {
+            id_info_t *id = scope_find(comp->scope_cur, qst);
+            if (id != NULL && id->kind == ID_INFO_KIND_LOCAL && (id->flags & ID_FLAG_IS_STR_ACCUM)) {
+                // see compile_inplace_add_fast
+                EMIT_ARG(load_fast_accum, id->local_num);
+                return;
+            }
+        }
         #if NEED_METHOD_TABLE
         mp_emit_common_id_op(comp->emit, &comp->emit_method_table->load_id, comp->scope_cur, qst);
         #else
@@ -1410,7 +1421,8 @@ STATIC void compile_while_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
 //          <body>
 //      else:
 //          <else>
-// <var> must be an identifier and <step> must be a small-int.
+// <var> can be any assignment target (an identifier for viper) and <step> must
+// be a small-int.
 //
 // Semantics of for-loop require:
 //  - final failing value should not be stored in the loop variable
@@ -1418,17 +1430,22 @@ STATIC void compile_while_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
 //  - assignments to <var>, <end> or <step> in the body do not alter the loop
 //    (<step> is a constant for us, so no need to worry about it changing)
 //
-// If <end> is a small-int, then the stack during the for-loop contains just
-// the current value of <var>.  Otherwise, the stack contains <end> then the
-// current value of <var>.
+// If <end> is a small-int and the emitter is native, then the stack during the
+// for-loop contains just the current value of <var>.  Otherwise, the stack
+// contains <end> then the current value of <var>, and the increment and test
+// at the end of each iteration is done by a single for_range.
 STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t pn_var, mp_parse_node_t pn_start, mp_parse_node_t pn_end, mp_parse_node_t pn_step, mp_parse_node_t pn_body, mp_parse_node_t pn_else) {
     START_BREAK_CONTINUE_BLOCK
 
     uint top_label = comp_next_label(comp);
     uint entry_label = comp_next_label(comp);
 
-    // put the end value on the stack if it's not a small-int constant
-    bool end_on_stack = !MP_PARSE_NODE_IS_SMALL_INT(pn_end);
+    // put the end value on the stack if it's not a small-int constant, or if
+    // emitting bytecode, where comparing against it on the stack is cheaper
+    // than reloading the constant on each iteration
+    bool end_on_stack = !MP_PARSE_NODE_IS_SMALL_INT(pn_end)
+        || comp->scope_cur->emit_options == MP_EMIT_OPT_NONE
+        || comp->scope_cur->emit_options == MP_EMIT_OPT_BYTECODE;
     if (end_on_stack) {
         compile_node(comp, pn_end);
     }
@@ -1436,7 +1453,19 @@ STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
     // compile: start
     compile_node(comp, pn_start);
 
-    EMIT_ARG(jump, entry_label);
+    assert(MP_PARSE_NODE_IS_SMALL_INT(pn_step));
+    mp_int_t step = MP_PARSE_NODE_LEAF_SMALL_INT(pn_step);
+
+    if (end_on_stack) {
+        // compile: if not end <cond> start: goto exit
+        // (end <cond> var is equivalent to var <cond'> end for integers)
+        EMIT(dup_top_two);
+        EMIT_ARG(binary_op, step >= 0 ? MP_BINARY_OP_MORE : MP_BINARY_OP_LESS);
+        EMIT_ARG(pop_jump_if, false, entry_label);
+    } else {
+        EMIT_ARG(jump, entry_label);
+    }
+
     EMIT_ARG(label_assign, top_label);
 
     // duplicate next value and store it to var
@@ -1448,27 +1477,23 @@ STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
 
     EMIT_ARG(label_assign, continue_label);
 
-    // compile: var + step
-    compile_node(comp, pn_step);
-    EMIT_ARG(binary_op, MP_BINARY_OP_INPLACE_ADD);
-
-    EMIT_ARG(label_assign, entry_label);
-
-    // compile: if var <cond> end: goto top
     if (end_on_stack) {
-        EMIT(dup_top_two);
-        EMIT(rot_two);
+        // compile: var += step; if end <cond> var: goto top
+        EMIT_ARG(for_range, step, top_label);
+        EMIT_ARG(label_assign, entry_label); // only jumped to if the loop never runs
     } else {
+        // compile: var + step
+        compile_node(comp, pn_step);
+        EMIT_ARG(binary_op, MP_BINARY_OP_INPLACE_ADD);
+
+        EMIT_ARG(label_assign, entry_label);
+
+        // compile: if var <cond> end: goto top
         EMIT(dup_top);
         compile_node(comp, pn_end);
+        EMIT_ARG(binary_op, step >= 0 ? MP_BINARY_OP_LESS : MP_BINARY_OP_MORE);
+        EMIT_ARG(pop_jump_if, true, top_label);
     }
-    assert(MP_PARSE_NODE_IS_SMALL_INT(pn_step));
-    if (MP_PARSE_NODE_LEAF_SMALL_INT(pn_step) >= 0) {
-        EMIT_ARG(binary_op, MP_BINARY_OP_LESS);
-    } else {
-        EMIT_ARG(binary_op, MP_BINARY_OP_MORE);
-    }
-    EMIT_ARG(pop_jump_if, true, top_label);
 
     // break/continue apply to outer loop (if any) in the else block
     END_BREAK_CONTINUE_BLOCK
@@ -1505,9 +1530,11 @@ STATIC void compile_for_stmt_optimised_range(compiler_t *comp, mp_parse_node_t p
 
 STATIC void compile_for_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     // this bit optimises: for <x> in range(...), turning it into an explicitly incremented variable
-    // this is actually slower, but uses no heap memory
+    // this uses no heap memory and avoids a call to the range iterator on each iteration
     // for viper it will be much, much faster
-    if (/*comp->scope_cur->emit_options == MP_EMIT_OPT_VIPER &&*/ MP_PARSE_NODE_IS_ID(pns->nodes[0]) && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_atom_expr_normal)) {
+    // <x> can be any assignment target, it's stored to with a normal assignment on each iteration
+    if ((MP_PARSE_NODE_IS_ID(pns->nodes[0]) || comp->scope_cur->emit_options != MP_EMIT_OPT_VIPER)
+        && MP_PARSE_NODE_IS_STRUCT_KIND(pns->nodes[1], PN_atom_expr_normal)) {
         mp_parse_node_struct_t *pns_it = (mp_parse_node_struct_t*)pns->nodes[1];
         if (MP_PARSE_NODE_IS_ID(pns_it->nodes[0])
             && MP_PARSE_NODE_LEAF_ARG(pns_it->nodes[0]) == MP_QSTR_range
@@ -1970,6 +1997,64 @@ STATIC void compile_async_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
 }
 #endif
 
+// Returns true if pn most likely evaluates to a str: a string literal, a call
+// to str(), chr() or repr(), or an expression like "%d" % x, "a" + b or
+// "{}".format(x) whose leftmost operand is one of these.
+STATIC bool node_is_str_like(mp_parse_node_t pn) {
+    while (MP_PARSE_NODE_IS_STRUCT(pn)) {
+        mp_parse_node_struct_t *pns = (mp_parse_node_struct_t*)pn;
+        switch (MP_PARSE_NODE_STRUCT_KIND(pns)) {
+            case PN_const_object:
+                return mp_obj_is_str(get_const_object(pns));
+            case PN_atom_expr_normal:
+                if (MP_PARSE_NODE_IS_ID(pns->nodes[0])) {
+                    qstr qst = MP_PARSE_NODE_LEAF_ARG(pns->nodes[0]);
+                    return qst == MP_QSTR_str || qst == MP_QSTR_chr || qst == MP_QSTR_repr;
+                }
+                // fall through
+            case PN_arith_expr:
+            case PN_term:
+                pn = pns->nodes[0];
+                break;
+            default:
+                return false;
+        }
+    }
+    return MP_PARSE_NODE_IS_LEAF(pn) && MP_PARSE_NODE_LEAF_KIND(pn) == MP_PARSE_NODE_STRING;
+}
+
+// Compile "x += y" where x is a local of a bytecode function that has a string
+// added to it somewhere, so that x can hold a string accumulator between
+// additions (see mp_obj_str_accum_add).  Any other load of such a local uses
+// LOAD_FAST_ACCUM to turn the accumulator back into a str.  Returns false if
+// the statement must be compiled the normal way.
+STATIC bool compile_inplace_add_fast(compiler_t *comp, mp_parse_node_t pn_lhs, mp_parse_node_struct_t *pns1) {
+    if (!MP_PARSE_NODE_IS_ID(pn_lhs)
+        || MP_PARSE_NODE_LEAF_ARG(pns1->nodes[0]) != MP_TOKEN_DEL_PLUS_EQUAL
+        || !SCOPE_IS_FUNC_LIKE(comp->scope_cur->kind)
+        || comp->scope_cur->emit_options == MP_EMIT_OPT_NATIVE_PYTHON
+        || comp->scope_cur->emit_options == MP_EMIT_OPT_VIPER) {
+        return false;
+    }
+    qstr qst = MP_PARSE_NODE_LEAF_ARG(pn_lhs);
+    if (comp->pass == MP_PASS_SCOPE) {
+        // the flag only takes effect if the name ends up as a plain local
+        if (node_is_str_like(pns1->nodes[1])) {
+            scope_find_or_add_id(comp->scope_cur, qst, ID_INFO_KIND_GLOBAL_IMPLICIT)->flags |= ID_FLAG_IS_STR_ACCUM;
+        }
+        return false;
+    }
+    id_info_t *id = scope_find(comp->scope_cur, qst);
+    if (id->kind != ID_INFO_KIND_LOCAL || !(id->flags & ID_FLAG_IS_STR_ACCUM)) {
+        return false;
+    }
+    // a plain load, which raises if x is unbound but doesn't finish the accumulator
+    EMIT_LOAD_FAST(qst, id->local_num);
+    compile_node(comp, pns1->nodes[1]);
+    EMIT_ARG(inplace_add_fast, id->local_num);
+    return true;
+}
+
 STATIC void compile_expr_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
     if (MP_PARSE_NODE_IS_NULL(pns->nodes[1])) {
         if (comp->is_repl && comp->scope_cur->kind == SCOPE_MODULE) {
@@ -1993,6 +2078,9 @@ STATIC void compile_expr_stmt(compiler_t *comp, mp_parse_node_struct_t *pns) {
         mp_parse_node_struct_t *pns1 = (mp_parse_node_struct_t*)pns->nodes[1];
         int kind = MP_PARSE_NODE_STRUCT_KIND(pns1);
         if (kind == PN_expr_stmt_augassign) {
+            if (compile_inplace_add_fast(comp, pns->nodes[0], pns1)) {
+                return;
+            }
             c_assign(comp, pns->nodes[0], ASSIGN_AUG_LOAD); // lhs load for aug assign
             compile_node(comp, pns1->nodes[1]); // rhs
             assert(MP_PARSE_NODE_IS_TOKEN(pns1->nodes[0]));
@@ -2201,11 +2289,28 @@ STATIC void compile_binary_op(compiler_t *comp, mp_parse_node_struct_t *pns) {
     }
 }
 
+// Compile an operand of a binary op.  If the op is arithmetic and the operand
+// is itself the result of an arithmetic op then that op is emitted with
+// binary_op_temp, so the VM knows its result is only on the stack and can be
+// reused (eg a boxed float), and true is returned.
+STATIC bool compile_arith_operand(compiler_t *comp, mp_parse_node_t pn, bool arith) {
+    bool temp = arith && (MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_arith_expr)
+        || MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_term)
+        || MP_PARSE_NODE_IS_STRUCT_KIND(pn, PN_power));
+    comp->binary_op_temp = temp;
+    compile_node(comp, pn);
+    return temp;
+}
+
 STATIC void compile_term(compiler_t *comp, mp_parse_node_struct_t *pns) {
+    bool result_is_temp = comp->binary_op_temp;
+    comp->binary_op_temp = false;
+    // shift_expr also comes here, but its ops never give a float
+    bool arith = MICROPY_OPT_FLOAT_TEMP && MP_PARSE_NODE_STRUCT_KIND(pns) != PN_shift_expr;
     int num_nodes = MP_PARSE_NODE_STRUCT_NUM_NODES(pns);
-    compile_node(comp, pns->nodes[0]);
+    bool lhs_temp = compile_arith_operand(comp, pns->nodes[0], arith);
     for (int i = 1; i + 1 < num_nodes; i += 2) {
-        compile_node(comp, pns->nodes[i + 1]);
+        bool rhs_temp = compile_arith_operand(comp, pns->nodes[i + 1], arith);
         mp_binary_op_t op;
         mp_token_kind_t tok = MP_PARSE_NODE_LEAF_ARG(pns->nodes[i]);
         switch (tok) {
@@ -2221,7 +2326,15 @@ STATIC void compile_term(compiler_t *comp, mp_parse_node_struct_t *pns) {
                 op = MP_BINARY_OP_RSHIFT;
                 break;
         }
-        EMIT_ARG(binary_op, op);
+        if (!arith) {
+            EMIT_ARG(binary_op, op);
+        } else if (lhs_temp || rhs_temp || i + 2 < num_nodes || result_is_temp) {
+            EMIT_ARG(binary_op_temp, op, (lhs_temp ? MP_EMIT_BINARY_OP_TEMP_LHS : 0) | (rhs_temp ? MP_EMIT_BINARY_OP_TEMP_RHS : 0));
+        } else {
+            EMIT_ARG(binary_op, op);
+        }
+        // the result of this op is the lhs of the next one
+        lhs_temp = true;
     }
 }
 
@@ -2337,8 +2450,16 @@ STATIC void compile_atom_expr_normal(compiler_t *comp, mp_parse_node_struct_t *p
 }
 
 STATIC void compile_power(compiler_t *comp, mp_parse_node_struct_t *pns) {
-    compile_generic_all_nodes(comp, pns); // 2 nodes, arguments of power
-    EMIT_ARG(binary_op, MP_BINARY_OP_POWER);
+    bool result_is_temp = comp->binary_op_temp;
+    comp->binary_op_temp = false;
+    // 2 nodes, arguments of power
+    bool lhs_temp = compile_arith_operand(comp, pns->nodes[0], MICROPY_OPT_FLOAT_TEMP);
+    bool rhs_temp = compile_arith_operand(comp, pns->nodes[1], MICROPY_OPT_FLOAT_TEMP);
+    if (MICROPY_OPT_FLOAT_TEMP && (lhs_temp || rhs_temp || result_is_temp)) {
+        EMIT_ARG(binary_op_temp, MP_BINARY_OP_POWER, (lhs_temp ? MP_EMIT_BINARY_OP_TEMP_LHS : 0) | (rhs_temp ? MP_EMIT_BINARY_OP_TEMP_RHS : 0));
+    } else {
+        EMIT_ARG(binary_op, MP_BINARY_OP_POWER);
+    }
 }
 
 STATIC void compile_trailer_paren_helper(compiler_t *comp, mp_parse_node_t pn_arglist, bool is_method_call, int n_positional_extra) {
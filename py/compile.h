@@ -42,4 +42,10 @@ mp_raw_code_t *mp_compile_to_raw_code(mp_parse_tree_t *parse_tree, qstr source_f
 // this is implemented in runtime.c
 mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_input_kind, mp_obj_dict_t *globals, mp_obj_dict_t *locals);
 
+#if MICROPY_COMP_STREAM
+// this is like mp_parse_compile_execute with file input, but each top-level
+// statement is parsed, compiled and executed before the next one is parsed
+void mp_parse_compile_execute_stream(mp_lexer_t *lex, mp_obj_dict_t *globals, mp_obj_dict_t *locals, bool is_repl);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_COMPILE_H
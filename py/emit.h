@@ -90,6 +90,11 @@ typedef enum {
 #define MP_EMIT_YIELD_VALUE (0)
 #define MP_EMIT_YIELD_FROM (1)
 
+// Flags for emit->binary_op_temp(), saying which operands are results of
+// another binary_op_temp that are only referenced from the stack
+#define MP_EMIT_BINARY_OP_TEMP_LHS (0x01)
+#define MP_EMIT_BINARY_OP_TEMP_RHS (0x02)
+
 typedef struct _emit_t emit_t;
 
 typedef struct _mp_emit_method_table_id_ops_t {
@@ -139,9 +144,13 @@ typedef struct _emit_method_table_t {
     void (*get_iter)(emit_t *emit, bool use_stack);
     void (*for_iter)(emit_t *emit, mp_uint_t label);
     void (*for_iter_end)(emit_t *emit);
+    void (*for_range)(emit_t *emit, mp_int_t step, mp_uint_t label);
     void (*pop_except_jump)(emit_t *emit, mp_uint_t label, bool within_exc_handler);
     void (*unary_op)(emit_t *emit, mp_unary_op_t op);
     void (*binary_op)(emit_t *emit, mp_binary_op_t op);
+    void (*binary_op_temp)(emit_t *emit, mp_binary_op_t op, int temp);
+    void (*load_fast_accum)(emit_t *emit, mp_uint_t local_num);
+    void (*inplace_add_fast)(emit_t *emit, mp_uint_t local_num);
     void (*build)(emit_t *emit, mp_uint_t n_args, int kind);
     void (*store_map)(emit_t *emit);
     void (*store_comp)(emit_t *emit, scope_kind_t kind, mp_uint_t set_stack_index);
@@ -234,9 +243,13 @@ void mp_emit_bc_end_finally(emit_t *emit);
 void mp_emit_bc_get_iter(emit_t *emit, bool use_stack);
 void mp_emit_bc_for_iter(emit_t *emit, mp_uint_t label);
 void mp_emit_bc_for_iter_end(emit_t *emit);
+void mp_emit_bc_for_range(emit_t *emit, mp_int_t step, mp_uint_t label);
 void mp_emit_bc_pop_except_jump(emit_t *emit, mp_uint_t label, bool within_exc_handler);
 void mp_emit_bc_unary_op(emit_t *emit, mp_unary_op_t op);
 void mp_emit_bc_binary_op(emit_t *emit, mp_binary_op_t op);
+void mp_emit_bc_binary_op_temp(emit_t *emit, mp_binary_op_t op, int temp);
+void mp_emit_bc_load_fast_accum(emit_t *emit, mp_uint_t local_num);
+void mp_emit_bc_inplace_add_fast(emit_t *emit, mp_uint_t local_num);
 void mp_emit_bc_build(emit_t *emit, mp_uint_t n_args, int kind);
 void mp_emit_bc_store_map(emit_t *emit);
 void mp_emit_bc_store_comp(emit_t *emit, scope_kind_t kind, mp_uint_t list_stack_index);
@@ -64,6 +64,15 @@ struct _emit_t {
     size_t bytecode_size;
     byte *code_base; // stores both byte code and code info
 
+    // The last emitted opcode that can be fused with the following one into
+    // a superinstruction.  It's only valid if fuse_end == bytecode_offset,
+    // ie nothing was emitted after it, and no label or line number was
+    // assigned to the offset following it.
+    size_t fuse_offset;
+    size_t fuse_end;
+    byte fuse_op;
+    byte fuse_arg;
+
     #if MICROPY_PERSISTENT_CODE
     uint16_t ct_cur_obj;
     uint16_t ct_num_obj;
@@ -289,6 +298,28 @@ STATIC void emit_write_bytecode_byte_raw_code(emit_t *emit, int stack_adj, byte
     #endif
 }
 
+// Record the opcode just emitted, starting at the given offset, as a candidate
+// to be fused with the next opcode.
+STATIC void emit_bc_set_fuse_candidate(emit_t *emit, size_t offset, byte op, byte arg) {
+    emit->fuse_offset = offset;
+    emit->fuse_end = emit->bytecode_offset;
+    emit->fuse_op = op;
+    emit->fuse_arg = arg;
+}
+
+// If the last emitted opcode was op and can be fused, remove it from the
+// bytecode (its arg is left in emit->fuse_arg) and return true.  The stack
+// adjustment of the removed opcode is retained, so the superinstruction that
+// replaces it must only apply the adjustment of the new opcode.
+STATIC bool emit_bc_fuse_with(emit_t *emit, byte op) {
+    if (emit->fuse_end != emit->bytecode_offset || emit->fuse_op != op) {
+        return false;
+    }
+    emit->bytecode_offset = emit->fuse_offset;
+    emit->fuse_end = (size_t)-1;
+    return true;
+}
+
 // unsigned labels are relative to ip following this instruction, stored as 16 bits
 STATIC void emit_write_bytecode_byte_unsigned_label(emit_t *emit, int stack_adj, byte b1, mp_uint_t label) {
     mp_emit_bc_adjust_stack_size(emit, stack_adj);
@@ -334,6 +365,7 @@ void mp_emit_bc_start_pass(emit_t *emit, pass_kind_t pass, scope_t *scope) {
     #endif
     emit->bytecode_offset = 0;
     emit->code_info_offset = 0;
+    emit->fuse_end = (size_t)-1;
 
     // Write local state size and exception stack size.
     {
@@ -494,6 +526,8 @@ void mp_emit_bc_set_source_line(emit_t *emit, mp_uint_t source_line) {
         emit_write_code_info_bytes_lines(emit, bytes_to_skip, lines_to_skip);
         emit->last_source_line_offset = emit->bytecode_offset;
         emit->last_source_line = source_line;
+        // the next opcode starts a new line so can't be fused with the last one
+        emit->fuse_end = (size_t)-1;
     }
 #else
     (void)emit;
@@ -507,6 +541,8 @@ void mp_emit_bc_label_assign(emit_t *emit, mp_uint_t l) {
         return;
     }
     assert(l < emit->max_num_labels);
+    // the next opcode may be jumped to so can't be fused with the last one
+    emit->fuse_end = (size_t)-1;
     if (emit->pass < MP_PASS_EMIT) {
         // assign label offset
         assert(emit->label_offsets[l] == (mp_uint_t)-1);
@@ -540,7 +576,9 @@ void mp_emit_bc_load_const_tok(emit_t *emit, mp_token_kind_t tok) {
 
 void mp_emit_bc_load_const_small_int(emit_t *emit, mp_int_t arg) {
     if (-16 <= arg && arg <= 47) {
+        size_t offset = emit->bytecode_offset;
         emit_write_bytecode_byte(emit, 1, MP_BC_LOAD_CONST_SMALL_INT_MULTI + 16 + arg);
+        emit_bc_set_fuse_candidate(emit, offset, MP_BC_LOAD_CONST_SMALL_INT_MULTI, 16 + arg);
     } else {
         emit_write_bytecode_byte_int(emit, 1, MP_BC_LOAD_CONST_SMALL_INT, arg);
     }
@@ -563,7 +601,14 @@ void mp_emit_bc_load_local(emit_t *emit, qstr qst, mp_uint_t local_num, int kind
     MP_STATIC_ASSERT(MP_BC_LOAD_FAST_N + MP_EMIT_IDOP_LOCAL_DEREF == MP_BC_LOAD_DEREF);
     (void)qst;
     if (kind == MP_EMIT_IDOP_LOCAL_FAST && local_num <= 15) {
-        emit_write_bytecode_byte(emit, 1, MP_BC_LOAD_FAST_MULTI + local_num);
+        if (emit_bc_fuse_with(emit, MP_BC_LOAD_FAST_MULTI)) {
+            // LOAD_FAST a; LOAD_FAST b -> LOAD_FAST_LOAD_FAST a<<4|b
+            emit_write_bytecode_byte_byte(emit, 1, MP_BC_LOAD_FAST_LOAD_FAST, emit->fuse_arg << 4 | local_num);
+        } else {
+            size_t offset = emit->bytecode_offset;
+            emit_write_bytecode_byte(emit, 1, MP_BC_LOAD_FAST_MULTI + local_num);
+            emit_bc_set_fuse_candidate(emit, offset, MP_BC_LOAD_FAST_MULTI, local_num);
+        }
     } else {
         emit_write_bytecode_byte_uint(emit, 1, MP_BC_LOAD_FAST_N + kind, local_num);
     }
@@ -670,7 +715,13 @@ void mp_emit_bc_jump(emit_t *emit, mp_uint_t label) {
 }
 
 void mp_emit_bc_pop_jump_if(emit_t *emit, bool cond, mp_uint_t label) {
-    if (cond) {
+    MP_STATIC_ASSERT(MP_BC_BINARY_OP_POP_JUMP_IF_TRUE + 1 == MP_BC_BINARY_OP_POP_JUMP_IF_FALSE);
+    if (emit_bc_fuse_with(emit, MP_BC_BINARY_OP_MULTI)) {
+        // BINARY_OP op; POP_JUMP_IF label -> BINARY_OP_POP_JUMP_IF label op
+        byte op = emit->fuse_arg;
+        emit_write_bytecode_byte_signed_label(emit, -1, MP_BC_BINARY_OP_POP_JUMP_IF_TRUE + !cond, label);
+        emit_write_bytecode_raw_byte(emit, op);
+    } else if (cond) {
         emit_write_bytecode_byte_signed_label(emit, -1, MP_BC_POP_JUMP_IF_TRUE, label);
     } else {
         emit_write_bytecode_byte_signed_label(emit, -1, MP_BC_POP_JUMP_IF_FALSE, label);
@@ -738,6 +789,20 @@ void mp_emit_bc_for_iter_end(emit_t *emit) {
     mp_emit_bc_adjust_stack_size(emit, -MP_OBJ_ITER_BUF_NSLOTS);
 }
 
+void mp_emit_bc_for_range(emit_t *emit, mp_int_t step, mp_uint_t label) {
+    if (-128 <= step && step <= 127) {
+        emit_write_bytecode_byte_signed_label(emit, 0, MP_BC_FOR_RANGE, label);
+        emit_write_bytecode_raw_byte(emit, step);
+    } else {
+        // step doesn't fit in the opcode so emit the equivalent sequence
+        mp_emit_bc_load_const_small_int(emit, step);
+        mp_emit_bc_binary_op(emit, MP_BINARY_OP_INPLACE_ADD);
+        mp_emit_bc_dup_top_two(emit);
+        mp_emit_bc_binary_op(emit, step > 0 ? MP_BINARY_OP_MORE : MP_BINARY_OP_LESS);
+        mp_emit_bc_pop_jump_if(emit, true, label);
+    }
+}
+
 void mp_emit_bc_pop_except_jump(emit_t *emit, mp_uint_t label, bool within_exc_handler) {
     (void)within_exc_handler;
     emit_write_bytecode_byte_unsigned_label(emit, 0, MP_BC_POP_EXCEPT_JUMP, label);
@@ -756,12 +821,48 @@ void mp_emit_bc_binary_op(emit_t *emit, mp_binary_op_t op) {
         invert = true;
         op = MP_BINARY_OP_IS;
     }
-    emit_write_bytecode_byte(emit, -1, MP_BC_BINARY_OP_MULTI + op);
-    if (invert) {
-        emit_write_bytecode_byte(emit, 0, MP_BC_UNARY_OP_MULTI + MP_UNARY_OP_NOT);
+    if (MP_BINARY_OP_INPLACE_ADD <= op && op <= MP_BINARY_OP_INPLACE_SUBTRACT
+        && emit_bc_fuse_with(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI)) {
+        // LOAD_CONST_SMALL_INT n; BINARY_OP op -> BINARY_OP_SMALL_INT op<<6|n+16
+        byte arg = (MP_BC_BINARY_OP_SMALL_INT_INPLACE_ADD + op - MP_BINARY_OP_INPLACE_ADD) << 6 | emit->fuse_arg;
+        emit_write_bytecode_byte_byte(emit, -1, MP_BC_BINARY_OP_SMALL_INT, arg);
+    } else if (MP_BINARY_OP_ADD <= op && op <= MP_BINARY_OP_SUBTRACT
+        && emit_bc_fuse_with(emit, MP_BC_LOAD_CONST_SMALL_INT_MULTI)) {
+        byte arg = (MP_BC_BINARY_OP_SMALL_INT_ADD + op - MP_BINARY_OP_ADD) << 6 | emit->fuse_arg;
+        emit_write_bytecode_byte_byte(emit, -1, MP_BC_BINARY_OP_SMALL_INT, arg);
+    } else {
+        size_t offset = emit->bytecode_offset;
+        emit_write_bytecode_byte(emit, -1, MP_BC_BINARY_OP_MULTI + op);
+        if (invert) {
+            emit_write_bytecode_byte(emit, 0, MP_BC_UNARY_OP_MULTI + MP_UNARY_OP_NOT);
+        } else {
+            emit_bc_set_fuse_candidate(emit, offset, MP_BC_BINARY_OP_MULTI, op);
+        }
+    }
+}
+
+void mp_emit_bc_binary_op_temp(emit_t *emit, mp_binary_op_t op, int temp) {
+    MP_STATIC_ASSERT(MP_BINARY_OP_POWER < 64);
+    if (MP_BINARY_OP_ADD <= op && op <= MP_BINARY_OP_SUBTRACT
+        && emit->fuse_end == emit->bytecode_offset
+        && emit->fuse_op == MP_BC_LOAD_CONST_SMALL_INT_MULTI) {
+        // adding a small int constant is most likely int arithmetic, so
+        // prefer BINARY_OP_SMALL_INT
+        mp_emit_bc_binary_op(emit, op);
+    } else {
+        emit_write_bytecode_byte_byte(emit, -1, MP_BC_BINARY_OP_TEMP, op | temp << 6);
     }
 }
 
+void mp_emit_bc_load_fast_accum(emit_t *emit, mp_uint_t local_num) {
+    emit_write_bytecode_byte_uint(emit, 1, MP_BC_LOAD_FAST_ACCUM, local_num);
+}
+
+void mp_emit_bc_inplace_add_fast(emit_t *emit, mp_uint_t local_num) {
+    // pops the rhs and the value loaded from the local before it
+    emit_write_bytecode_byte_uint(emit, -2, MP_BC_INPLACE_ADD_FAST, local_num);
+}
+
 void mp_emit_bc_build(emit_t *emit, mp_uint_t n_args, int kind) {
     MP_STATIC_ASSERT(MP_BC_BUILD_TUPLE + MP_EMIT_BUILD_TUPLE == MP_BC_BUILD_TUPLE);
     MP_STATIC_ASSERT(MP_BC_BUILD_TUPLE + MP_EMIT_BUILD_LIST == MP_BC_BUILD_LIST);
@@ -916,9 +1017,13 @@ const emit_method_table_t emit_bc_method_table = {
     mp_emit_bc_get_iter,
     mp_emit_bc_for_iter,
     mp_emit_bc_for_iter_end,
+    mp_emit_bc_for_range,
     mp_emit_bc_pop_except_jump,
     mp_emit_bc_unary_op,
     mp_emit_bc_binary_op,
+    mp_emit_bc_binary_op_temp,
+    mp_emit_bc_load_fast_accum,
+    mp_emit_bc_inplace_add_fast,
     mp_emit_bc_build,
     mp_emit_bc_store_map,
     mp_emit_bc_store_comp,
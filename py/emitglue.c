@@ -187,6 +187,10 @@ mp_obj_t mp_make_function_from_raw_code(const mp_raw_code_t *rc, mp_obj_t def_ar
             self_fun->rc = rc;
             #endif
 
+            #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+            ((mp_obj_fun_bc_t*)MP_OBJ_TO_PTR(fun))->inplace_qstr = rc->inplace_qstr;
+            #endif
+
             break;
     }
 
@@ -81,6 +81,9 @@ typedef struct _mp_raw_code_t {
     #if MICROPY_EMIT_MACHINE_CODE
     mp_uint_t type_sig; // for viper, compressed as 2-bit types; ret is MSB, then arg0, arg1, etc
     #endif
+    #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+    const uint16_t *inplace_qstr; // qstr table if fun_data is executed in place, else NULL
+    #endif
 } mp_raw_code_t;
 
 mp_raw_code_t *mp_emit_glue_new_raw_code(void);
@@ -59,6 +59,17 @@
 // wrapper around everything in this file
 #if N_X64 || N_X86 || N_THUMB || N_ARM || N_XTENSA
 
+// Whether this emitter supports viper's native float type.  A float is held as
+// its raw bits in the same registers and stack slots as other native values,
+// and is moved to FPU registers just for the instructions that operate on it.
+// The precision of a float is that of mp_float_t on x64, and single on Thumb.
+#define N_FLOAT (MICROPY_EMIT_NATIVE_FLOAT && (N_X64 || N_THUMB))
+#define N_FLOAT_IS_DOUBLE (N_X64 && MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE)
+
+#if N_FLOAT && N_THUMB && !MICROPY_DYNAMIC_COMPILER && !defined(__ARM_FP)
+#error "MICROPY_EMIT_NATIVE_FLOAT with the Thumb emitter needs an FPU"
+#endif
+
 // C stack layout for native functions:
 //  0:                          nlr_buf_t [optional]
 //  emit->code_state_start:     mp_code_state_t
@@ -129,6 +140,9 @@ typedef enum {
     VTYPE_PTR8 = 0x00 | MP_NATIVE_TYPE_PTR8,
     VTYPE_PTR16 = 0x00 | MP_NATIVE_TYPE_PTR16,
     VTYPE_PTR32 = 0x00 | MP_NATIVE_TYPE_PTR32,
+    VTYPE_FLOAT = 0x00 | MP_NATIVE_TYPE_FLOAT,
+    VTYPE_PTRF32 = 0x00 | MP_NATIVE_TYPE_PTRF32,
+    VTYPE_PTRF64 = 0x00 | MP_NATIVE_TYPE_PTRF64,
 
     VTYPE_PTR_NONE = 0x50 | MP_NATIVE_TYPE_PTR,
 
@@ -146,6 +160,11 @@ STATIC qstr vtype_to_qstr(vtype_kind_t vtype) {
         case VTYPE_PTR8: return MP_QSTR_ptr8;
         case VTYPE_PTR16: return MP_QSTR_ptr16;
         case VTYPE_PTR32: return MP_QSTR_ptr32;
+        #if N_FLOAT
+        case VTYPE_FLOAT: return MP_QSTR_float;
+        case VTYPE_PTRF32: return MP_QSTR_ptrf32;
+        case VTYPE_PTRF64: return MP_QSTR_ptrf64;
+        #endif
         case VTYPE_PTR_NONE: default: return MP_QSTR_None;
     }
 }
@@ -755,6 +774,12 @@ STATIC vtype_kind_t load_reg_stack_imm(emit_t *emit, int reg_dest, const stack_i
             ASM_MOV_REG_IMM(emit->as, reg_dest, (uintptr_t)MP_OBJ_NEW_SMALL_INT(si->data.u_imm));
         } else if (si->vtype == VTYPE_PTR_NONE) {
             emit_native_mov_reg_const(emit, reg_dest, MP_F_CONST_NONE_OBJ);
+        #if N_FLOAT
+        } else if (si->vtype == VTYPE_FLOAT) {
+            // boxing a float needs a function call, which is left to the caller
+            ASM_MOV_REG_IMM(emit->as, reg_dest, si->data.u_imm);
+            return VTYPE_FLOAT;
+        #endif
         } else {
             mp_raise_NotImplementedError("conversion to object");
         }
@@ -925,6 +950,146 @@ STATIC void emit_call_with_qstr_arg(emit_t *emit, mp_fun_kind_t fun_kind, qstr q
     ASM_CALL_IND(emit->as, fun_kind);
 }
 
+#if N_FLOAT
+
+STATIC mp_uint_t emit_native_float_bits(mp_float_t f) {
+    #if N_FLOAT_IS_DOUBLE
+    union { double f; uint64_t u; } val = { .f = f };
+    #else
+    union { float f; uint32_t u; } val = { .f = (float)f };
+    #endif
+    return val.u;
+}
+
+// If the value on the stack at the given depth is an int immediate then make
+// it a float immediate, so that it can be used where a float is expected.
+STATIC void emit_native_fold_imm_to_float(emit_t *emit, mp_uint_t depth) {
+    stack_info_t *si = peek_stack(emit, depth);
+    if (si->kind == STACK_IMM && si->vtype == VTYPE_INT) {
+        si->vtype = VTYPE_FLOAT;
+        si->data.u_imm = emit_native_float_bits(si->data.u_imm);
+    }
+}
+
+// The following helpers operate on values in scratch registers, which they may
+// modify, and use the first two FPU registers as temporaries.
+
+// reg = float(reg), where reg holds an int
+STATIC void emit_native_float_from_int(emit_t *emit, int reg) {
+    #if N_X64
+    asm_x64_cvtsi2s_r64_to_xmm(emit->as, ASM_X64_REG_XMM0, reg, N_FLOAT_IS_DOUBLE);
+    asm_x64_mov_xmm_to_r64(emit->as, reg, ASM_X64_REG_XMM0, N_FLOAT_IS_DOUBLE);
+    #else
+    asm_thumb_vmov_s_reg(emit->as, 0, reg);
+    asm_thumb_vfp_op_s_s(emit->as, ASM_THUMB_VFP_OP_CVT_F32_S32, 0, 0);
+    asm_thumb_vmov_reg_s(emit->as, reg, 0);
+    #endif
+}
+
+// reg = int(reg), where reg holds a float
+STATIC void emit_native_float_to_int(emit_t *emit, int reg) {
+    #if N_X64
+    asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM0, reg, N_FLOAT_IS_DOUBLE);
+    asm_x64_cvtts2si_xmm_to_r64(emit->as, reg, ASM_X64_REG_XMM0, N_FLOAT_IS_DOUBLE);
+    #else
+    asm_thumb_vmov_s_reg(emit->as, 0, reg);
+    asm_thumb_vfp_op_s_s(emit->as, ASM_THUMB_VFP_OP_CVT_S32_F32, 0, 0);
+    asm_thumb_vmov_reg_s(emit->as, reg, 0);
+    #endif
+}
+
+// Convert a float between mp_float_t and the element type of a float pointer:
+// to mp_float_t after a load, or from it before a store.
+STATIC void emit_native_float_convert_for_ptr(emit_t *emit, int reg, vtype_kind_t vtype_ptr, bool is_load) {
+    #if N_X64
+    bool ptr_is_double = vtype_ptr == VTYPE_PTRF64;
+    if (ptr_is_double != N_FLOAT_IS_DOUBLE) {
+        bool src_is_double = is_load ? ptr_is_double : N_FLOAT_IS_DOUBLE;
+        asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM0, reg, src_is_double);
+        asm_x64_sse_op_xmm_xmm(emit->as, ASM_X64_SSE_OP_CVT, ASM_X64_REG_XMM0, ASM_X64_REG_XMM0, src_is_double);
+        asm_x64_mov_xmm_to_r64(emit->as, reg, ASM_X64_REG_XMM0, !src_is_double);
+    }
+    #else
+    // mp_float_t is single precision, as are the elements of ptrf32
+    (void)emit;
+    (void)reg;
+    (void)vtype_ptr;
+    (void)is_load;
+    #endif
+}
+
+// reg_lhs = reg_lhs <op> reg_rhs, for op one of +, -, * and /
+STATIC void emit_native_float_arith(emit_t *emit, mp_binary_op_t op, int reg_lhs, int reg_rhs) {
+    #if N_X64
+    int sse_op = op == MP_BINARY_OP_ADD ? ASM_X64_SSE_OP_ADD
+        : op == MP_BINARY_OP_SUBTRACT ? ASM_X64_SSE_OP_SUB
+        : op == MP_BINARY_OP_MULTIPLY ? ASM_X64_SSE_OP_MUL
+        : ASM_X64_SSE_OP_DIV;
+    asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM0, reg_lhs, N_FLOAT_IS_DOUBLE);
+    asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM1, reg_rhs, N_FLOAT_IS_DOUBLE);
+    asm_x64_sse_op_xmm_xmm(emit->as, sse_op, ASM_X64_REG_XMM0, ASM_X64_REG_XMM1, N_FLOAT_IS_DOUBLE);
+    asm_x64_mov_xmm_to_r64(emit->as, reg_lhs, ASM_X64_REG_XMM0, N_FLOAT_IS_DOUBLE);
+    #else
+    uint32_t vfp_op = op == MP_BINARY_OP_ADD ? ASM_THUMB_VFP_OP_ADD
+        : op == MP_BINARY_OP_SUBTRACT ? ASM_THUMB_VFP_OP_SUB
+        : op == MP_BINARY_OP_MULTIPLY ? ASM_THUMB_VFP_OP_MUL
+        : ASM_THUMB_VFP_OP_DIV;
+    asm_thumb_vmov_s_reg(emit->as, 0, reg_lhs);
+    asm_thumb_vmov_s_reg(emit->as, 1, reg_rhs);
+    asm_thumb_vfp_op_s_s_s(emit->as, vfp_op, 0, 0, 1);
+    asm_thumb_vmov_reg_s(emit->as, reg_lhs, 0);
+    #endif
+}
+
+// reg_dest = reg_lhs <op> reg_rhs, for op a comparison; as in Python, the
+// result is false when an argument is nan, except for the != comparison
+STATIC void emit_native_float_compare(emit_t *emit, mp_binary_op_t op, int reg_dest, int reg_lhs, int reg_rhs) {
+    // comparison ops are (in enum order): <, >, ==, <=, >=, !=
+    #if N_X64
+    static const byte preds[6] = {
+        ASM_X64_SSE_CMP_LT,
+        ASM_X64_SSE_CMP_LT, // for > we'll swap args
+        ASM_X64_SSE_CMP_EQ,
+        ASM_X64_SSE_CMP_LE,
+        ASM_X64_SSE_CMP_LE, // for >= we'll swap args
+        ASM_X64_SSE_CMP_NEQ,
+    };
+    if (op == MP_BINARY_OP_MORE || op == MP_BINARY_OP_MORE_EQUAL) {
+        int reg_temp = reg_lhs;
+        reg_lhs = reg_rhs;
+        reg_rhs = reg_temp;
+    }
+    asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM0, reg_lhs, N_FLOAT_IS_DOUBLE);
+    asm_x64_mov_r64_to_xmm(emit->as, ASM_X64_REG_XMM1, reg_rhs, N_FLOAT_IS_DOUBLE);
+    asm_x64_sse_cmp_xmm_xmm(emit->as, preds[op - MP_BINARY_OP_LESS], ASM_X64_REG_XMM0, ASM_X64_REG_XMM1, N_FLOAT_IS_DOUBLE);
+    // the comparison gives a mask of all ones or all zeros, so reduce it to 1 or 0
+    asm_x64_mov_xmm_to_r64(emit->as, reg_dest, ASM_X64_REG_XMM0, N_FLOAT_IS_DOUBLE);
+    ASM_MOV_REG_IMM(emit->as, reg_lhs, 1);
+    ASM_AND_REG_REG(emit->as, reg_dest, reg_lhs);
+    #else
+    // these conditions are all false for an unordered result (a nan argument)
+    // except for NE, and only even ones can be used with the ITE op
+    static const uint16_t ops[6] = {
+        ASM_THUMB_OP_ITE_MI,
+        ASM_THUMB_OP_ITE_GT,
+        ASM_THUMB_OP_ITE_EQ,
+        ASM_THUMB_OP_ITE_HI, // result is inverted
+        ASM_THUMB_OP_ITE_GE,
+        ASM_THUMB_OP_ITE_EQ, // result is inverted
+    };
+    static const byte ret[6] = { 1, 1, 1, 0, 1, 0, };
+    asm_thumb_vmov_s_reg(emit->as, 0, reg_lhs);
+    asm_thumb_vmov_s_reg(emit->as, 1, reg_rhs);
+    asm_thumb_vfp_op_s_s(emit->as, ASM_THUMB_VFP_OP_CMP, 0, 1);
+    asm_thumb_vmrs_apsr_fpscr(emit->as);
+    asm_thumb_op16(emit->as, ops[op - MP_BINARY_OP_LESS]);
+    asm_thumb_mov_rlo_i8(emit->as, reg_dest, ret[op - MP_BINARY_OP_LESS]);
+    asm_thumb_mov_rlo_i8(emit->as, reg_dest, ret[op - MP_BINARY_OP_LESS] ^ 1);
+    #endif
+}
+
+#endif // N_FLOAT
+
 // vtype of all n_pop objects is VTYPE_PYOBJ
 // Will convert any items that are not VTYPE_PYOBJ to this type and put them back on the stack.
 // If any conversions of non-immediate values are needed, then it uses REG_ARG_1, REG_ARG_2 and REG_RET.
@@ -1300,8 +1465,15 @@ STATIC void emit_native_load_const_str(emit_t *emit, qstr qst) {
 }
 
 STATIC void emit_native_load_const_obj(emit_t *emit, mp_obj_t obj) {
-    emit->scope->scope_flags |= MP_SCOPE_FLAG_HASCONSTS;
     emit_native_pre(emit);
+    #if N_FLOAT
+    if (emit->do_viper_types && mp_obj_is_float(obj)) {
+        // float constants are native floats in viper code
+        emit_post_push_imm(emit, VTYPE_FLOAT, emit_native_float_bits(mp_obj_float_get(obj)));
+        return;
+    }
+    #endif
+    emit->scope->scope_flags |= MP_SCOPE_FLAG_HASCONSTS;
     need_reg_single(emit, REG_RET, 0);
     emit_load_reg_with_object(emit, REG_RET, obj);
     emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
@@ -1436,6 +1608,7 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             int reg_base = REG_ARG_1;
             int reg_index = REG_ARG_2;
             emit_pre_pop_reg_flexible(emit, &vtype_base, &reg_base, reg_index, reg_index);
+            need_reg_single(emit, REG_RET, 0);
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
@@ -1472,6 +1645,9 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, reg_base); // load from (base+2*index)
                     break;
                 }
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
                 case VTYPE_PTR32: {
                     // pointer to 32-bit memory
                     if (index_value != 0) {
@@ -1489,6 +1665,13 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD32_REG_REG(emit->as, REG_RET, reg_base); // load from (base+4*index)
                     break;
                 }
+                #if N_FLOAT && N_X64
+                case VTYPE_PTRF64: {
+                    // pointer to 64-bit floats
+                    ASM_LOAD_REG_REG_OFFSET(emit->as, REG_RET, reg_base, index_value); // load from (base+8*index)
+                    break;
+                }
+                #endif
                 default:
                     EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                         "can't load from '%q'", vtype_to_qstr(vtype_base));
@@ -1499,6 +1682,7 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
             int reg_index = REG_ARG_2;
             emit_pre_pop_reg_flexible(emit, &vtype_index, &reg_index, REG_ARG_1, REG_ARG_1);
             emit_pre_pop_reg(emit, &vtype_base, REG_ARG_1);
+            need_reg_single(emit, REG_RET, 0);
             if (vtype_index != VTYPE_INT && vtype_index != VTYPE_UINT) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     "can't load with '%q' index", vtype_to_qstr(vtype_index));
@@ -1518,6 +1702,9 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD16_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+2*index)
                     break;
                 }
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
                 case VTYPE_PTR32: {
                     // pointer to word-size memory
                     ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
@@ -1527,11 +1714,28 @@ STATIC void emit_native_load_subscr(emit_t *emit) {
                     ASM_LOAD32_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+4*index)
                     break;
                 }
+                #if N_FLOAT && N_X64
+                case VTYPE_PTRF64: {
+                    // pointer to 64-bit floats
+                    for (int i = 0; i < 8; ++i) {
+                        ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
+                    }
+                    ASM_LOAD_REG_REG(emit->as, REG_RET, REG_ARG_1); // load from (base+8*index)
+                    break;
+                }
+                #endif
                 default:
                     EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                         "can't load from '%q'", vtype_to_qstr(vtype_base));
             }
         }
+        #if N_FLOAT
+        if (vtype_base == VTYPE_PTRF32 || vtype_base == VTYPE_PTRF64) {
+            emit_native_float_convert_for_ptr(emit, REG_RET, vtype_base, true);
+            emit_post_push_reg(emit, VTYPE_FLOAT, REG_RET);
+            return;
+        }
+        #endif
         emit_post_push_reg(emit, VTYPE_INT, REG_RET);
     }
 }
@@ -1611,6 +1815,45 @@ STATIC void emit_native_store_attr(emit_t *emit, qstr qst) {
     emit_post(emit);
 }
 
+// Whether a value of the given type can be stored via a pointer of the given type
+STATIC bool emit_native_can_store(vtype_kind_t vtype_base, vtype_kind_t vtype_value) {
+    #if N_FLOAT
+    if ((vtype_base == VTYPE_PTRF32 || vtype_base == VTYPE_PTRF64) && vtype_value == VTYPE_FLOAT) {
+        return true;
+    }
+    #else
+    (void)vtype_base;
+    #endif
+    return vtype_value == VTYPE_BOOL || vtype_value == VTYPE_INT || vtype_value == VTYPE_UINT;
+}
+
+#if N_FLOAT
+// Put a value that is about to be stored via a float pointer in the format of
+// the pointer's elements, converting it first if it's an int.  The base and
+// index of the store must not be in REG_ARG_3, which is used if the value
+// needs converting.
+STATIC void emit_native_float_store_value(emit_t *emit, int *reg_value, vtype_kind_t vtype_value, vtype_kind_t vtype_base) {
+    bool from_int = vtype_value != VTYPE_FLOAT;
+    #if N_X64
+    bool convert = (vtype_base == VTYPE_PTRF64) != N_FLOAT_IS_DOUBLE;
+    #else
+    bool convert = false;
+    #endif
+    if (from_int || convert) {
+        // convert a copy, because the value may be in a local's register
+        if (*reg_value != REG_ARG_3) {
+            need_reg_single(emit, REG_ARG_3, 0);
+            ASM_MOV_REG_REG(emit->as, REG_ARG_3, *reg_value);
+            *reg_value = REG_ARG_3;
+        }
+        if (from_int) {
+            emit_native_float_from_int(emit, REG_ARG_3);
+        }
+        emit_native_float_convert_for_ptr(emit, REG_ARG_3, vtype_base, false);
+    }
+}
+#endif
+
 STATIC void emit_native_store_subscr(emit_t *emit) {
     DEBUG_printf("store_subscr\n");
     // need to compile: base[index] = value
@@ -1636,6 +1879,12 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
         // TODO The different machine architectures have very different
         // capabilities and requirements for stores, so probably best to
         // write a completely separate store-optimiser for each one.
+        #if N_FLOAT
+        bool is_float_ptr = vtype_base == VTYPE_PTRF32 || vtype_base == VTYPE_PTRF64;
+        if (is_float_ptr) {
+            emit_native_fold_imm_to_float(emit, 2);
+        }
+        #endif
         stack_info_t *top = peek_stack(emit, 0);
         if (top->vtype == VTYPE_INT && top->kind == STACK_IMM) {
             // index is an immediate
@@ -1652,10 +1901,15 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             #else
             emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, reg_base, reg_index);
             #endif
-            if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
+            if (!emit_native_can_store(vtype_base, vtype_value)) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     "can't store '%q'", vtype_to_qstr(vtype_value));
             }
+            #if N_FLOAT
+            if (is_float_ptr) {
+                emit_native_float_store_value(emit, &reg_value, vtype_value, vtype_base);
+            }
+            #endif
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
@@ -1696,6 +1950,9 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE16_REG_REG(emit->as, reg_value, reg_base); // store value to (base+2*index)
                     break;
                 }
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
                 case VTYPE_PTR32: {
                     // pointer to 32-bit memory
                     if (index_value != 0) {
@@ -1718,6 +1975,13 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE32_REG_REG(emit->as, reg_value, reg_base); // store value to (base+4*index)
                     break;
                 }
+                #if N_FLOAT && N_X64
+                case VTYPE_PTRF64: {
+                    // pointer to 64-bit floats
+                    ASM_STORE_REG_REG_OFFSET(emit->as, reg_value, reg_base, index_value); // store value to (base+8*index)
+                    break;
+                }
+                #endif
                 default:
                     EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                         "can't store to '%q'", vtype_to_qstr(vtype_base));
@@ -1739,10 +2003,15 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
             #else
             emit_pre_pop_reg_flexible(emit, &vtype_value, &reg_value, REG_ARG_1, reg_index);
             #endif
-            if (vtype_value != VTYPE_BOOL && vtype_value != VTYPE_INT && vtype_value != VTYPE_UINT) {
+            if (!emit_native_can_store(vtype_base, vtype_value)) {
                 EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                     "can't store '%q'", vtype_to_qstr(vtype_value));
             }
+            #if N_FLOAT
+            if (is_float_ptr) {
+                emit_native_float_store_value(emit, &reg_value, vtype_value, vtype_base);
+            }
+            #endif
             switch (vtype_base) {
                 case VTYPE_PTR8: {
                     // pointer to 8-bit memory
@@ -1766,6 +2035,9 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE16_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+2*index)
                     break;
                 }
+                #if N_FLOAT
+                case VTYPE_PTRF32:
+                #endif
                 case VTYPE_PTR32: {
                     // pointer to 32-bit memory
                     #if N_ARM
@@ -1779,6 +2051,16 @@ STATIC void emit_native_store_subscr(emit_t *emit) {
                     ASM_STORE32_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+4*index)
                     break;
                 }
+                #if N_FLOAT && N_X64
+                case VTYPE_PTRF64: {
+                    // pointer to 64-bit floats
+                    for (int i = 0; i < 8; ++i) {
+                        ASM_ADD_REG_REG(emit->as, REG_ARG_1, reg_index); // add index to base
+                    }
+                    ASM_STORE_REG_REG(emit->as, reg_value, REG_ARG_1); // store value to (base+8*index)
+                    break;
+                }
+                #endif
                 default:
                     EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
                         "can't store to '%q'", vtype_to_qstr(vtype_base));
@@ -2175,11 +2457,36 @@ STATIC void emit_native_pop_except_jump(emit_t *emit, mp_uint_t label, bool with
 }
 
 STATIC void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
+    #if N_FLOAT
+    stack_info_t *top = peek_stack(emit, 0);
+    if (emit->do_viper_types && top->vtype == VTYPE_FLOAT && op == MP_UNARY_OP_NEGATIVE) {
+        // negate by flipping the sign bit
+        #if N_FLOAT_IS_DOUBLE
+        mp_uint_t sign = (mp_uint_t)1 << 63;
+        #else
+        mp_uint_t sign = 0x80000000;
+        #endif
+        if (top->kind == STACK_IMM) {
+            top->data.u_imm ^= sign;
+        } else {
+            vtype_kind_t vtype;
+            emit_pre_pop_reg(emit, &vtype, REG_ARG_2);
+            ASM_MOV_REG_IMM(emit->as, REG_ARG_3, sign);
+            ASM_XOR_REG_REG(emit->as, REG_ARG_2, REG_ARG_3);
+            emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+        }
+        return;
+    }
+    #endif
     vtype_kind_t vtype;
     emit_pre_pop_reg(emit, &vtype, REG_ARG_2);
     if (vtype == VTYPE_PYOBJ) {
         emit_call_with_imm_arg(emit, MP_F_UNARY_OP, op, REG_ARG_1);
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
+    #if N_FLOAT
+    } else if (vtype == VTYPE_FLOAT && op == MP_UNARY_OP_POSITIVE) {
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+    #endif
     } else {
         adjust_stack(emit, 1);
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
@@ -2187,6 +2494,41 @@ STATIC void emit_native_unary_op(emit_t *emit, mp_unary_op_t op) {
     }
 }
 
+#if N_FLOAT
+STATIC void emit_native_binary_op_float(emit_t *emit, mp_binary_op_t op) {
+    // for floats, inplace and normal ops are equivalent, so use just normal ops
+    if (MP_BINARY_OP_INPLACE_OR <= op && op <= MP_BINARY_OP_INPLACE_POWER) {
+        op += MP_BINARY_OP_OR - MP_BINARY_OP_INPLACE_OR;
+    }
+
+    // an int argument is converted to a float, at compile time if it's a constant
+    emit_native_fold_imm_to_float(emit, 0);
+    emit_native_fold_imm_to_float(emit, 1);
+    vtype_kind_t vtype_lhs, vtype_rhs;
+    emit_pre_pop_reg_reg(emit, &vtype_rhs, REG_ARG_3, &vtype_lhs, REG_ARG_2);
+    if (vtype_lhs == VTYPE_INT) {
+        emit_native_float_from_int(emit, REG_ARG_2);
+    }
+    if (vtype_rhs == VTYPE_INT) {
+        emit_native_float_from_int(emit, REG_ARG_3);
+    }
+
+    if (op == MP_BINARY_OP_ADD || op == MP_BINARY_OP_SUBTRACT
+        || op == MP_BINARY_OP_MULTIPLY || op == MP_BINARY_OP_TRUE_DIVIDE) {
+        emit_native_float_arith(emit, op, REG_ARG_2, REG_ARG_3);
+        emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_2);
+    } else if (MP_BINARY_OP_LESS <= op && op <= MP_BINARY_OP_NOT_EQUAL) {
+        need_reg_single(emit, REG_RET, 0);
+        emit_native_float_compare(emit, op, REG_RET, REG_ARG_2, REG_ARG_3);
+        emit_post_push_reg(emit, VTYPE_BOOL, REG_RET);
+    } else {
+        adjust_stack(emit, 1);
+        EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+            "binary op %q not implemented", mp_binary_op_method_name[op]);
+    }
+}
+#endif
+
 STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     DEBUG_printf("binary_op(" UINT_FMT ")\n", op);
     vtype_kind_t vtype_lhs = peek_vtype(emit, 1);
@@ -2356,6 +2698,11 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
             emit_call_with_imm_arg(emit, MP_F_UNARY_OP, MP_UNARY_OP_NOT, REG_ARG_1);
         }
         emit_post_push_reg(emit, VTYPE_PYOBJ, REG_RET);
+    #if N_FLOAT
+    } else if ((vtype_lhs == VTYPE_FLOAT && (vtype_rhs == VTYPE_FLOAT || vtype_rhs == VTYPE_INT))
+        || (vtype_lhs == VTYPE_INT && vtype_rhs == VTYPE_FLOAT)) {
+        emit_native_binary_op_float(emit, op);
+    #endif
     } else {
         adjust_stack(emit, -1);
         EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
@@ -2364,6 +2711,33 @@ STATIC void emit_native_binary_op(emit_t *emit, mp_binary_op_t op) {
     }
 }
 
+STATIC void emit_native_for_range(emit_t *emit, mp_int_t step, mp_uint_t label) {
+    // stack is: end, var
+    // compile: var += step; if end <cond> var: goto label
+    emit_native_load_const_small_int(emit, step);
+    emit_native_binary_op(emit, MP_BINARY_OP_INPLACE_ADD);
+    emit_native_dup_top_two(emit);
+    emit_native_binary_op(emit, step > 0 ? MP_BINARY_OP_MORE : MP_BINARY_OP_LESS);
+    emit_native_pop_jump_if(emit, true, label);
+}
+
+STATIC void emit_native_binary_op_temp(emit_t *emit, mp_binary_op_t op, int temp) {
+    (void)temp;
+    emit_native_binary_op(emit, op);
+}
+
+// The compiler only uses string accumulators for bytecode, but implement
+// them the plain way for completeness.
+STATIC void emit_native_load_fast_accum(emit_t *emit, mp_uint_t local_num) {
+    emit_native_load_local(emit, MP_QSTR_NULL, local_num, MP_EMIT_IDOP_LOCAL_FAST);
+}
+
+STATIC void emit_native_inplace_add_fast(emit_t *emit, mp_uint_t local_num) {
+    // stack is: local, rhs
+    emit_native_binary_op(emit, MP_BINARY_OP_INPLACE_ADD);
+    emit_native_store_local(emit, MP_QSTR_NULL, local_num, MP_EMIT_IDOP_LOCAL_FAST);
+}
+
 #if MICROPY_PY_BUILTINS_SLICE
 STATIC void emit_native_build_slice(emit_t *emit, mp_uint_t n_args);
 #endif
@@ -2515,6 +2889,42 @@ STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
         assert(!star_flags);
         DEBUG_printf("  cast to %d\n", vtype_fun);
         vtype_kind_t vtype_cast = peek_stack(emit, 1)->data.u_imm;
+        #if N_FLOAT
+        vtype_kind_t vtype_arg = peek_vtype(emit, 0);
+        if (vtype_cast == VTYPE_FLOAT && vtype_arg != VTYPE_PYOBJ && vtype_arg != VTYPE_FLOAT) {
+            if (vtype_arg != VTYPE_BOOL && vtype_arg != VTYPE_INT && vtype_arg != VTYPE_UINT) {
+                EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                    "can't convert '%q' to '%q'", vtype_to_qstr(vtype_arg), MP_QSTR_float);
+            }
+            // convert the value of an int to a float
+            emit_native_fold_imm_to_float(emit, 0);
+            if (peek_vtype(emit, 0) == VTYPE_FLOAT) {
+                emit_fold_stack_top(emit, REG_ARG_1);
+            } else {
+                emit_pre_pop_reg(emit, &vtype_arg, REG_ARG_1);
+                emit_pre_pop_discard(emit);
+                emit_native_float_from_int(emit, REG_ARG_1);
+                emit_post_push_reg(emit, VTYPE_FLOAT, REG_ARG_1);
+            }
+            return;
+        }
+        if (vtype_arg == VTYPE_FLOAT) {
+            if (vtype_cast == VTYPE_INT || vtype_cast == VTYPE_UINT) {
+                // convert a float to an int, truncating towards zero
+                emit_pre_pop_reg(emit, &vtype_arg, REG_ARG_1);
+                emit_pre_pop_discard(emit);
+                emit_native_float_to_int(emit, REG_ARG_1);
+                emit_post_push_reg(emit, vtype_cast, REG_ARG_1);
+            } else {
+                if (vtype_cast != VTYPE_FLOAT) {
+                    EMIT_NATIVE_VIPER_TYPE_ERROR(emit,
+                        "can't convert '%q' to '%q'", MP_QSTR_float, vtype_to_qstr(vtype_cast));
+                }
+                emit_fold_stack_top(emit, REG_ARG_1);
+            }
+            return;
+        }
+        #endif
         switch (peek_vtype(emit, 0)) {
             case VTYPE_PYOBJ: {
                 vtype_kind_t vtype;
@@ -2531,6 +2941,10 @@ STATIC void emit_native_call_function(emit_t *emit, mp_uint_t n_positional, mp_u
             case VTYPE_PTR8:
             case VTYPE_PTR16:
             case VTYPE_PTR32:
+            #if N_FLOAT
+            case VTYPE_PTRF32:
+            case VTYPE_PTRF64:
+            #endif
             case VTYPE_PTR_NONE:
                 emit_fold_stack_top(emit, REG_ARG_1);
                 emit_post_top_set_vtype(emit, vtype_cast);
@@ -2597,6 +3011,11 @@ STATIC void emit_native_return_value(emit_t *emit) {
                 ASM_MOV_REG_IMM(emit->as, REG_ARG_1, 0);
             }
         } else {
+            #if N_FLOAT
+            if (return_vtype == VTYPE_FLOAT) {
+                emit_native_fold_imm_to_float(emit, 0);
+            }
+            #endif
             vtype_kind_t vtype;
             emit_pre_pop_reg(emit, &vtype, return_vtype == VTYPE_PYOBJ ? REG_RET : REG_ARG_1);
             if (vtype != return_vtype) {
@@ -2779,9 +3198,13 @@ const emit_method_table_t EXPORT_FUN(method_table) = {
     emit_native_get_iter,
     emit_native_for_iter,
     emit_native_for_iter_end,
+    emit_native_for_range,
     emit_native_pop_except_jump,
     emit_native_unary_op,
     emit_native_binary_op,
+    emit_native_binary_op_temp,
+    emit_native_load_fast_accum,
+    emit_native_inplace_add_fast,
     emit_native_build,
     emit_native_store_map,
     emit_native_store_comp,
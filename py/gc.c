@@ -325,6 +325,11 @@ void gc_collect_start(void) {
     #endif
     MP_STATE_MEM(gc_stack_overflow) = 0;
 
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // The type lookup cache is not traced, so invalidate all of its entries.
+    ++MP_STATE_VM(type_cache_epoch);
+    #endif
+
     // Trace root pointers.  This relies on the root pointers being organised
     // correctly in the mp_state_ctx structure.  We scan nlr_top, dict_locals,
     // dict_globals, then the root pointer section of mp_state_vm.
@@ -334,9 +339,11 @@ void gc_collect_start(void) {
     gc_collect_root(ptrs + root_start / sizeof(void*), (root_end - root_start) / sizeof(void*));
 
     #if MICROPY_ENABLE_PYSTACK
-    // Trace root pointers from the Python stack.
-    ptrs = (void**)(void*)MP_STATE_THREAD(pystack_start);
-    gc_collect_root(ptrs, (MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start)) / sizeof(void*));
+    // Trace root pointers from the Python stack.  Any chunks of it on the heap
+    // are traced from the pystack_chunk root pointer.
+    size_t pystack_len;
+    ptrs = mp_pystack_roots(&pystack_len);
+    gc_collect_root(ptrs, pystack_len);
     #endif
 }
 
@@ -78,8 +78,35 @@ STATIC bool is_char_and(mp_lexer_t *lex, byte c1, byte c2) {
     return lex->chr0 == c1 && lex->chr1 == c2;
 }
 
+// Character classes of ASCII characters, for the is_xxx functions below
+#define CC_SPACE (0x01)
+#define CC_DIGIT (0x02)
+#define CC_ID_HEAD (0x04)
+#define CC_ID_TAIL (0x08)
+STATIC const uint8_t char_class_table[128] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 0, 0, 0, 0, 0, 0,
+    0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 0, 0, 12,
+    0, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 0, 0, 0, 0, 0,
+};
+
+// to easily parse utf-8 identifiers we allow any raw byte with high bit set
+STATIC uint8_t char_class(unichar c) {
+    if (c < 128) {
+        return char_class_table[c];
+    } else if (c != MP_LEXER_EOF) {
+        return CC_ID_HEAD | CC_ID_TAIL;
+    } else {
+        return 0;
+    }
+}
+
 STATIC bool is_whitespace(mp_lexer_t *lex) {
-    return unichar_isspace(lex->chr0);
+    return char_class(lex->chr0) & CC_SPACE;
 }
 
 STATIC bool is_letter(mp_lexer_t *lex) {
@@ -87,11 +114,11 @@ STATIC bool is_letter(mp_lexer_t *lex) {
 }
 
 STATIC bool is_digit(mp_lexer_t *lex) {
-    return unichar_isdigit(lex->chr0);
+    return char_class(lex->chr0) & CC_DIGIT;
 }
 
 STATIC bool is_following_digit(mp_lexer_t *lex) {
-    return unichar_isdigit(lex->chr1);
+    return char_class(lex->chr1) & CC_DIGIT;
 }
 
 STATIC bool is_following_base_char(mp_lexer_t *lex) {
@@ -110,13 +137,35 @@ STATIC bool is_string_or_bytes(mp_lexer_t *lex) {
             && is_char_following_following_or(lex, '\'', '\"'));
 }
 
-// to easily parse utf-8 identifiers we allow any raw byte with high bit set
 STATIC bool is_head_of_identifier(mp_lexer_t *lex) {
-    return is_letter(lex) || lex->chr0 == '_' || lex->chr0 >= 0x80;
+    return char_class(lex->chr0) & CC_ID_HEAD;
 }
 
 STATIC bool is_tail_of_identifier(mp_lexer_t *lex) {
-    return is_head_of_identifier(lex) || is_digit(lex);
+    return char_class(lex->chr0) & CC_ID_TAIL;
+}
+
+STATIC unichar read_block(mp_lexer_t *lex) {
+    if (lex->reader.readblock == NULL) {
+        return lex->reader.readbyte(lex->reader.data);
+    }
+    size_t len;
+    const byte *buf = lex->reader.readblock(lex->reader.data, &len);
+    if (len == 0) {
+        return MP_LEXER_EOF;
+    }
+    lex->block_cur = buf + 1;
+    lex->block_end = buf + len;
+    return buf[0];
+}
+
+// get the next byte from the source, only calling the reader when the current
+// block is used up
+STATIC unichar read_byte(mp_lexer_t *lex) {
+    if (lex->block_cur < lex->block_end) {
+        return *lex->block_cur++;
+    }
+    return read_block(lex);
 }
 
 STATIC void next_char(mp_lexer_t *lex) {
@@ -134,14 +183,14 @@ STATIC void next_char(mp_lexer_t *lex) {
 
     lex->chr0 = lex->chr1;
     lex->chr1 = lex->chr2;
-    lex->chr2 = lex->reader.readbyte(lex->reader.data);
+    lex->chr2 = read_byte(lex);
 
     if (lex->chr1 == '\r') {
         // CR is a new line, converted to LF
         lex->chr1 = '\n';
         if (lex->chr2 == '\n') {
             // CR LF is a single new line, throw out the extra LF
-            lex->chr2 = lex->reader.readbyte(lex->reader.data);
+            lex->chr2 = read_byte(lex);
         }
     }
 
@@ -209,7 +258,6 @@ STATIC const uint8_t tok_enc_kind[] = {
 };
 
 // must have the same order as enum in lexer.h
-// must be sorted according to strcmp
 STATIC const char *const tok_kw[] = {
     "False",
     "None",
@@ -251,6 +299,57 @@ STATIC const char *const tok_kw[] = {
     "yield",
 };
 
+// Perfect hash table of the keywords, indexed by tok_kw_hash(); entries are the
+// token kind of the keyword relative to MP_TOKEN_KW_FALSE, plus 1 (0 is empty)
+#define KW(tok) (MP_TOKEN_KW_##tok - MP_TOKEN_KW_FALSE + 1)
+STATIC const uint8_t tok_kw_table[128] = {
+    [0] = KW(BREAK),
+    [11] = KW(DEL),
+    [17] = KW(GLOBAL),
+    [25] = KW(FROM),
+    [26] = KW(NONLOCAL),
+    [29] = KW(LAMBDA),
+    [32] = KW(FINALLY),
+    [34] = KW(FALSE),
+    [37] = KW(IN),
+    #if MICROPY_PY_ASYNC_AWAIT
+    [39] = KW(ASYNC),
+    #endif
+    [41] = KW(NONE),
+    [42] = KW(TRY),
+    [47] = KW(TRUE),
+    [48] = KW(AND),
+    [50] = KW(RETURN),
+    [64] = KW(ELSE),
+    [66] = KW(CONTINUE),
+    [73] = KW(DEF),
+    [74] = KW(YIELD),
+    [75] = KW(ELIF),
+    [77] = KW(IF),
+    [78] = KW(RAISE),
+    [79] = KW(FOR),
+    [83] = KW(WHILE),
+    [84] = KW(AS),
+    [87] = KW(OR),
+    [89] = KW(CLASS),
+    [92] = KW(IS),
+    #if MICROPY_PY_ASYNC_AWAIT
+    [98] = KW(AWAIT),
+    #endif
+    [99] = KW(ASSERT),
+    [101] = KW(PASS),
+    [103] = KW(EXCEPT),
+    [107] = KW(IMPORT),
+    [109] = KW(NOT),
+    [115] = KW(WITH),
+    [125] = KW(__DEBUG__),
+};
+#undef KW
+
+STATIC size_t tok_kw_hash(const char *s, size_t len) {
+    return ((byte)s[0] + 11 * (byte)s[len - 1] + len) & 127;
+}
+
 // This is called with CUR_CHAR() before first hex digit, and should return with
 // it pointing to last hex digit
 // num_digits must be greater than zero
@@ -545,17 +644,11 @@ void mp_lexer_to_next(mp_lexer_t *lex) {
         // so the parser gives a syntax error on, eg, x.__debug__.  Otherwise, we
         // need to check for this special token in many places in the compiler.
         const char *s = vstr_null_terminated_str(&lex->vstr);
-        for (size_t i = 0; i < MP_ARRAY_SIZE(tok_kw); i++) {
-            int cmp = strcmp(s, tok_kw[i]);
-            if (cmp == 0) {
-                lex->tok_kind = MP_TOKEN_KW_FALSE + i;
-                if (lex->tok_kind == MP_TOKEN_KW___DEBUG__) {
-                    lex->tok_kind = (MP_STATE_VM(mp_optimise_value) == 0 ? MP_TOKEN_KW_TRUE : MP_TOKEN_KW_FALSE);
-                }
-                break;
-            } else if (cmp < 0) {
-                // Table is sorted and comparison was less-than, so stop searching
-                break;
+        size_t kw = tok_kw_table[tok_kw_hash(s, lex->vstr.len)];
+        if (kw != 0 && strcmp(s, tok_kw[kw - 1]) == 0) {
+            lex->tok_kind = MP_TOKEN_KW_FALSE + kw - 1;
+            if (lex->tok_kind == MP_TOKEN_KW___DEBUG__) {
+                lex->tok_kind = (MP_STATE_VM(mp_optimise_value) == 0 ? MP_TOKEN_KW_TRUE : MP_TOKEN_KW_FALSE);
             }
         }
 
@@ -672,6 +765,8 @@ mp_lexer_t *mp_lexer_new(qstr src_name, mp_reader_t reader) {
 
     lex->source_name = src_name;
     lex->reader = reader;
+    lex->block_cur = NULL;
+    lex->block_end = NULL;
     lex->line = 1;
     lex->column = (size_t)-2; // account for 3 dummy bytes
     lex->emit_dent = 0;
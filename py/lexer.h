@@ -148,6 +148,8 @@ typedef enum _mp_token_kind_t {
 typedef struct _mp_lexer_t {
     qstr source_name;           // name of source
     mp_reader_t reader;         // stream source
+    const byte *block_cur;      // current block of bytes from the source, if
+    const byte *block_end;      // the reader gives bytes in blocks
 
     unichar chr0, chr1, chr2;   // current cached characters from source
 
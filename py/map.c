@@ -76,13 +76,90 @@ STATIC size_t get_hash_alloc_greater_or_equal_to(size_t x) {
 /******************************************************************************/
 /* map                                                                        */
 
+#if MICROPY_PY_MAP_COMPACT
+
+// The table of a compact hash map is a single heap block holding, in order:
+//  - the array of alloc entries, which are used in insertion order; removed
+//    entries have their key set to MP_OBJ_SENTINEL and are reclaimed when
+//    the map is rehashed;
+//  - the number of entries used so far, including removed ones;
+//  - the number of index slots which are not MAP_INDEX_EMPTY, which can
+//    exceed the number of entries used when the last entry is reused;
+//  - the index table, which is probed by hash and holds MAP_INDEX_EMPTY,
+//    MAP_INDEX_DUMMY for a removed entry, or MAP_INDEX_FIRST plus the
+//    position of an entry.  It has a power of 2 number of slots, at most 2/3
+//    of which are in use, and each slot is 1, 2 or 4 bytes depending on alloc.
+
+#define MAP_INDEX_EMPTY (0)
+#define MAP_INDEX_DUMMY (1)
+#define MAP_INDEX_FIRST (2)
+
+STATIC size_t map_index_len(size_t alloc) {
+    size_t len = 4;
+    while (2 * len < 3 * alloc) {
+        len <<= 1;
+    }
+    return len;
+}
+
+STATIC size_t map_index_width(size_t alloc) {
+    if (alloc + MAP_INDEX_FIRST <= 0x100) {
+        return 1;
+    } else if (alloc + MAP_INDEX_FIRST <= 0x10000) {
+        return 2;
+    } else {
+        return 4;
+    }
+}
+
+STATIC size_t map_table_size(size_t alloc) {
+    if (alloc == 0) {
+        return 0;
+    }
+    return alloc * sizeof(mp_map_elem_t) + 2 * sizeof(size_t) + map_index_len(alloc) * map_index_width(alloc);
+}
+
+static inline size_t *map_filled(const mp_map_t *map) {
+    return (size_t*)&map->table[map->alloc];
+}
+
+static inline size_t map_index_get(const byte *index, size_t width, size_t pos) {
+    if (width == 1) {
+        return index[pos];
+    } else if (width == 2) {
+        return ((const uint16_t*)index)[pos];
+    } else {
+        return ((const uint32_t*)index)[pos];
+    }
+}
+
+static inline void map_index_set(byte *index, size_t width, size_t pos, size_t value) {
+    if (width == 1) {
+        index[pos] = value;
+    } else if (width == 2) {
+        ((uint16_t*)index)[pos] = value;
+    } else {
+        ((uint32_t*)index)[pos] = value;
+    }
+}
+
+#define MAP_TABLE_NEW(alloc) ((mp_map_elem_t*)m_new0(byte, map_table_size(alloc)))
+#define MAP_TABLE_DEL(table, alloc) m_del(byte, (table), map_table_size(alloc))
+
+#else
+
+#define MAP_TABLE_NEW(alloc) m_new0(mp_map_elem_t, (alloc))
+#define MAP_TABLE_DEL(table, alloc) m_del(mp_map_elem_t, (table), (alloc))
+
+#endif
+
 void mp_map_init(mp_map_t *map, size_t n) {
     if (n == 0) {
         map->alloc = 0;
         map->table = NULL;
     } else {
         map->alloc = n;
-        map->table = m_new0(mp_map_elem_t, map->alloc);
+        map->table = MAP_TABLE_NEW(map->alloc);
     }
     map->used = 0;
     map->all_keys_are_qstrs = 1;
@@ -102,14 +179,14 @@ void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table) {
 // Differentiate from mp_map_clear() - semantics is different
 void mp_map_deinit(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        MAP_TABLE_DEL(map->table, map->alloc);
     }
     map->used = map->alloc = 0;
 }
 
 void mp_map_clear(mp_map_t *map) {
     if (!map->is_fixed) {
-        m_del(mp_map_elem_t, map->table, map->alloc);
+        MAP_TABLE_DEL(map->table, map->alloc);
     }
     map->alloc = 0;
     map->used = 0;
@@ -118,6 +195,32 @@ void mp_map_clear(mp_map_t *map) {
     map->table = NULL;
 }
 
+#if MICROPY_PY_MAP_COMPACT
+
+// Copy the map into a new table, which drops removed entries, with enough
+// room to add a quarter more entries
+STATIC void mp_map_rehash(mp_map_t *map) {
+    size_t old_alloc = map->alloc;
+    size_t old_filled = old_alloc == 0 ? 0 : *map_filled(map);
+    size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->used + map->used / 4 + 1);
+    DEBUG_printf("mp_map_rehash(%p): " UINT_FMT " -> " UINT_FMT "\n", map, old_alloc, new_alloc);
+    mp_map_elem_t *old_table = map->table;
+    mp_map_elem_t *new_table = MAP_TABLE_NEW(new_alloc);
+    // If we reach this point, table resizing succeeded, now we can edit the old map.
+    map->alloc = new_alloc;
+    map->used = 0;
+    map->all_keys_are_qstrs = 1;
+    map->table = new_table;
+    for (size_t i = 0; i < old_filled; i++) {
+        if (old_table[i].key != MP_OBJ_SENTINEL) {
+            mp_map_lookup(map, old_table[i].key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = old_table[i].value;
+        }
+    }
+    MAP_TABLE_DEL(old_table, old_alloc);
+}
+
+#else
+
 STATIC void mp_map_rehash(mp_map_t *map) {
     size_t old_alloc = map->alloc;
     size_t new_alloc = get_hash_alloc_greater_or_equal_to(map->alloc + 1);
@@ -137,6 +240,30 @@ STATIC void mp_map_rehash(mp_map_t *map) {
     m_del(mp_map_elem_t, old_table, old_alloc);
 }
 
+#endif
+
+void mp_map_init_copy(mp_map_t *map, const mp_map_t *src) {
+    #if MICROPY_PY_MAP_COMPACT
+    if (src->is_ordered) {
+        // a fixed table has no index, so build one by adding each entry
+        mp_map_init(map, src->used);
+        for (size_t i = 0; i < src->used; i++) {
+            mp_map_lookup(map, src->table[i].key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = src->table[i].value;
+        }
+        return;
+    }
+    #endif
+    mp_map_init(map, src->alloc);
+    map->used = src->used;
+    map->all_keys_are_qstrs = src->all_keys_are_qstrs;
+    map->is_ordered = src->is_ordered;
+    #if MICROPY_PY_MAP_COMPACT
+    memcpy(map->table, src->table, map_table_size(src->alloc));
+    #else
+    memcpy(map->table, src->table, src->alloc * sizeof(mp_map_elem_t));
+    #endif
+}
+
 // MP_MAP_LOOKUP behaviour:
 //  - returns NULL if not found, else the slot it was found in with key,value non-null
 // MP_MAP_LOOKUP_ADD_IF_NOT_FOUND behaviour:
@@ -224,6 +351,75 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
         hash = MP_OBJ_SMALL_INT_VALUE(mp_unary_op(MP_UNARY_OP_HASH, index));
     }
 
+    #if MICROPY_PY_MAP_COMPACT
+
+    for (;;) {
+        size_t width = map_index_width(map->alloc);
+        size_t mask = map_index_len(map->alloc) - 1;
+        size_t *filled = map_filled(map);
+        size_t *index_used = filled + 1;
+        byte *index_table = (byte*)(filled + 2);
+        size_t pos = hash & mask;
+        size_t avail_pos = (size_t)-1;
+        // probe the same way as CPython, so that all the bits of the hash are used
+        for (mp_uint_t perturb = hash;; perturb >>= 5, pos = (pos * 5 + perturb + 1) & mask) {
+            size_t ix = map_index_get(index_table, width, pos);
+            if (ix == MAP_INDEX_EMPTY) {
+                break;
+            } else if (ix == MAP_INDEX_DUMMY) {
+                // found removed entry, remember for later
+                if (avail_pos == (size_t)-1) {
+                    avail_pos = pos;
+                }
+                continue;
+            }
+            mp_map_elem_t *elem = &map->table[ix - MAP_INDEX_FIRST];
+            if (elem->key == index || (!compare_only_ptrs && mp_obj_equal(elem->key, index))) {
+                // found index
+                // Note: CPython does not replace the index; try x={True:'true'};x[1]='one';x
+                if (lookup_kind == MP_MAP_LOOKUP_REMOVE_IF_FOUND) {
+                    // remove the entry; keep elem->value so that caller can access it if needed
+                    map->used--;
+                    map_index_set(index_table, width, pos, MAP_INDEX_DUMMY);
+                    if (ix - MAP_INDEX_FIRST == *filled - 1) {
+                        // the last entry can be reused straight away
+                        *filled -= 1;
+                        elem->key = MP_OBJ_NULL;
+                    } else {
+                        elem->key = MP_OBJ_SENTINEL;
+                    }
+                }
+                return elem;
+            }
+        }
+
+        // index is not in table
+        if (lookup_kind != MP_MAP_LOOKUP_ADD_IF_NOT_FOUND) {
+            return NULL;
+        }
+        if (*filled == map->alloc || (avail_pos == (size_t)-1 && *index_used == map->alloc)) {
+            // no room for a new entry, or the index would have more than 2/3
+            // of its slots in use, so rehash and search again
+            mp_map_rehash(map);
+            continue;
+        }
+        if (avail_pos == (size_t)-1) {
+            avail_pos = pos;
+            *index_used += 1;
+        }
+        map_index_set(index_table, width, avail_pos, MAP_INDEX_FIRST + *filled);
+        mp_map_elem_t *elem = &map->table[(*filled)++];
+        map->used++;
+        elem->key = index;
+        elem->value = MP_OBJ_NULL;
+        if (!mp_obj_is_qstr(index)) {
+            map->all_keys_are_qstrs = 0;
+        }
+        return elem;
+    }
+
+    #else
+
     size_t pos = hash % map->alloc;
     size_t start_pos = pos;
     mp_map_elem_t *avail_slot = NULL;
@@ -293,6 +489,8 @@ mp_map_elem_t *mp_map_lookup(mp_map_t *map, mp_obj_t index, mp_map_lookup_kind_t
             }
         }
     }
+
+    #endif
 }
 
 /******************************************************************************/
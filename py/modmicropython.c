@@ -47,6 +47,18 @@ STATIC mp_obj_t mp_micropython_opt_level(size_t n_args, const mp_obj_t *args) {
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_opt_level_obj, 0, 1, mp_micropython_opt_level);
 #endif
 
+#if MICROPY_PERSISTENT_CODE_CACHE
+STATIC mp_obj_t mp_micropython_import_cache(size_t n_args, const mp_obj_t *args) {
+    if (n_args == 0) {
+        return mp_obj_new_bool(MP_STATE_VM(mp_import_cache));
+    } else {
+        MP_STATE_VM(mp_import_cache) = mp_obj_is_true(args[0]);
+        return mp_const_none;
+    }
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_micropython_import_cache_obj, 0, 1, mp_micropython_import_cache);
+#endif
+
 #if MICROPY_PY_MICROPYTHON_MEM_INFO
 
 #if MICROPY_MEM_STATS
@@ -119,6 +131,11 @@ STATIC mp_obj_t mp_micropython_pystack_use(void) {
     return MP_OBJ_NEW_SMALL_INT(mp_pystack_usage());
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_pystack_use_obj, mp_micropython_pystack_use);
+
+STATIC mp_obj_t mp_micropython_pystack_peak(void) {
+    return MP_OBJ_NEW_SMALL_INT(MP_STATE_THREAD(pystack_peak));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_micropython_pystack_peak_obj, mp_micropython_pystack_peak);
 #endif
 
 #if MICROPY_ENABLE_GC
@@ -163,6 +180,9 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
     #if MICROPY_ENABLE_COMPILER
     { MP_ROM_QSTR(MP_QSTR_opt_level), MP_ROM_PTR(&mp_micropython_opt_level_obj) },
     #endif
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    { MP_ROM_QSTR(MP_QSTR_import_cache), MP_ROM_PTR(&mp_micropython_import_cache_obj) },
+    #endif
 #if MICROPY_PY_MICROPYTHON_MEM_INFO
 #if MICROPY_MEM_STATS
     { MP_ROM_QSTR(MP_QSTR_mem_total), MP_ROM_PTR(&mp_micropython_mem_total_obj) },
@@ -180,6 +200,7 @@ STATIC const mp_rom_map_elem_t mp_module_micropython_globals_table[] = {
 #endif
     #if MICROPY_ENABLE_PYSTACK
     { MP_ROM_QSTR(MP_QSTR_pystack_use), MP_ROM_PTR(&mp_micropython_pystack_use_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pystack_peak), MP_ROM_PTR(&mp_micropython_pystack_peak_obj) },
     #endif
     #if MICROPY_ENABLE_GC
     { MP_ROM_QSTR(MP_QSTR_heap_lock), MP_ROM_PTR(&mp_micropython_heap_lock_obj) },
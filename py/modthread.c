@@ -171,6 +171,11 @@ STATIC void *thread_entry(void *args_in) {
     mp_pystack_init(mini_pystack, &mini_pystack[128]);
     #endif
 
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // start with an empty type lookup cache
+    memset(ts.type_cache, 0, sizeof(ts.type_cache));
+    #endif
+
     // set locals and globals from the calling context
     mp_locals_set(args->dict_locals);
     mp_globals_set(args->dict_globals);
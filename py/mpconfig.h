@@ -272,6 +272,20 @@
 #define MICROPY_PERSISTENT_CODE_SAVE (0)
 #endif
 
+// Whether to support executing .mpy files that are in the in-place layout (as
+// written by "mpy-cross -minplace") directly from the memory that holds them,
+// eg memory-mapped flash, instead of copying their bytecode to the heap
+#ifndef MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+#define MICROPY_PERSISTENT_CODE_LOAD_INPLACE (0)
+#endif
+
+// Whether importing a .py file can compile it to a .mpy file next to it and
+// load that on later imports, while the size and mtime of the .py file are
+// unchanged (enabled at runtime with micropython.import_cache)
+#ifndef MICROPY_PERSISTENT_CODE_CACHE
+#define MICROPY_PERSISTENT_CODE_CACHE (0)
+#endif
+
 // Whether generated code can persist independently of the VM/runtime instance
 // This is enabled automatically when needed by other features
 #ifndef MICROPY_PERSISTENT_CODE
@@ -323,6 +337,14 @@
 #define MICROPY_EMIT_INLINE_XTENSA (0)
 #endif
 
+// Whether viper code supports a native float type (and ptrf32/ptrf64 pointers
+// to arrays of floats), computed with the FPU instead of with float objects.
+// Supported by the x64 emitter, and by the Thumb emitter for CPUs with a VFP
+// unit (eg Cortex-M4F), in which case mp_float_t must be single precision.
+#ifndef MICROPY_EMIT_NATIVE_FLOAT
+#define MICROPY_EMIT_NATIVE_FLOAT (0)
+#endif
+
 // Convenience definition for whether any native emitter is enabled
 #define MICROPY_EMIT_NATIVE (MICROPY_EMIT_X64 || MICROPY_EMIT_X86 || MICROPY_EMIT_THUMB || MICROPY_EMIT_ARM || MICROPY_EMIT_XTENSA)
 
@@ -393,6 +415,15 @@
 #define MICROPY_COMP_RETURN_IF_EXPR (0)
 #endif
 
+// Whether modules and scripts can be parsed, compiled and executed one top-level
+// statement at a time (see mp_parse_compile_execute_stream), so that the parse
+// tree of only one statement is in memory at once, instead of that of the whole
+// module.  A syntax error is then only raised once the statements before it
+// have been executed.
+#ifndef MICROPY_COMP_STREAM
+#define MICROPY_COMP_STREAM (0)
+#endif
+
 /*****************************************************************************/
 /* Internal debugging stuff                                                  */
 
@@ -446,12 +477,48 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether to cache the result of attribute lookups in user-defined classes,
+// keyed by (type, attr), so that repeated method and class attribute loads
+// skip the walk of locals_dict and the MRO.  Entries are invalidated by a
+// global epoch which is bumped on each class dict mutation and each GC.
+// The cache is per thread and uses 5 words of RAM for each entry.
+#ifndef MICROPY_OPT_CACHE_TYPE_LOOKUP
+#define MICROPY_OPT_CACHE_TYPE_LOOKUP (0)
+#endif
+
+// Number of entries in the type lookup cache; must be a power of 2
+#ifndef MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE
+#define MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE (32)
+#endif
+
+// Whether hash-table maps (and so dicts) use a compact layout: a dense array of
+// entries in insertion order, followed by a small table of 1, 2 or 4 byte
+// indices into it which is probed by hash.  Lookups don't degrade as the
+// table fills up, iteration is in insertion order (so OrderedDict uses the
+// same code as dict), but each map uses a few extra bytes for the indices.
+#ifndef MICROPY_PY_MAP_COMPACT
+#define MICROPY_PY_MAP_COMPACT (0)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (0)
 #endif
 
+// Whether to use fast algorithms to multiply large integers: Karatsuba
+// multiplication for operands of MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD or
+// more digits, a dedicated squaring routine, and Montgomery multiplication for
+// pow(a, b, m) with odd m.  Increases x86-64 code size by about 2700 bytes.
+#ifndef MICROPY_OPT_MPZ_MUL
+#define MICROPY_OPT_MPZ_MUL (0)
+#endif
+
+// Number of mpz digits at or above which multiplication uses Karatsuba's method.
+#ifndef MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD
+#define MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD (32)
+#endif
+
 
 // Whether math.factorial is large, fast and recursive (1) or small and slow (0).
 #ifndef MICROPY_OPT_MATH_FACTORIAL
@@ -478,11 +545,24 @@
 #define MICROPY_READER_VFS (0)
 #endif
 
+// Size of the buffer of the file readers; the lexer takes its input in blocks
+// of this size, so it is also the number of bytes per call to the filesystem
+#ifndef MICROPY_READER_BUF_SIZE
+#define MICROPY_READER_BUF_SIZE (128)
+#endif
+
 // Whether any readers have been defined
 #ifndef MICROPY_HAS_FILE_READER
 #define MICROPY_HAS_FILE_READER (MICROPY_READER_POSIX || MICROPY_READER_VFS)
 #endif
 
+// Whether mp_reader_map_file() is available to map a whole file into memory,
+// so that .mpy files in the in-place layout can be imported without a copy
+// (imports only use it without a VFS, when the path names a host file)
+#ifndef MICROPY_READER_MAP_FILE
+#define MICROPY_READER_MAP_FILE (MICROPY_PERSISTENT_CODE_LOAD_INPLACE && MICROPY_READER_POSIX)
+#endif
+
 // Hook for the VM at the start of the opcode loop (can contain variable
 // definitions usable by the other hook functions)
 #ifndef MICROPY_VM_HOOK_INIT
@@ -520,6 +600,18 @@
 #define MICROPY_PYSTACK_ALIGN (8)
 #endif
 
+// Whether the Python stack can grow into chunks allocated on the GC heap when
+// the region passed to mp_pystack_init is full.  This allows the static region
+// to be sized for typical use, rather than for the deepest call chain.
+#ifndef MICROPY_PYSTACK_GROW
+#define MICROPY_PYSTACK_GROW (0)
+#endif
+
+// Minimum number of bytes in each chunk that the Python stack grows into.
+#ifndef MICROPY_PYSTACK_CHUNK_SIZE
+#define MICROPY_PYSTACK_CHUNK_SIZE (512)
+#endif
+
 // Whether to check C stack usage. C stack used for calling Python functions,
 // etc. Not checking means segfault on overflow.
 #ifndef MICROPY_STACK_CHECK
@@ -655,6 +747,15 @@ typedef double mp_float_t;
 #define MICROPY_FLOAT_HIGH_QUALITY_HASH (0)
 #endif
 
+// Whether the VM stores the result of a float op in the float object that
+// holds the result of a previous op in the same expression, when that object
+// is only referenced from the VM stack.  Then "a * b + c" allocates one float
+// rather than two.  The compiler then emits BINARY_OP_TEMP for such ops, which
+// takes an extra byte.  Only has an effect if floats are allocated on the heap.
+#ifndef MICROPY_OPT_FLOAT_TEMP
+#define MICROPY_OPT_FLOAT_TEMP (0)
+#endif
+
 // Enable features which improve CPython compatibility
 // but may lead to more code size/memory usage.
 // TODO: Originally intended as generic category to not
@@ -1256,10 +1357,51 @@ typedef double mp_float_t;
 #define MICROPY_PY_UZLIB (0)
 #endif
 
+// Whether to provide uzlib.compress and uzlib.CompressIO (depends on MICROPY_PY_UZLIB)
+#ifndef MICROPY_PY_UZLIB_COMPRESS
+#define MICROPY_PY_UZLIB_COMPRESS (0)
+#endif
+
+// Size of the buffer in each uzlib.DecompIO that input is read into
+#ifndef MICROPY_PY_UZLIB_DECOMPIO_BUF_SIZE
+#define MICROPY_PY_UZLIB_DECOMPIO_BUF_SIZE (64)
+#endif
+
+// Number of uzlib.DecompIO windows to keep for reuse once their stream ends
+#ifndef MICROPY_PY_UZLIB_WINDOW_POOL
+#define MICROPY_PY_UZLIB_WINDOW_POOL (0)
+#endif
+
+// Whether CRC32, used by gzip streams and ubinascii.crc32, uses 4KB of
+// tables to process 4 bytes at a time
+#ifndef MICROPY_PY_UZLIB_CRC32_SLICE4
+#define MICROPY_PY_UZLIB_CRC32_SLICE4 (0)
+#endif
+
 #ifndef MICROPY_PY_UJSON
 #define MICROPY_PY_UJSON (0)
 #endif
 
+// Number of bytes that ujson.load reads from, and ujson.dump writes to, the
+// stream at a time
+#ifndef MICROPY_PY_UJSON_BUF_SIZE
+#define MICROPY_PY_UJSON_BUF_SIZE (64)
+#endif
+
+// Dict keys up to this length that are already interned as qstrs (eg because the
+// program uses them as names or string constants) are returned as those qstrs by
+// ujson.load, so they share storage.  New qstrs are never created for keys, as
+// they would never be freed.  Set to 0 to disable.
+#ifndef MICROPY_PY_UJSON_QSTR_KEY_LEN
+#define MICROPY_PY_UJSON_QSTR_KEY_LEN (0)
+#endif
+
+// Whether to provide ujson.iterload, which parses a stream into a sequence of
+// events without building the whole document
+#ifndef MICROPY_PY_UJSON_ITERLOAD
+#define MICROPY_PY_UJSON_ITERLOAD (0)
+#endif
+
 #ifndef MICROPY_PY_URE
 #define MICROPY_PY_URE (0)
 #endif
@@ -1280,6 +1422,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_URE_SUB (0)
 #endif
 
+// Number of compiled patterns that ure.compile and the module-level functions
+// keep for reuse, 0 to disable
+#ifndef MICROPY_PY_URE_CACHE
+#define MICROPY_PY_URE_CACHE (0)
+#endif
+
+// Whether ure uses a Pike VM, which matches in time linear in the length of
+// the input and without recursion, instead of a backtracking matcher
+#ifndef MICROPY_PY_URE_PIKEVM
+#define MICROPY_PY_URE_PIKEVM (0)
+#endif
+
 #ifndef MICROPY_PY_UHEAPQ
 #define MICROPY_PY_UHEAPQ (0)
 #endif
@@ -1289,6 +1443,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_UTIMEQ (0)
 #endif
 
+// Whether utimeq provides timerwheel, a timing wheel with O(1) push and cancel
+#ifndef MICROPY_PY_UTIMEQ_WHEEL
+#define MICROPY_PY_UTIMEQ_WHEEL (0)
+#endif
+
 #ifndef MICROPY_PY_UHASHLIB
 #define MICROPY_PY_UHASHLIB (0)
 #endif
@@ -1367,6 +1526,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_FRAMEBUF (0)
 #endif
 
+// Whether FrameBuffer tracks the region drawn to, returned by its dirty() method
+#ifndef MICROPY_PY_FRAMEBUF_DIRTY
+#define MICROPY_PY_FRAMEBUF_DIRTY (0)
+#endif
+
 #ifndef MICROPY_PY_BTREE
 #define MICROPY_PY_BTREE (0)
 #endif
@@ -1585,5 +1749,16 @@ typedef double mp_float_t;
 #error "MICROPY_PY_SYS_SETTRACE requires MICROPY_COMP_CONST to be disabled"
 #endif
 #endif
+#if MICROPY_COMP_STREAM && MICROPY_ENABLE_DOC_STRING
+#error "MICROPY_COMP_STREAM requires MICROPY_ENABLE_DOC_STRING to be disabled"
+#endif
+#if MICROPY_PERSISTENT_CODE_CACHE
+#if !(MICROPY_VFS && MICROPY_PERSISTENT_CODE_LOAD && MICROPY_PERSISTENT_CODE_SAVE && MICROPY_ENABLE_COMPILER)
+#error "MICROPY_PERSISTENT_CODE_CACHE requires MICROPY_VFS, MICROPY_PERSISTENT_CODE_LOAD/SAVE and the compiler"
+#endif
+#endif
+#if MICROPY_OPT_CACHE_TYPE_LOOKUP && (MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE & (MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE - 1))
+#error "MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE must be a power of 2"
+#endif
 
 #endif // MICROPY_INCLUDED_PY_MPCONFIG_H
@@ -47,6 +47,7 @@ typedef struct mp_dynamic_compiler_t {
     bool opt_cache_map_lookup_in_bytecode;
     bool py_builtins_str_unicode;
     uint8_t native_arch;
+    bool persistent_code_inplace;
 } mp_dynamic_compiler_t;
 extern mp_dynamic_compiler_t mp_dynamic_compiler;
 #endif
@@ -61,6 +62,15 @@ typedef struct _mp_sched_item_t {
     mp_obj_t arg;
 } mp_sched_item_t;
 
+// Entry in the cache of class attribute lookups, see MICROPY_OPT_CACHE_TYPE_LOOKUP.
+typedef struct _mp_type_cache_entry_t {
+    const mp_obj_type_t *type;
+    const mp_obj_type_t *found_type;
+    mp_obj_t value;
+    size_t epoch;
+    qstr attr;
+} mp_type_cache_entry_t;
+
 // This structure hold information about the memory allocation system.
 typedef struct _mp_state_mem_t {
     #if MICROPY_MEM_STATS
@@ -183,6 +193,15 @@ typedef struct _mp_state_vm_t {
     mp_obj_t lwip_slip_stream;
     #endif
 
+    #if MICROPY_PY_URE && MICROPY_PY_URE_CACHE
+    mp_obj_t ure_cache[MICROPY_PY_URE_CACHE];
+    #endif
+
+    #if MICROPY_PY_UZLIB && MICROPY_PY_UZLIB_WINDOW_POOL
+    byte *uzlib_window_pool[MICROPY_PY_UZLIB_WINDOW_POOL];
+    size_t uzlib_window_pool_size[MICROPY_PY_UZLIB_WINDOW_POOL];
+    #endif
+
     #if MICROPY_VFS
     struct _mp_vfs_mount_t *vfs_cur;
     struct _mp_vfs_mount_t *vfs_mount_table;
@@ -203,8 +222,16 @@ typedef struct _mp_state_vm_t {
     mp_thread_mutex_t qstr_mutex;
     #endif
 
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // entries of all type lookup caches are invalid unless they match this
+    size_t type_cache_epoch;
+    #endif
+
     #if MICROPY_ENABLE_COMPILER
     mp_uint_t mp_optimise_value;
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    bool mp_import_cache;
+    #endif
     #if MICROPY_EMIT_NATIVE
     uint8_t default_emit_opt; // one of MP_EMIT_OPT_xxx
     #endif
@@ -241,6 +268,18 @@ typedef struct _mp_state_thread_t {
     uint8_t *pystack_start;
     uint8_t *pystack_end;
     uint8_t *pystack_cur;
+    // high-water mark of the pystack usage, in bytes
+    size_t pystack_peak;
+    #if MICROPY_PYSTACK_GROW
+    // number of bytes in use in the regions below the current one
+    size_t pystack_base;
+    #endif
+    #endif
+
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // Cache of class attribute lookups.  It is outside the root pointer
+    // section because all entries are invalidated at the start of a GC.
+    mp_type_cache_entry_t type_cache[MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE];
     #endif
 
     ////////////////////////////////////////////////////////////
@@ -254,6 +293,12 @@ typedef struct _mp_state_thread_t {
 
     nlr_buf_t *nlr_top;
 
+    #if MICROPY_PYSTACK_GROW
+    // heap chunks that the pystack has grown into, and a spare one for reuse
+    struct _mp_pystack_chunk_t *pystack_chunk;
+    struct _mp_pystack_chunk_t *pystack_spare;
+    #endif
+
     #if MICROPY_PY_SYS_SETTRACE
     mp_obj_t prof_trace_callback;
     bool prof_callback_is_executing;
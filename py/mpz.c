@@ -449,6 +449,230 @@ STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
     return ilen;
 }
 
+#if MICROPY_OPT_MPZ_MUL
+
+#define KARATSUBA_THRESHOLD (MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD)
+
+// the recursion needs the operand sizes to shrink, which they do above 3 digits
+#if KARATSUBA_THRESHOLD < 4
+#error "MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD must be at least 4"
+#endif
+
+/* computes i = j * j
+   assumes enough memory in i (2 * jlen digits); assumes i is zeroed
+   j need not be normalised; the result is not normalised
+*/
+STATIC void mpn_sqr(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen) {
+    if (jlen == 0) {
+        return;
+    }
+
+    // sum of the cross products j[a] * j[b] for a < b, computed only once
+    for (size_t a = 0; a + 1 < jlen; ++a) {
+        mpz_dbl_dig_t carry = 0;
+        mpz_dbl_dig_t ja = jdig[a];
+        for (size_t b = a + 1; b < jlen; ++b) {
+            carry += (mpz_dbl_dig_t)idig[a + b] + ja * (mpz_dbl_dig_t)jdig[b];
+            idig[a + b] = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        idig[a + jlen] = carry;
+    }
+
+    // double the cross products and add in the squares on the diagonal
+    mpz_dig_t msb = 0;
+    mpz_dbl_dig_t carry = 0;
+    for (size_t a = 0; a < jlen; ++a) {
+        mpz_dig_t lo = idig[2 * a];
+        mpz_dig_t hi = idig[2 * a + 1];
+        mpz_dig_t lo2 = ((lo << 1) | msb) & DIG_MASK;
+        mpz_dig_t hi2 = ((hi << 1) | (lo >> (DIG_SIZE - 1))) & DIG_MASK;
+        msb = hi >> (DIG_SIZE - 1);
+        carry += (mpz_dbl_dig_t)lo2 + (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)jdig[a];
+        idig[2 * a] = carry & DIG_MASK;
+        carry = (carry >> DIG_SIZE) + hi2;
+        idig[2 * a + 1] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+}
+
+/* computes i += j, where i has ilen digits and j has jlen <= ilen digits
+   returns the carry out of the top of i
+*/
+STATIC mpz_dig_t mpn_add_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_t carry = 0;
+    ilen -= jlen;
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        carry += (mpz_dbl_dig_t)*idig + (mpz_dbl_dig_t)*jdig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+    for (; carry != 0 && ilen > 0; --ilen, ++idig) {
+        carry += *idig;
+        *idig = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+    return carry;
+}
+
+/* computes i -= j, where i has ilen digits and j has jlen <= ilen digits
+   assumes i >= j
+*/
+STATIC void mpn_sub_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_signed_t borrow = 0;
+    ilen -= jlen;
+    for (; jlen > 0; --jlen, ++idig, ++jdig) {
+        borrow += (mpz_dbl_dig_t)*idig - (mpz_dbl_dig_t)*jdig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+    for (; borrow != 0 && ilen > 0; --ilen, ++idig) {
+        borrow += *idig;
+        *idig = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+}
+
+// returns the number of scratch digits needed by mpn_mul_rec for operands of
+// at most len digits
+STATIC size_t mpn_mul_tmp_len(size_t len) {
+    // room for a chunk product when the operands are unbalanced
+    size_t tmp = 2 * len;
+    while (len >= KARATSUBA_THRESHOLD) {
+        size_t h = (len + 1) / 2;
+        tmp += 4 * h + 4;
+        len = h + 1;
+    }
+    return tmp;
+}
+
+/* computes i = j * k, using Karatsuba multiplication for large operands
+   assumes enough memory in i (jlen + klen digits); assumes i is zeroed
+   assumes tmp has mpn_mul_tmp_len(max(jlen, klen)) digits
+   j, k need not be normalised; the result is not normalised
+   squares j if j and k are the same
+*/
+STATIC void mpn_mul_rec(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen, mpz_dig_t *tmp) {
+    if (jlen < klen) {
+        const mpz_dig_t *d = jdig; jdig = kdig; kdig = d;
+        size_t l = jlen; jlen = klen; klen = l;
+    }
+
+    bool sqr = jdig == kdig && jlen == klen;
+
+    if (klen < KARATSUBA_THRESHOLD) {
+        // schoolbook
+        if (sqr) {
+            mpn_sqr(idig, jdig, jlen);
+        } else if (klen > 0) {
+            mpn_mul(idig, (mpz_dig_t*)jdig, jlen, (mpz_dig_t*)kdig, klen);
+        }
+        return;
+    }
+
+    size_t h = (jlen + 1) / 2;
+
+    if (klen <= h) {
+        // unbalanced: multiply k by successive klen-digit chunks of j
+        mpz_dig_t *prod = tmp;
+        tmp += 2 * klen;
+        for (size_t off = 0; off < jlen; off += klen) {
+            size_t n = MIN(klen, jlen - off);
+            memset(prod, 0, (n + klen) * sizeof(mpz_dig_t));
+            mpn_mul_rec(prod, jdig + off, n, kdig, klen, tmp);
+            mpn_add_inpl(idig + off, jlen + klen - off, prod, n + klen);
+        }
+        return;
+    }
+
+    // split j = j1*B^h + j0 and k = k1*B^h + k0, then
+    //   j * k = z2*B^2h + (z1 - z2 - z0)*B^h + z0
+    // where z2 = j1*k1, z0 = j0*k0 and z1 = (j1 + j0)*(k1 + k0)
+    mpn_mul_rec(idig, jdig, h, kdig, h, tmp);
+    mpn_mul_rec(idig + 2 * h, jdig + h, jlen - h, kdig + h, klen - h, tmp);
+
+    mpz_dig_t *sj = tmp;
+    mpz_dig_t *sk = sj + h + 1;
+    mpz_dig_t *z1 = sk + h + 1;
+    tmp = z1 + 2 * h + 2;
+
+    memcpy(sj, jdig, h * sizeof(mpz_dig_t));
+    sj[h] = mpn_add_inpl(sj, h, jdig + h, jlen - h);
+    if (sqr) {
+        sk = sj;
+    } else {
+        memcpy(sk, kdig, h * sizeof(mpz_dig_t));
+        sk[h] = mpn_add_inpl(sk, h, kdig + h, klen - h);
+    }
+    memset(z1, 0, (2 * h + 2) * sizeof(mpz_dig_t));
+    mpn_mul_rec(z1, sj, h + 1, sk, h + 1, tmp);
+
+    mpn_sub_inpl(z1, 2 * h + 2, idig, 2 * h);
+    mpn_sub_inpl(z1, 2 * h + 2, idig + 2 * h, jlen + klen - 2 * h);
+    mpn_add_inpl(idig + h, jlen + klen - h, z1, MIN(2 * h + 2, jlen + klen - h));
+}
+
+/* computes i = j * k, choosing the fastest method for the sizes of j and k
+   returns number of digits in i
+   assumes enough memory in i; assumes i is zeroed; assumes normalised j, k
+   can have j, k point to same memory
+*/
+STATIC size_t mpn_mul_fast(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *kdig, size_t klen) {
+    if (jlen < KARATSUBA_THRESHOLD || klen < KARATSUBA_THRESHOLD) {
+        if (jdig == kdig && jlen == klen) {
+            mpn_sqr(idig, jdig, jlen);
+            return mpn_remove_trailing_zeros(idig, idig + 2 * jlen);
+        }
+        return mpn_mul(idig, jdig, jlen, kdig, klen);
+    }
+
+    size_t tmp_len = mpn_mul_tmp_len(MAX(jlen, klen));
+    mpz_dig_t *tmp = m_new(mpz_dig_t, tmp_len);
+    mpn_mul_rec(idig, jdig, jlen, kdig, klen, tmp);
+    m_del(mpz_dig_t, tmp, tmp_len);
+    return mpn_remove_trailing_zeros(idig, idig + jlen + klen);
+}
+
+/* computes i = j * k / R mod m, where R = B^mlen (Montgomery multiplication)
+   assumes j, k < m, with mlen digits (not normalised); assumes normalised, odd m
+   assumes t has 2 * mlen + 1 digits and tmp has mpn_mul_tmp_len(mlen) digits
+   minv is -1/m mod B; can have i, j, k point to same memory
+*/
+STATIC void mpn_mont_mul(mpz_dig_t *idig, const mpz_dig_t *jdig, const mpz_dig_t *kdig,
+    const mpz_dig_t *mdig, size_t mlen, mpz_dig_t minv, mpz_dig_t *t, mpz_dig_t *tmp) {
+    memset(t, 0, (2 * mlen + 1) * sizeof(mpz_dig_t));
+    mpn_mul_rec(t, jdig, mlen, kdig, mlen, tmp);
+
+    // reduce: add multiples of m to clear the low mlen digits of t
+    for (size_t a = 0; a < mlen; ++a) {
+        mpz_dbl_dig_t u = ((mpz_dbl_dig_t)t[a] * (mpz_dbl_dig_t)minv) & DIG_MASK;
+        mpz_dbl_dig_t carry = 0;
+        for (size_t b = 0; b < mlen; ++b) {
+            carry += (mpz_dbl_dig_t)t[a + b] + u * (mpz_dbl_dig_t)mdig[b];
+            t[a + b] = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+        for (size_t c = a + mlen; carry != 0; ++c) {
+            carry += t[c];
+            t[c] = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+    }
+
+    // the result is now in the top mlen + 1 digits of t, and is less than 2m
+    t += mlen;
+    if (t[mlen] != 0 || mpn_cmp(t, mpn_remove_trailing_zeros(t, t + mlen), mdig, mlen) >= 0) {
+        mpn_sub_inpl(t, mlen + 1, mdig, mlen);
+    }
+    memcpy(idig, t, mlen * sizeof(mpz_dig_t));
+}
+
+#else
+
+#define mpn_mul_fast mpn_mul
+
+#endif
+
 /* natural_div - quo * den + new_num = old_num (ie num is replaced with rem)
    assumes den != 0
    assumes num_dig has enough memory to be extended by 1 digit
@@ -523,60 +747,37 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
         quo /= lead_den_digit;
 
         // Multiply quo by den and subtract from num to get remainder.
-        // We have different code here to handle different compile-time
-        // configurations of mpz:
-        //
-        //   1. DIG_SIZE is stricly less than half the number of bits
-        //      available in mpz_dbl_dig_t.  In this case we can use a
-        //      slightly more optimal (in time and space) routine that
-        //      uses the extra bits in mpz_dbl_dig_signed_t to store a
-        //      sign bit.
-        //
-        //   2. DIG_SIZE is exactly half the number of bits available in
-        //      mpz_dbl_dig_t.  In this (common) case we need to be careful
-        //      not to overflow the borrow variable.  And the shifting of
-        //      borrow needs some special logic (it's a shift right with
-        //      round up).
-        //
+        // Must be careful with overflow of the borrow variable.  Both
+        // borrow and low_digs are signed values and need signed right-shift,
+        // but x is unsigned and may take a full-range value.
         const mpz_dig_t *d = den_dig;
         mpz_dbl_dig_t d_norm = 0;
-        mpz_dbl_dig_t borrow = 0;
+        mpz_dbl_dig_signed_t borrow = 0;
         for (mpz_dig_t *n = num_dig - den_len; n < num_dig; ++n, ++d) {
+            // Get the next digit in (den).
             d_norm = ((mpz_dbl_dig_t)*d << norm_shift) | (d_norm >> DIG_SIZE);
+            // Multiply the next digit in (quo * den).
             mpz_dbl_dig_t x = (mpz_dbl_dig_t)quo * (d_norm & DIG_MASK);
-            #if DIG_SIZE < MPZ_DBL_DIG_SIZE / 2
-            borrow += (mpz_dbl_dig_t)*n - x; // will overflow if DIG_SIZE >= MPZ_DBL_DIG_SIZE/2
-            *n = borrow & DIG_MASK;
-            borrow = (mpz_dbl_dig_signed_t)borrow >> DIG_SIZE;
-            #else // DIG_SIZE == MPZ_DBL_DIG_SIZE / 2
-            if (x >= *n || *n - x <= borrow) {
-                borrow += x - (mpz_dbl_dig_t)*n;
-                *n = (-borrow) & DIG_MASK;
-                borrow = (borrow >> DIG_SIZE) + ((borrow & DIG_MASK) == 0 ? 0 : 1); // shift-right with round-up
-            } else {
-                *n = ((mpz_dbl_dig_t)*n - x - borrow) & DIG_MASK;
-                borrow = 0;
-            }
-            #endif
+            // Compute the low DIG_MASK bits of the next digit in (num - quo * den)
+            mpz_dbl_dig_signed_t low_digs = (borrow & DIG_MASK) + *n - (x & DIG_MASK);
+            // Store the digit result for (num).
+            *n = low_digs & DIG_MASK;
+            // Compute the borrow, shifted right before summing to avoid overflow.
+            borrow = (borrow >> DIG_SIZE) - (x >> DIG_SIZE) + (low_digs >> DIG_SIZE);
         }
 
-        #if DIG_SIZE < MPZ_DBL_DIG_SIZE / 2
-        // Borrow was negative in the above for-loop, make it positive for next if-block.
-        borrow = -borrow;
-        #endif
-
         // At this point we have either:
         //
         //   1. quo was the correct value and the most-sig-digit of num is exactly
-        //      cancelled by borrow (borrow == *num_dig).  In this case there is
+        //      cancelled by borrow (borrow + *num_dig == 0).  In this case there is
         //      nothing more to do.
         //
         //   2. quo was too large, we subtracted too many den from num, and the
-        //      most-sig-digit of num is 1 less than borrow (borrow == *num_dig + 1).
+        //      most-sig-digit of num is less than needed (borrow + *num_dig < 0).
         //      In this case we must reduce quo and add back den to num until the
         //      carry from this operation cancels out the borrow.
         //
-        borrow -= *num_dig;
+        borrow += *num_dig;
         for (; borrow != 0; --quo) {
             d = den_dig;
             d_norm = 0;
@@ -587,7 +788,7 @@ STATIC void mpn_div(mpz_dig_t *num_dig, size_t *num_len, const mpz_dig_t *den_di
                 *n = carry & DIG_MASK;
                 carry >>= DIG_SIZE;
             }
-            borrow -= carry;
+            borrow += carry;
         }
 
         // store this digit of the quotient
@@ -840,41 +1041,169 @@ typedef uint32_t mp_float_int_t;
 }
 #endif
 
-// returns number of bytes from str that were processed
-size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
-    assert(base <= 36);
-
-    const char *cur = str;
-    const char *top = str + len;
+// returns log2(base) if base is a power of 2, otherwise 0
+STATIC unsigned int mpz_base_pow2_bits(unsigned int base) {
+    if ((base & (base - 1)) != 0) {
+        return 0;
+    }
+    unsigned int bits = 0;
+    while (base > 1) {
+        base >>= 1;
+        ++bits;
+    }
+    return bits;
+}
 
-    mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+// returns the largest n such that base**n fits in a digit, and sets *pow to base**n
+STATIC size_t mpz_base_chunk(unsigned int base, mpz_dig_t *pow) {
+    size_t n = 1;
+    mpz_dbl_dig_t p = base;
+    while (p * base <= DIG_MASK) {
+        p *= base;
+        ++n;
+    }
+    *pow = p;
+    return n;
+}
 
-    if (neg) {
-        z->neg = 1;
+STATIC unsigned int mpz_char_value(char c) {
+    unsigned int v = (unsigned char)c;
+    if ('0' <= v && v <= '9') {
+        v -= '0';
+    } else if ('A' <= v && v <= 'Z') {
+        v -= 'A' - 10;
+    } else if ('a' <= v && v <= 'z') {
+        v -= 'a' - 10;
     } else {
-        z->neg = 0;
+        v = 36;
     }
+    return v;
+}
 
+/* sets z = the value of the len digits in str, which must all be valid
+   assumes z has enough memory and is not negative
+*/
+STATIC void mpz_set_from_digits(mpz_t *z, const char *str, size_t len, unsigned int base) {
+    const char *top = str + len;
     z->len = 0;
-    for (; cur < top; ++cur) { // XXX UTF8 next char
-        //mp_uint_t v = char_to_numeric(cur#); // XXX UTF8 get char
-        mp_uint_t v = *cur;
-        if ('0' <= v && v <= '9') {
-            v -= '0';
-        } else if ('A' <= v && v <= 'Z') {
-            v -= 'A' - 10;
-        } else if ('a' <= v && v <= 'z') {
-            v -= 'a' - 10;
+
+    unsigned int bits = mpz_base_pow2_bits(base);
+    if (bits != 0) {
+        // power-of-2 base: pack the bits of each character into digits, from the end
+        mpz_dig_t *d = z->dig;
+        mpz_dbl_dig_t acc = 0;
+        unsigned int acc_bits = 0;
+        while (top > str) {
+            acc |= (mpz_dbl_dig_t)mpz_char_value(*--top) << acc_bits;
+            acc_bits += bits;
+            if (acc_bits >= DIG_SIZE) {
+                *d++ = acc & DIG_MASK;
+                acc >>= DIG_SIZE;
+                acc_bits -= DIG_SIZE;
+            }
+        }
+        *d++ = acc;
+        z->len = mpn_remove_trailing_zeros(z->dig, d);
+        return;
+    }
+
+    // other bases: accumulate as many characters as fit in a digit, and then
+    // multiply them into z in one pass
+    mpz_dig_t chunk_pow;
+    size_t chunk_len = mpz_base_chunk(base, &chunk_pow);
+    size_t n = len % chunk_len;
+    if (n == 0) {
+        n = chunk_len;
+    }
+    mpz_dig_t mul = 1;
+    for (; str < top; n = chunk_len, mul = chunk_pow) {
+        mpz_dig_t val = 0;
+        for (; n > 0; --n) {
+            val = val * base + mpz_char_value(*str++);
+        }
+        if (z->len == 0) {
+            if (val != 0) {
+                z->dig[0] = val;
+                z->len = 1;
+            }
         } else {
-            break;
+            z->len = mpn_mul_dig_add_dig(z->dig, z->len, mul, val);
         }
-        if (v >= base) {
-            break;
+    }
+}
+
+#if MICROPY_OPT_MPZ_MUL
+/* sets z = the value of the len digits in str, which must all be valid, by
+   splitting str in two and combining the halves with pows[level] (which is
+   base ** (leaf_len << level)), so the work is done by large multiplications
+*/
+STATIC void mpz_set_from_digits_rec(mpz_t *z, const char *str, size_t len, unsigned int base,
+    mpz_t *pows, size_t level, size_t leaf_len) {
+    if (len <= leaf_len) {
+        mpz_need_dig(z, len * 8 / DIG_SIZE + 1);
+        mpz_set_from_digits(z, str, len, base);
+        return;
+    }
+    while ((leaf_len << level) >= len) {
+        --level;
+    }
+    size_t lo_len = leaf_len << level;
+    mpz_t lo;
+    mpz_init_zero(&lo);
+    mpz_set_from_digits_rec(z, str, len - lo_len, base, pows, level, leaf_len);
+    mpz_set_from_digits_rec(&lo, str + len - lo_len, lo_len, base, pows, level, leaf_len);
+    mpz_mul_inpl(z, z, &pows[level]);
+    mpz_add_inpl(z, z, &lo);
+    mpz_deinit(&lo);
+}
+#endif
+
+// returns number of bytes from str that were processed
+size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
+    assert(base <= 36);
+
+    // find the run of valid digits
+    size_t n = 0;
+    while (n < len && mpz_char_value(str[n]) < base) { // XXX UTF8 next char
+        ++n;
+    }
+
+    #if MICROPY_OPT_MPZ_MUL
+    // use divide-and-conquer once it beats the single-digit multiply passes,
+    // which (measured on x64) is when the leaves are about 16 times the size
+    // where Karatsuba multiplication starts
+    mpz_dig_t chunk_pow;
+    size_t leaf_len = mpz_base_chunk(base, &chunk_pow) * MICROPY_OPT_MPZ_MUL_KARATSUBA_THRESHOLD * 16;
+    if (mpz_base_pow2_bits(base) == 0 && n > 2 * leaf_len) {
+        size_t num_pows = 0;
+        while ((leaf_len << num_pows) < n) {
+            ++num_pows;
+        }
+        mpz_t *pows = m_new(mpz_t, num_pows);
+        mpz_init_from_int(&pows[0], base);
+        mpz_t b;
+        mpz_init_from_int(&b, leaf_len);
+        mpz_pow_inpl(&pows[0], &pows[0], &b);
+        mpz_deinit(&b);
+        for (size_t i = 1; i < num_pows; ++i) {
+            mpz_init_zero(&pows[i]);
+            mpz_mul_inpl(&pows[i], &pows[i - 1], &pows[i - 1]);
+        }
+        mpz_set_from_digits_rec(z, str, n, base, pows, num_pows, leaf_len);
+        for (size_t i = 0; i < num_pows; ++i) {
+            mpz_deinit(&pows[i]);
         }
-        z->len = mpn_mul_dig_add_dig(z->dig, z->len, base, v);
+        m_del(mpz_t, pows, num_pows);
+        z->neg = neg && z->len != 0;
+        return n;
     }
+    #endif
+
+    mpz_need_dig(z, n * 8 / DIG_SIZE + 1);
+    mpz_set_from_digits(z, str, n, base);
+    z->neg = neg && z->len != 0;
 
-    return cur - str;
+    return n;
 }
 
 void mpz_set_from_bytes(mpz_t *z, bool big_endian, size_t len, const byte *buf) {
@@ -1314,7 +1643,7 @@ void mpz_mul_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
 
     mpz_need_dig(dest, lhs->len + rhs->len); // min mem l+r-1, max mem l+r
     memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
-    dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    dest->len = mpn_mul_fast(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
 
     if (lhs->neg == rhs->neg) {
         dest->neg = 0;
@@ -1359,6 +1688,70 @@ void mpz_pow_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
     mpz_free(n);
 }
 
+#if MICROPY_OPT_MPZ_MUL
+/* computes dest = (lhs ** rhs) % mod using Montgomery multiplication
+   assumes rhs > 0 and mod > 1 is odd
+*/
+STATIC void mpz_pow3_mont(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t *mod) {
+    size_t mlen = mod->len;
+    const mpz_dig_t *mdig = mod->dig;
+
+    // minv = -1/m mod B, by Newton's iteration which doubles the correct bits each time
+    mpz_dbl_dig_t inv = 1;
+    for (size_t bits = 1; bits < DIG_SIZE; bits *= 2) {
+        inv = (inv * (2 - (mpz_dbl_dig_t)mdig[0] * inv)) & DIG_MASK;
+    }
+    mpz_dig_t minv = (0 - inv) & DIG_MASK;
+
+    // convert the base and 1 to Montgomery form, ie multiplied by R mod m
+    mpz_t x, one, quo;
+    mpz_init_zero(&x);
+    mpz_init_zero(&quo);
+    mpz_init_from_int(&one, 1);
+    mpz_divmod_inpl(&quo, &x, lhs, mod);
+    mpz_shl_inpl(&x, &x, mlen * DIG_SIZE);
+    mpz_divmod_inpl(&quo, &x, &x, mod);
+    mpz_shl_inpl(&one, &one, mlen * DIG_SIZE);
+    mpz_divmod_inpl(&quo, &one, &one, mod);
+    mpz_deinit(&quo);
+
+    size_t tmp_len = 4 * mlen + 1 + mpn_mul_tmp_len(mlen);
+    mpz_dig_t *xd = m_new0(mpz_dig_t, tmp_len);
+    mpz_dig_t *acc = xd + mlen;
+    mpz_dig_t *t = acc + mlen;
+    mpz_dig_t *tmp = t + 2 * mlen + 1;
+    memcpy(xd, x.dig, x.len * sizeof(mpz_dig_t));
+    memcpy(acc, one.dig, one.len * sizeof(mpz_dig_t));
+    mpz_deinit(&x);
+    mpz_deinit(&one);
+
+    // right-to-left binary exponentiation
+    for (size_t i = 0; i < rhs->len; ++i) {
+        mpz_dig_t d = rhs->dig[i];
+        for (size_t b = 0; b < DIG_SIZE; ++b, d >>= 1) {
+            if (d & 1) {
+                mpn_mont_mul(acc, acc, xd, mdig, mlen, minv, t, tmp);
+            }
+            if (i + 1 == rhs->len && (d >> 1) == 0) {
+                break;
+            }
+            mpn_mont_mul(xd, xd, xd, mdig, mlen, minv, t, tmp);
+        }
+    }
+
+    // convert the result out of Montgomery form
+    memset(xd, 0, mlen * sizeof(mpz_dig_t));
+    xd[0] = 1;
+    mpn_mont_mul(acc, acc, xd, mdig, mlen, minv, t, tmp);
+
+    mpz_need_dig(dest, mlen);
+    memcpy(dest->dig, acc, mlen * sizeof(mpz_dig_t));
+    dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + mlen);
+    dest->neg = 0;
+    m_del(mpz_dig_t, xd, tmp_len);
+}
+#endif
+
 /* computes dest = (lhs ** rhs) % mod
    can have dest, lhs, rhs the same; mod can't be the same as dest
 */
@@ -1374,6 +1767,13 @@ void mpz_pow3_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t
         return;
     }
 
+    #if MICROPY_OPT_MPZ_MUL
+    if (!mod->neg && mod->len > 0 && (mod->dig[0] & 1) != 0) {
+        mpz_pow3_mont(dest, lhs, rhs, mod);
+        return;
+    }
+    #endif
+
     mpz_t *x = mpz_clone(lhs);
     mpz_t *n = mpz_clone(rhs);
     mpz_t quo; mpz_init_zero(&quo);
@@ -1667,48 +2067,73 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
         return s - str;
     }
 
-    // make a copy of mpz digits, so we can do the div/mod calculation
-    mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
-    memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
-
-    // convert
+    // convert, generating the characters in reverse order
     char *last_comma = str;
-    bool done;
-    do {
-        mpz_dig_t *d = dig + ilen;
-        mpz_dbl_dig_t a = 0;
-
-        // compute next remainder
-        while (--d >= dig) {
-            a = (a << DIG_SIZE) | *d;
-            *d = a / base;
-            a %= base;
+    #define EMIT_CHAR(v) do { \
+        char c = '0' + (v); \
+        if (c > '9') { \
+            c += base_char - '9' - 1; \
+        } \
+        *s++ = c; \
+        if (comma && (s - last_comma) == 3) { \
+            *s++ = comma; \
+            last_comma = s; \
+        } \
+    } while (0)
+
+    unsigned int bits = mpz_base_pow2_bits(base);
+    if (bits != 0) {
+        // power-of-2 base: take the characters straight from the bits
+        const mpz_dig_t *dig = i->dig;
+        size_t num_bits = (ilen - 1) * DIG_SIZE;
+        for (mpz_dig_t d = dig[ilen - 1]; d != 0; d >>= 1) {
+            ++num_bits;
         }
-
-        // convert to character
-        a += '0';
-        if (a > '9') {
-            a += base_char - '9' - 1;
+        for (size_t pos = 0; pos < num_bits; pos += bits) {
+            size_t idx = pos / DIG_SIZE;
+            size_t off = pos % DIG_SIZE;
+            mpz_dbl_dig_t v = dig[idx] >> off;
+            if (off + bits > DIG_SIZE && idx + 1 < ilen) {
+                v |= (mpz_dbl_dig_t)dig[idx + 1] << (DIG_SIZE - off);
+            }
+            EMIT_CHAR(v & (base - 1));
         }
-        *s++ = a;
+    } else {
+        // make a copy of mpz digits, so we can do the div/mod calculation
+        mpz_dig_t *dig = m_new(mpz_dig_t, ilen);
+        memcpy(dig, i->dig, ilen * sizeof(mpz_dig_t));
+        size_t dig_alloc = ilen;
+
+        // divide by the largest power of the base that fits in a digit, so
+        // each pass over the digits generates many characters
+        mpz_dig_t chunk_pow;
+        size_t chunk_len = mpz_base_chunk(base, &chunk_pow);
+        do {
+            mpz_dig_t *d = dig + ilen;
+            mpz_dbl_dig_t a = 0;
+
+            // compute next remainder
+            while (--d >= dig) {
+                a = (a << DIG_SIZE) | *d;
+                *d = a / chunk_pow;
+                a %= chunk_pow;
+            }
+            while (ilen > 0 && dig[ilen - 1] == 0) {
+                --ilen;
+            }
 
-        // check if number is zero
-        done = true;
-        for (d = dig; d < dig + ilen; ++d) {
-            if (*d != 0) {
-                done = false;
-                break;
+            // convert to characters, all of them unless this is the most significant chunk
+            for (size_t n = chunk_len; n > 0 && (ilen > 0 || a != 0); --n) {
+                EMIT_CHAR(a % base);
+                a /= base;
             }
-        }
-        if (comma && (s - last_comma) == 3) {
-            *s++ = comma;
-            last_comma = s;
-        }
+        } while (ilen > 0);
+
+        // free the copy of the digits array
+        m_del(mpz_dig_t, dig, dig_alloc);
     }
-    while (!done);
 
-    // free the copy of the digits array
-    m_del(mpz_dig_t, dig, ilen);
+    #undef EMIT_CHAR
 
     if (prefix) {
         const char *p = &prefix[strlen(prefix)];
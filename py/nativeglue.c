@@ -32,6 +32,7 @@
 #include "py/smallint.h"
 #include "py/emitglue.h"
 #include "py/bc.h"
+#include "py/persistentcode.h"
 
 #if MICROPY_DEBUG_VERBOSE // print debugging info
 #define DEBUG_printf DEBUG_printf
@@ -51,6 +52,22 @@ int mp_native_type_from_qstr(qstr qst) {
         case MP_QSTR_ptr8: return MP_NATIVE_TYPE_PTR8;
         case MP_QSTR_ptr16: return MP_NATIVE_TYPE_PTR16;
         case MP_QSTR_ptr32: return MP_NATIVE_TYPE_PTR32;
+        #if MICROPY_EMIT_NATIVE_FLOAT
+        case MP_QSTR_float:
+        case MP_QSTR_ptrf32:
+        case MP_QSTR_ptrf64:
+            #if MICROPY_DYNAMIC_COMPILER
+            // only the x64 emitter, and the Thumb emitter for a CPU with an
+            // FPU, support the float types
+            if (mp_dynamic_compiler.native_arch != MP_NATIVE_ARCH_X64
+                && mp_dynamic_compiler.native_arch != MP_NATIVE_ARCH_ARMV7EMSP
+                && mp_dynamic_compiler.native_arch != MP_NATIVE_ARCH_ARMV7EMDP) {
+                return -1;
+            }
+            #endif
+            return qst == MP_QSTR_float ? MP_NATIVE_TYPE_FLOAT
+                : qst == MP_QSTR_ptrf32 ? MP_NATIVE_TYPE_PTRF32 : MP_NATIVE_TYPE_PTRF64;
+        #endif
         default: return -1;
     }
 }
@@ -63,6 +80,13 @@ mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type) {
         case MP_NATIVE_TYPE_BOOL: return mp_obj_is_true(obj);
         case MP_NATIVE_TYPE_INT:
         case MP_NATIVE_TYPE_UINT: return mp_obj_get_int_truncated(obj);
+        #if MICROPY_EMIT_NATIVE_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: {
+            mp_native_float_t val = { .u = 0 };
+            val.f = mp_obj_get_float(obj);
+            return val.u;
+        }
+        #endif
         default: { // cast obj to a pointer
             mp_buffer_info_t bufinfo;
             if (mp_get_buffer(obj, &bufinfo, MP_BUFFER_READ)) {
@@ -87,6 +111,12 @@ mp_obj_t mp_native_to_obj(mp_uint_t val, mp_uint_t type) {
         case MP_NATIVE_TYPE_BOOL: return mp_obj_new_bool(val);
         case MP_NATIVE_TYPE_INT: return mp_obj_new_int(val);
         case MP_NATIVE_TYPE_UINT: return mp_obj_new_int_from_uint(val);
+        #if MICROPY_EMIT_NATIVE_FLOAT
+        case MP_NATIVE_TYPE_FLOAT: {
+            mp_native_float_t f = { .u = val };
+            return mp_obj_new_float(f.f);
+        }
+        #endif
         default: // a pointer
             // we return just the value of the pointer as an integer
             return mp_obj_new_int_from_uint(val);
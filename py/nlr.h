@@ -95,7 +95,13 @@ struct _nlr_buf_t {
 // Helper macros to save/restore the pystack state
 #if MICROPY_ENABLE_PYSTACK
 #define MP_NLR_SAVE_PYSTACK(nlr_buf) (nlr_buf)->pystack = MP_STATE_THREAD(pystack_cur)
+#if MICROPY_PYSTACK_GROW
+// the saved pointer may be in a chunk below the current one
+void mp_pystack_unwind(void *ptr);
+#define MP_NLR_RESTORE_PYSTACK(nlr_buf) mp_pystack_unwind((nlr_buf)->pystack)
+#else
 #define MP_NLR_RESTORE_PYSTACK(nlr_buf) MP_STATE_THREAD(pystack_cur) = (nlr_buf)->pystack
+#endif
 #else
 #define MP_NLR_SAVE_PYSTACK(nlr_buf) (void)nlr_buf
 #define MP_NLR_RESTORE_PYSTACK(nlr_buf) (void)nlr_buf
@@ -373,6 +373,7 @@ static inline bool mp_map_slot_is_filled(const mp_map_t *map, size_t pos) { retu
 
 void mp_map_init(mp_map_t *map, size_t n);
 void mp_map_init_fixed_table(mp_map_t *map, size_t n, const mp_obj_t *table);
+void mp_map_init_copy(mp_map_t *map, const mp_map_t *src);
 mp_map_t *mp_map_new(size_t n);
 void mp_map_deinit(mp_map_t *map);
 void mp_map_free(mp_map_t *map);
@@ -741,6 +742,13 @@ mp_int_t mp_float_hash(mp_float_t val);
 static inline mp_int_t mp_float_hash(mp_float_t val) { return (mp_int_t)val; }
 #endif
 mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t rhs); // can return MP_OBJ_NULL if op not supported
+#if MICROPY_OPT_FLOAT_TEMP && (MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_A || MICROPY_OBJ_REPR == MICROPY_OBJ_REPR_B)
+// floats are on the heap, so the VM can reuse them for temporary results
+#define MP_OBJ_FLOAT_TEMP (1)
+mp_obj_t mp_obj_float_binary_op_temp(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_in, mp_obj_t temp);
+#else
+#define MP_OBJ_FLOAT_TEMP (0)
+#endif
 
 // complex
 void mp_obj_complex_get(mp_obj_t self_in, mp_float_t *real, mp_float_t *imag);
@@ -35,6 +35,7 @@ typedef struct _mp_obj_enumerate_t {
     mp_obj_base_t base;
     mp_obj_t iter;
     mp_int_t cur;
+    mp_obj_iter_buf_t iter_buf; // storage for iter, saves a separate heap allocation
 } mp_obj_enumerate_t;
 
 STATIC mp_obj_t enumerate_iternext(mp_obj_t self_in);
@@ -56,13 +57,13 @@ STATIC mp_obj_t enumerate_make_new(const mp_obj_type_t *type, size_t n_args, siz
     // create enumerate object
     mp_obj_enumerate_t *o = m_new_obj(mp_obj_enumerate_t);
     o->base.type = type;
-    o->iter = mp_getiter(arg_vals.iterable.u_obj, NULL);
+    o->iter = mp_getiter(arg_vals.iterable.u_obj, &o->iter_buf);
     o->cur = arg_vals.start.u_int;
 #else
     (void)n_kw;
     mp_obj_enumerate_t *o = m_new_obj(mp_obj_enumerate_t);
     o->base.type = type;
-    o->iter = mp_getiter(args[0], NULL);
+    o->iter = mp_getiter(args[0], &o->iter_buf);
     o->cur = n_args > 1 ? mp_obj_get_int(args[1]) : 0;
 #endif
 
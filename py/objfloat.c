@@ -244,12 +244,10 @@ STATIC void mp_obj_float_divmod(mp_float_t *x, mp_float_t *y) {
     *y = mod;
 }
 
-mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t rhs_in) {
-    mp_float_t rhs_val;
-    if (!mp_obj_get_float_maybe(rhs_in, &rhs_val)) {
-        return MP_OBJ_NULL; // op not supported
-    }
-
+// Perform an arithmetic op on floats, storing the result in lhs_val.  Returns
+// false if op is not arithmetic or the result is not a float.
+STATIC bool mp_obj_float_arith(mp_binary_op_t op, mp_float_t *lhs_val_in, mp_float_t rhs_val) {
+    mp_float_t lhs_val = *lhs_val_in;
     switch (op) {
         case MP_BINARY_OP_ADD:
         case MP_BINARY_OP_INPLACE_ADD: lhs_val += rhs_val; break;
@@ -295,6 +293,28 @@ mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t
             if (lhs_val == 0 && rhs_val < 0 && !isinf(rhs_val)) {
                 goto zero_division_error;
             }
+            if (lhs_val < 0 && rhs_val != MICROPY_FLOAT_C_FUN(floor)(rhs_val)) {
+                // the result is complex
+                return false;
+            }
+            lhs_val = MICROPY_FLOAT_C_FUN(pow)(lhs_val, rhs_val);
+            break;
+        default:
+            return false;
+    }
+    *lhs_val_in = lhs_val;
+    return true;
+}
+
+mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t rhs_in) {
+    mp_float_t rhs_val;
+    if (!mp_obj_get_float_maybe(rhs_in, &rhs_val)) {
+        return MP_OBJ_NULL; // op not supported
+    }
+
+    switch (op) {
+        case MP_BINARY_OP_POWER:
+        case MP_BINARY_OP_INPLACE_POWER:
             if (lhs_val < 0 && rhs_val != MICROPY_FLOAT_C_FUN(floor)(rhs_val)) {
                 #if MICROPY_PY_BUILTINS_COMPLEX
                 return mp_obj_complex_binary_op(MP_BINARY_OP_POWER, lhs_val, 0, rhs_in);
@@ -302,11 +322,10 @@ mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t
                 mp_raise_ValueError("complex values not supported");
                 #endif
             }
-            lhs_val = MICROPY_FLOAT_C_FUN(pow)(lhs_val, rhs_val);
             break;
         case MP_BINARY_OP_DIVMOD: {
             if (rhs_val == 0) {
-                goto zero_division_error;
+                mp_raise_msg(&mp_type_ZeroDivisionError, "divide by zero");
             }
             mp_obj_float_divmod(&lhs_val, &rhs_val);
             mp_obj_t tuple[2] = {
@@ -320,11 +339,49 @@ mp_obj_t mp_obj_float_binary_op(mp_binary_op_t op, mp_float_t lhs_val, mp_obj_t
         case MP_BINARY_OP_EQUAL: return mp_obj_new_bool(lhs_val == rhs_val);
         case MP_BINARY_OP_LESS_EQUAL: return mp_obj_new_bool(lhs_val <= rhs_val);
         case MP_BINARY_OP_MORE_EQUAL: return mp_obj_new_bool(lhs_val >= rhs_val);
-
         default:
-            return MP_OBJ_NULL; // op not supported
+            break;
+    }
+    if (!mp_obj_float_arith(op, &lhs_val, rhs_val)) {
+        return MP_OBJ_NULL; // op not supported
     }
     return mp_obj_new_float(lhs_val);
 }
 
+#if MP_OBJ_FLOAT_TEMP
+
+// Perform a binary op for MP_BC_BINARY_OP_TEMP.  If the operands are floats,
+// or a float and a small int, and the result is a float then the result is
+// stored in temp, if it's not MP_OBJ_NULL, else in a new float.  temp must be
+// a float that is only referenced from the VM stack.  Otherwise MP_OBJ_NULL is
+// returned and the op must be done with mp_binary_op.
+mp_obj_t mp_obj_float_binary_op_temp(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_in, mp_obj_t temp) {
+    mp_float_t lhs_val, rhs_val;
+    if (mp_obj_is_float(lhs_in)) {
+        lhs_val = mp_obj_float_get(lhs_in);
+        if (mp_obj_is_float(rhs_in)) {
+            rhs_val = mp_obj_float_get(rhs_in);
+        } else if (mp_obj_is_small_int(rhs_in)) {
+            rhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(rhs_in);
+        } else {
+            return MP_OBJ_NULL;
+        }
+    } else if (mp_obj_is_small_int(lhs_in) && mp_obj_is_float(rhs_in)) {
+        lhs_val = (mp_float_t)MP_OBJ_SMALL_INT_VALUE(lhs_in);
+        rhs_val = mp_obj_float_get(rhs_in);
+    } else {
+        return MP_OBJ_NULL;
+    }
+    if (!mp_obj_float_arith(op, &lhs_val, rhs_val)) {
+        return MP_OBJ_NULL;
+    }
+    if (temp == MP_OBJ_NULL) {
+        return mp_obj_new_float(lhs_val);
+    }
+    ((mp_obj_float_t*)MP_OBJ_TO_PTR(temp))->value = lhs_val;
+    return temp;
+}
+
+#endif
+
 #endif // MICROPY_PY_BUILTINS_FLOAT
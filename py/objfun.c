@@ -167,7 +167,11 @@ qstr mp_obj_fun_get_name(mp_const_obj_t fun_in) {
     bc++; // skip n_pos_args
     bc++; // skip n_kwonly_args
     bc++; // skip n_def_pos_args
+    #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+    return MP_BC_INPLACE_QSTR(fun->inplace_qstr, mp_obj_code_get_name(bc));
+    #else
     return mp_obj_code_get_name(bc);
+    #endif
 }
 
 #if MICROPY_CPYTHON_COMPAT
@@ -385,6 +389,9 @@ mp_obj_t mp_obj_new_fun_bc(mp_obj_t def_args_in, mp_obj_t def_kw_args, const byt
     o->globals = mp_globals_get();
     o->bytecode = code;
     o->const_table = const_table;
+    #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+    o->inplace_qstr = NULL;
+    #endif
     if (def_args != NULL) {
         memcpy(o->extra_args, def_args->items, n_def_args * sizeof(mp_obj_t));
     }
@@ -36,6 +36,9 @@ typedef struct _mp_obj_fun_bc_t {
     #if MICROPY_PY_SYS_SETTRACE
     const struct _mp_raw_code_t *rc;
     #endif
+    #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+    const uint16_t *inplace_qstr;   // qstr table if bytecode is executed in place, else NULL
+    #endif
     // the following extra_args array is allocated space to take (in order):
     //  - values of positional default args (if any)
     //  - a single slot for default kw args dict (if it has them)
@@ -66,6 +66,18 @@ STATIC mp_obj_t reversed_iternext(mp_obj_t self_in) {
 
     // pre-decrement and index sequence
     self->cur_index -= 1;
+
+    // fast path for list and tuple, which are the most common things to reverse
+    // (a list may have shrunk, in which case fall through to raise the IndexError)
+    if (mp_obj_is_type(self->seq, &mp_type_list) || mp_obj_is_type(self->seq, &mp_type_tuple)) {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(self->seq, &len, &items);
+        if (self->cur_index < len) {
+            return items[self->cur_index];
+        }
+    }
+
     return mp_obj_subscr(self->seq, MP_OBJ_NEW_SMALL_INT(self->cur_index), MP_OBJ_SENTINEL);
 }
 
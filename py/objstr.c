@@ -2065,6 +2065,62 @@ mp_obj_t mp_obj_new_str_from_vstr(const mp_obj_type_t *type, vstr_t *vstr) {
     return MP_OBJ_FROM_PTR(o);
 }
 
+// The compiler turns "x += y" on a local x of a bytecode function into
+// INPLACE_ADD_FAST, and every other load of x into LOAD_FAST_ACCUM.  While
+// strings are being added, x holds one of these accumulators instead of a
+// str, so each addition appends in place with geometric growth of the buffer
+// rather than copying the whole string.  The accumulator never escapes the
+// local: LOAD_FAST_ACCUM converts it back to a str, reusing the buffer.
+
+typedef struct _mp_obj_str_accum_t {
+    mp_obj_base_t base;
+    vstr_t vstr;
+} mp_obj_str_accum_t;
+
+const mp_obj_type_t mp_type_str_accum = {
+    { &mp_type_type },
+    .name = MP_QSTR_str,
+};
+
+STATIC void str_accum_add_strn(vstr_t *vstr, const byte *data, size_t len) {
+    if (vstr->len + len > vstr->alloc) {
+        vstr_hint_size(vstr, len + vstr->len / 2);
+    }
+    vstr_add_strn(vstr, (const char*)data, len);
+}
+
+void mp_obj_str_accum_add(mp_obj_t *dest, mp_obj_t rhs) {
+    mp_obj_t lhs = *dest;
+    if (mp_obj_is_type(lhs, &mp_type_str_accum)) {
+        if (mp_obj_is_str(rhs)) {
+            GET_STR_DATA_LEN(rhs, rhs_data, rhs_len);
+            str_accum_add_strn(&((mp_obj_str_accum_t*)MP_OBJ_TO_PTR(lhs))->vstr, rhs_data, rhs_len);
+            return;
+        }
+        lhs = mp_obj_str_accum_finish(lhs);
+        *dest = lhs;
+    } else if (mp_obj_is_str(lhs) && mp_obj_is_str(rhs)) {
+        GET_STR_DATA_LEN(lhs, lhs_data, lhs_len);
+        GET_STR_DATA_LEN(rhs, rhs_data, rhs_len);
+        mp_obj_str_accum_t *o = m_new_obj(mp_obj_str_accum_t);
+        o->base.type = &mp_type_str_accum;
+        vstr_init(&o->vstr, lhs_len + rhs_len + (lhs_len + rhs_len) / 2 + 1);
+        vstr_add_strn(&o->vstr, (const char*)lhs_data, lhs_len);
+        vstr_add_strn(&o->vstr, (const char*)rhs_data, rhs_len);
+        *dest = MP_OBJ_FROM_PTR(o);
+        return;
+    }
+    *dest = mp_binary_op(MP_BINARY_OP_INPLACE_ADD, lhs, rhs);
+}
+
+mp_obj_t mp_obj_str_accum_finish(mp_obj_t self_in) {
+    mp_obj_str_accum_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_t str = mp_obj_new_str_from_vstr(&mp_type_str, &self->vstr);
+    // nothing else refers to the accumulator so it can be freed straightaway
+    m_del_obj(mp_obj_str_accum_t, self);
+    return str;
+}
+
 mp_obj_t mp_obj_new_str(const char* data, size_t len) {
     qstr q = qstr_find_strn(data, len);
     if (q != MP_QSTR_NULL) {
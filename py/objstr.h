@@ -71,6 +71,11 @@ mp_obj_t mp_obj_new_str_of_type(const mp_obj_type_t *type, const byte* data, siz
 mp_obj_t mp_obj_str_binary_op(mp_binary_op_t op, mp_obj_t lhs_in, mp_obj_t rhs_in);
 mp_int_t mp_obj_str_get_buffer(mp_obj_t self_in, mp_buffer_info_t *bufinfo, mp_uint_t flags);
 
+// string accumulator held in a local variable by LOAD_FAST_ACCUM/INPLACE_ADD_FAST
+extern const mp_obj_type_t mp_type_str_accum;
+void mp_obj_str_accum_add(mp_obj_t *dest, mp_obj_t rhs);
+mp_obj_t mp_obj_str_accum_finish(mp_obj_t self_in);
+
 const byte *str_index_to_ptr(const mp_obj_type_t *type, const byte *self_data, size_t self_len,
                              mp_obj_t index, bool is_slice);
 const byte *find_subbytes(const byte *haystack, size_t hlen, const byte *needle, size_t nlen, int direction);
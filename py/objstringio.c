@@ -92,10 +92,9 @@ STATIC mp_uint_t stringio_write(mp_obj_t o_in, const void *buf, mp_uint_t size,
     }
     mp_uint_t org_len = o->vstr->len;
     if (new_pos > o->vstr->alloc) {
-        // Take all what's already allocated...
-        o->vstr->len = o->vstr->alloc;
-        // ... and add more
-        vstr_add_len(o->vstr, new_pos - o->vstr->alloc);
+        // Grow the buffer geometrically so that building up a string with
+        // many small writes takes amortised linear time
+        vstr_hint_size(o->vstr, new_pos - org_len + new_pos / 2);
     }
     // If there was a seek past EOF, clear the hole
     if (o->pos > org_len) {
@@ -165,8 +164,21 @@ STATIC mp_uint_t stringio_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg,
 STATIC mp_obj_t stringio_getvalue(mp_obj_t self_in) {
     mp_obj_stringio_t *self = MP_OBJ_TO_PTR(self_in);
     check_stringio_is_open(self);
-    // TODO: Try to avoid copying string
-    return mp_obj_new_str_of_type(STREAM_TO_CONTENT_TYPE(self), (byte*)self->vstr->buf, self->vstr->len);
+    vstr_t *vstr = self->vstr;
+    if (vstr->fixed_buf) {
+        // the buffer belongs to another object, which may not be a str
+        return mp_obj_new_str_of_type(STREAM_TO_CONTENT_TYPE(self), (byte*)vstr->buf, vstr->len);
+    }
+    // Hand the buffer over to the new object without copying it, and keep
+    // using it as a shared buffer that is copied on the next write
+    size_t len = vstr->len;
+    mp_obj_t value = mp_obj_new_str_from_vstr(STREAM_TO_CONTENT_TYPE(self), vstr);
+    GET_STR_DATA_LEN(value, data, data_len);
+    (void)data_len;
+    vstr_init_fixed_buf(vstr, len, (char*)data);
+    vstr->len = len;
+    self->ref_obj = value;
+    return value;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(stringio_getvalue_obj, stringio_getvalue);
 
@@ -46,6 +46,7 @@
 
 #define TYPE_FLAG_IS_SUBCLASSED (0x0001)
 #define TYPE_FLAG_HAS_SPECIAL_ACCESSORS (0x0002)
+#define TYPE_FLAG_HAS_NATIVE_BASE (0x0004)
 
 STATIC mp_obj_t static_class_method_make_new(const mp_obj_type_t *self_in, size_t n_args, size_t n_kw, const mp_obj_t *args);
 
@@ -134,8 +135,32 @@ struct class_lookup_data {
     size_t meth_offset;
     mp_obj_t *dest;
     bool is_type;
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // set to the type whose locals_dict contained the attribute, if any
+    const mp_obj_type_t *found_type;
+    mp_obj_t found_value;
+    #endif
 };
 
+STATIC void mp_obj_class_lookup_convert(struct class_lookup_data *lookup, const mp_obj_type_t *type, mp_obj_t member) {
+    if (lookup->is_type) {
+        // If we look up a class method, we need to return original type for which we
+        // do a lookup, not a (base) type in which we found the class method.
+        const mp_obj_type_t *org_type = (const mp_obj_type_t*)lookup->obj;
+        mp_convert_member_lookup(MP_OBJ_NULL, org_type, member, lookup->dest);
+    } else {
+        mp_obj_instance_t *obj = lookup->obj;
+        mp_obj_t obj_obj;
+        if (obj != NULL && mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
+            // If we're dealing with native base class, then it applies to native sub-object
+            obj_obj = obj->subobj[0];
+        } else {
+            obj_obj = MP_OBJ_FROM_PTR(obj);
+        }
+        mp_convert_member_lookup(obj_obj, type, member, lookup->dest);
+    }
+}
+
 STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_type_t *type) {
     assert(lookup->dest[0] == MP_OBJ_NULL);
     assert(lookup->dest[1] == MP_OBJ_NULL);
@@ -160,22 +185,11 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
             mp_map_t *locals_map = &type->locals_dict->map;
             mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(lookup->attr), MP_MAP_LOOKUP);
             if (elem != NULL) {
-                if (lookup->is_type) {
-                    // If we look up a class method, we need to return original type for which we
-                    // do a lookup, not a (base) type in which we found the class method.
-                    const mp_obj_type_t *org_type = (const mp_obj_type_t*)lookup->obj;
-                    mp_convert_member_lookup(MP_OBJ_NULL, org_type, elem->value, lookup->dest);
-                } else {
-                    mp_obj_instance_t *obj = lookup->obj;
-                    mp_obj_t obj_obj;
-                    if (obj != NULL && mp_obj_is_native_type(type) && type != &mp_type_object /* object is not a real type */) {
-                        // If we're dealing with native base class, then it applies to native sub-object
-                        obj_obj = obj->subobj[0];
-                    } else {
-                        obj_obj = MP_OBJ_FROM_PTR(obj);
-                    }
-                    mp_convert_member_lookup(obj_obj, type, elem->value, lookup->dest);
-                }
+                mp_obj_class_lookup_convert(lookup, type, elem->value);
+                #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+                lookup->found_type = type;
+                lookup->found_value = elem->value;
+                #endif
 #if DEBUG_PRINT
                 DEBUG_printf("mp_obj_class_lookup: Returning: ");
                 mp_obj_print_helper(MICROPY_DEBUG_PRINTER, lookup->dest[0], PRINT_REPR);
@@ -236,6 +250,33 @@ STATIC void mp_obj_class_lookup(struct class_lookup_data  *lookup, const mp_obj_
     }
 }
 
+// Same as mp_obj_class_lookup but consults the type lookup cache first.  The
+// cache is only used for Python classes without a native base, for which the
+// result depends only on the locals_dict of each class in the MRO.
+STATIC void mp_obj_class_lookup_cached(struct class_lookup_data *lookup, const mp_obj_type_t *type) {
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    if (lookup->meth_offset == 0 && mp_obj_is_instance_type(type) && !(type->flags & TYPE_FLAG_HAS_NATIVE_BASE)) {
+        size_t hash = ((uintptr_t)type >> 2) ^ lookup->attr;
+        mp_type_cache_entry_t *entry = &MP_STATE_THREAD(type_cache)[hash & (MICROPY_OPT_CACHE_TYPE_LOOKUP_SIZE - 1)];
+        if (entry->type == type && entry->attr == lookup->attr && entry->epoch == MP_STATE_VM(type_cache_epoch)) {
+            mp_obj_class_lookup_convert(lookup, entry->found_type, entry->value);
+            return;
+        }
+        lookup->found_type = NULL;
+        mp_obj_class_lookup(lookup, type);
+        if (lookup->found_type != NULL) {
+            entry->type = type;
+            entry->found_type = lookup->found_type;
+            entry->value = lookup->found_value;
+            entry->epoch = MP_STATE_VM(type_cache_epoch);
+            entry->attr = lookup->attr;
+        }
+        return;
+    }
+    #endif
+    mp_obj_class_lookup(lookup, type);
+}
+
 STATIC void instance_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     mp_obj_instance_t *self = MP_OBJ_TO_PTR(self_in);
     qstr meth = (kind == PRINT_STR) ? MP_QSTR___str__ : MP_QSTR___repr__;
@@ -609,7 +650,7 @@ STATIC void mp_obj_instance_load_attr(mp_obj_t self_in, qstr attr, mp_obj_t *des
         .dest = dest,
         .is_type = false,
     };
-    mp_obj_class_lookup(&lookup, self->base.type);
+    mp_obj_class_lookup_cached(&lookup, self->base.type);
     mp_obj_t member = dest[0];
     if (member != MP_OBJ_NULL) {
         if (!(self->base.type->flags & TYPE_FLAG_HAS_SPECIAL_ACCESSORS)) {
@@ -1019,7 +1060,7 @@ STATIC void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
             .dest = dest,
             .is_type = true,
         };
-        mp_obj_class_lookup(&lookup, self);
+        mp_obj_class_lookup_cached(&lookup, self);
     } else {
         // delete/store attribute
 
@@ -1030,6 +1071,10 @@ STATIC void type_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
                 // can't apply delete/store to a fixed map
                 return;
             }
+            #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+            // the class or one of its subclasses may have cached lookups
+            ++MP_STATE_VM(type_cache_epoch);
+            #endif
             if (dest[1] == MP_OBJ_NULL) {
                 // delete attribute
                 mp_map_elem_t *elem = mp_map_lookup(locals_map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
@@ -1161,6 +1206,8 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
     size_t num_native_bases = instance_count_native_bases(o, &native_base);
     if (num_native_bases > 1) {
         mp_raise_TypeError("multiple bases have instance lay-out conflict");
+    } else if (num_native_bases == 1) {
+        o->flags |= TYPE_FLAG_HAS_NATIVE_BASE;
     }
 
     mp_map_t *locals_map = &o->locals_dict->map;
@@ -39,11 +39,14 @@ typedef struct _mp_obj_zip_t {
 STATIC mp_obj_t zip_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
     mp_arg_check_num(n_args, n_kw, 0, MP_OBJ_FUN_ARGS_MAX, false);
 
-    mp_obj_zip_t *o = m_new_obj_var(mp_obj_zip_t, mp_obj_t, n_args);
+    // the iter_buf for each iterator is stored after the iters array, so that
+    // iterators which can use an iter_buf don't need their own heap allocation
+    mp_obj_zip_t *o = m_new_obj_var(mp_obj_zip_t, mp_obj_t, n_args * (1 + MP_OBJ_ITER_BUF_NSLOTS));
     o->base.type = type;
     o->n_iters = n_args;
+    mp_obj_iter_buf_t *iter_buf = (mp_obj_iter_buf_t*)&o->iters[n_args];
     for (size_t i = 0; i < n_args; i++) {
-        o->iters[i] = mp_getiter(args[i], NULL);
+        o->iters[i] = mp_getiter(args[i], &iter_buf[i]);
     }
     return MP_OBJ_FROM_PTR(o);
 }
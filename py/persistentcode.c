@@ -66,7 +66,13 @@
 #elif MICROPY_EMIT_X64
 #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_X64)
 #elif MICROPY_EMIT_THUMB
+#if defined(__ARM_FP) && (__ARM_FP & 8)
+#define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_ARMV7EMDP)
+#elif defined(__ARM_FP)
+#define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_ARMV7EMSP)
+#else
 #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_ARMV7M)
+#endif
 #elif MICROPY_EMIT_ARM
 #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_ARMV6)
 #elif MICROPY_EMIT_XTENSA
@@ -75,6 +81,14 @@
 #define MPY_FEATURE_ARCH (MP_NATIVE_ARCH_NONE)
 #endif
 
+// Whether native code for the given arch can run on this one: Thumb code can
+// run on a CPU that has a later Arm architecture or an FPU that it doesn't use
+#if MICROPY_EMIT_THUMB
+#define MPY_FEATURE_ARCH_TEST(arch) (MP_NATIVE_ARCH_ARMV6M <= (arch) && (arch) <= MPY_FEATURE_ARCH)
+#else
+#define MPY_FEATURE_ARCH_TEST(arch) ((arch) == MPY_FEATURE_ARCH)
+#endif
+
 #if MICROPY_DYNAMIC_COMPILER
 #define MPY_FEATURE_ARCH_DYNAMIC mp_dynamic_compiler.native_arch
 #else
@@ -157,7 +171,7 @@ typedef struct _bytecode_prelude_t {
     uint code_info_size;
 } bytecode_prelude_t;
 
-#if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_EMIT_MACHINE_CODE
+#if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_EMIT_MACHINE_CODE || MICROPY_PERSISTENT_CODE_LOAD_INPLACE
 
 // ip will point to start of opcodes
 // ip2 will point to simple_name, source_file qstrs
@@ -182,6 +196,7 @@ STATIC void extract_prelude(const byte **ip, const byte **ip2, bytecode_prelude_
 #if MICROPY_PERSISTENT_CODE_LOAD
 
 #include "py/parsenum.h"
+#include "py/objstr.h"
 
 #if MICROPY_EMIT_MACHINE_CODE
 
@@ -220,19 +235,24 @@ STATIC void arch_link_qstr(uint8_t *pc, bool is_obj, qstr qst) {
 #endif
 
 STATIC int read_byte(mp_reader_t *reader) {
-    return reader->readbyte(reader->data);
+    mp_uint_t b = reader->readbyte(reader->data);
+    if (b == MP_READER_EOF) {
+        // a truncated file
+        mp_raise_ValueError("incompatible .mpy file");
+    }
+    return b;
 }
 
 STATIC void read_bytes(mp_reader_t *reader, byte *buf, size_t len) {
     while (len-- > 0) {
-        *buf++ = reader->readbyte(reader->data);
+        *buf++ = read_byte(reader);
     }
 }
 
 STATIC size_t read_uint(mp_reader_t *reader, byte **out) {
     size_t unum = 0;
     for (;;) {
-        byte b = reader->readbyte(reader->data);
+        byte b = read_byte(reader);
         if (out != NULL) {
             **out = b;
             ++*out;
@@ -477,39 +497,247 @@ STATIC mp_raw_code_t *load_raw_code(mp_reader_t *reader, qstr_window_t *qw) {
     return rc;
 }
 
-mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
-    byte header[4];
-    read_bytes(reader, header, sizeof(header));
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+
+// A .mpy image in the in-place layout is parsed straight out of memory.  If the
+// image stays valid for the life of the VM then its bytecode and string data
+// are used where they are, and only the qstr table, the constant tables and
+// the raw code structures are allocated on the heap.  Otherwise the bytecode
+// is copied with its qstr ids resolved, just like a normal .mpy file.
+typedef struct _inplace_loader_t {
+    const byte *cur;
+    const byte *top;
+    uint16_t *qstr_table;
+    bool in_place;
+} inplace_loader_t;
+
+STATIC const byte *inplace_read_bytes(inplace_loader_t *ld, size_t len) {
+    if (len > (size_t)(ld->top - ld->cur)) {
+        mp_raise_ValueError("incompatible .mpy file");
+    }
+    const byte *data = ld->cur;
+    ld->cur += len;
+    return data;
+}
+
+STATIC size_t inplace_read_uint(inplace_loader_t *ld) {
+    size_t unum = 0;
+    byte b;
+    do {
+        b = *inplace_read_bytes(ld, 1);
+        unum = (unum << 7) | (b & 0x7f);
+    } while (b & 0x80);
+    return unum;
+}
+
+STATIC mp_obj_t inplace_load_obj(inplace_loader_t *ld) {
+    byte obj_type = *inplace_read_bytes(ld, 1);
+    if (obj_type == 'e') {
+        return MP_OBJ_FROM_PTR(&mp_const_ellipsis_obj);
+    }
+    size_t len = inplace_read_uint(ld);
+    const char *data = (const char*)inplace_read_bytes(ld, len + 1); // data has a trailing NUL
+    if (obj_type == 's' || obj_type == 'b') {
+        const mp_obj_type_t *type = obj_type == 's' ? &mp_type_str : &mp_type_bytes;
+        if (!ld->in_place) {
+            return mp_obj_new_str_copy(type, (const byte*)data, len);
+        }
+        mp_obj_str_t *o = m_new_obj(mp_obj_str_t);
+        o->base.type = type;
+        o->hash = qstr_compute_hash((const byte*)data, len);
+        o->len = len;
+        o->data = (const byte*)data;
+        return MP_OBJ_FROM_PTR(o);
+    } else if (obj_type == 'i') {
+        return mp_parse_num_integer(data, len, 10, NULL);
+    } else {
+        assert(obj_type == 'f' || obj_type == 'c');
+        return mp_parse_num_decimal(data, len, obj_type == 'c', false, NULL);
+    }
+}
+
+STATIC void inplace_resolve_qstr(const uint16_t *qstr_table, byte *ip) {
+    qstr qst = MP_BC_INPLACE_QSTR(qstr_table, ip[0] | (ip[1] << 8));
+    ip[0] = qst;
+    ip[1] = qst >> 8;
+}
+
+STATIC mp_raw_code_t *inplace_load_raw_code(inplace_loader_t *ld) {
+    // Only bytecode can be stored in the in-place layout
+    size_t fun_data_len = inplace_read_uint(ld);
+    const byte *fun_data = inplace_read_bytes(ld, fun_data_len);
+    const byte *ip = fun_data;
+    const byte *ip2;
+    bytecode_prelude_t prelude;
+    extract_prelude(&ip, &ip2, &prelude);
+
+    if (!ld->in_place) {
+        // Copy the bytecode to the heap and turn its qstr ids into qstrs
+        byte *buf = m_new(byte, fun_data_len);
+        memcpy(buf, fun_data, fun_data_len);
+        inplace_resolve_qstr(ld->qstr_table, buf + (ip2 - fun_data)); // simple_name
+        inplace_resolve_qstr(ld->qstr_table, buf + (ip2 - fun_data) + 2); // source_file
+        for (byte *ip_top = buf + fun_data_len, *bc = buf + (ip - fun_data); bc < ip_top;) {
+            size_t sz;
+            if (mp_opcode_format(bc, &sz, true) == MP_OPCODE_QSTR) {
+                inplace_resolve_qstr(ld->qstr_table, bc + 1);
+            }
+            bc += sz;
+        }
+        fun_data = buf;
+    }
+
+    // Load constant table
+    size_t n_obj = inplace_read_uint(ld);
+    size_t n_raw_code = inplace_read_uint(ld);
+    size_t n_arg = prelude.n_pos_args + prelude.n_kwonly_args;
+    mp_uint_t *const_table = m_new(mp_uint_t, n_arg + n_obj + n_raw_code);
+    mp_uint_t *ct = const_table;
+    for (size_t i = 0; i < n_arg; ++i) {
+        size_t id = inplace_read_uint(ld);
+        *ct++ = (mp_uint_t)MP_OBJ_NEW_QSTR(MP_BC_INPLACE_QSTR(ld->qstr_table, id));
+    }
+    for (size_t i = 0; i < n_obj; ++i) {
+        *ct++ = (mp_uint_t)inplace_load_obj(ld);
+    }
+    for (size_t i = 0; i < n_raw_code; ++i) {
+        *ct++ = (mp_uint_t)(uintptr_t)inplace_load_raw_code(ld);
+    }
+
+    mp_raw_code_t *rc = mp_emit_glue_new_raw_code();
+    mp_emit_glue_assign_bytecode(rc, fun_data,
+        #if MICROPY_PERSISTENT_CODE_SAVE || MICROPY_DEBUG_PRINTERS
+        fun_data_len,
+        #endif
+        const_table,
+        #if MICROPY_PERSISTENT_CODE_SAVE
+        n_obj, n_raw_code,
+        #endif
+        prelude.scope_flags);
+    if (ld->in_place) {
+        rc->inplace_qstr = ld->qstr_table;
+        #if MICROPY_PY_SYS_SETTRACE
+        rc->prelude.qstr_block_name = MP_BC_INPLACE_QSTR(ld->qstr_table, rc->prelude.qstr_block_name);
+        rc->prelude.qstr_source_file = MP_BC_INPLACE_QSTR(ld->qstr_table, rc->prelude.qstr_source_file);
+        #endif
+    }
+    return rc;
+}
+
+// ld must point just past the header of the image
+STATIC mp_raw_code_t *inplace_load_image(inplace_loader_t *ld) {
+    // Intern the qstrs of the image; the table needs at least one entry so
+    // that bytecode executed in place always has a non-NULL table
+    size_t n_qstr = inplace_read_uint(ld);
+    ld->qstr_table = m_new(uint16_t, n_qstr + 1);
+    for (size_t i = 0; i < n_qstr; ++i) {
+        size_t len = inplace_read_uint(ld);
+        const char *str = (const char*)inplace_read_bytes(ld, len);
+        ld->qstr_table[i] = qstr_from_strn(str, len);
+    }
+    mp_raw_code_t *rc = inplace_load_raw_code(ld);
+    if (!ld->in_place) {
+        m_del(uint16_t, ld->qstr_table, n_qstr + 1);
+    }
+    return rc;
+}
+
+#endif // MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+
+STATIC void check_header(const byte *header) {
     if (header[0] != 'M'
         || header[1] != MPY_VERSION
         || MPY_FEATURE_DECODE_FLAGS(header[2]) != MPY_FEATURE_FLAGS
-        || header[3] > mp_small_int_bits()
-        || read_uint(reader, NULL) > QSTR_WINDOW_SIZE) {
+        || header[3] > mp_small_int_bits()) {
         mp_raise_ValueError("incompatible .mpy file");
     }
     if (MPY_FEATURE_DECODE_ARCH(header[2]) != MP_NATIVE_ARCH_NONE
-        && MPY_FEATURE_DECODE_ARCH(header[2]) != MPY_FEATURE_ARCH) {
+        && !MPY_FEATURE_ARCH_TEST(MPY_FEATURE_DECODE_ARCH(header[2]))) {
         mp_raise_ValueError("incompatible .mpy arch");
     }
-    qstr_window_t qw;
-    qw.idx = 0;
-    mp_raw_code_t *rc = load_raw_code(reader, &qw);
+}
+
+// If filename is given and the file turns out to be in the in-place layout
+// then it is mapped into memory, when possible, instead of being read
+STATIC mp_raw_code_t *raw_code_load(mp_reader_t *reader, const char *filename) {
+    (void)filename;
+    byte header[4];
+    read_bytes(reader, header, sizeof(header));
+    check_header(header);
+    size_t qstr_window_size = read_uint(reader, NULL);
+    if (qstr_window_size > QSTR_WINDOW_SIZE) {
+        mp_raise_ValueError("incompatible .mpy file");
+    }
+    mp_raw_code_t *rc;
+    if (qstr_window_size == 0) {
+        // A window size of 0 marks the in-place layout
+        #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+        #if MICROPY_READER_MAP_FILE && !MICROPY_VFS
+        size_t len = 0;
+        const byte *buf = filename == NULL ? NULL : mp_reader_map_file(filename, &len);
+        if (buf != NULL) {
+            reader->close(reader->data);
+            nlr_buf_t nlr;
+            if (nlr_push(&nlr) == 0) {
+                rc = mp_raw_code_load_inplace(buf, len);
+                nlr_pop();
+                return rc;
+            }
+            // nothing refers to the image if it failed to load
+            mp_reader_unmap_file(buf, len);
+            nlr_jump(nlr.ret_val);
+        }
+        #endif
+        vstr_t vstr;
+        vstr_init(&vstr, 128);
+        for (mp_uint_t b; (b = reader->readbyte(reader->data)) != MP_READER_EOF;) {
+            vstr_add_byte(&vstr, b);
+        }
+        inplace_loader_t ld = {(const byte*)vstr.buf, (const byte*)vstr.buf + vstr.len, NULL, false};
+        rc = inplace_load_image(&ld);
+        vstr_clear(&vstr);
+        #else
+        mp_raise_ValueError("incompatible .mpy file");
+        #endif
+    } else {
+        qstr_window_t qw;
+        qw.idx = 0;
+        rc = load_raw_code(reader, &qw);
+    }
     reader->close(reader->data);
     return rc;
 }
 
+mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader) {
+    return raw_code_load(reader, NULL);
+}
+
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len) {
     mp_reader_t reader;
     mp_reader_new_mem(&reader, buf, len, 0);
     return mp_raw_code_load(&reader);
 }
 
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+
+mp_raw_code_t *mp_raw_code_load_inplace(const byte *buf, size_t len) {
+    if (len < 5 || buf[4] != 0) {
+        // not in the in-place layout, so load it the normal way
+        return mp_raw_code_load_mem(buf, len);
+    }
+    check_header(buf);
+    inplace_loader_t ld = {buf + 5, buf + len, NULL, true};
+    return inplace_load_image(&ld);
+}
+
+#endif
+
 #if MICROPY_HAS_FILE_READER
 
 mp_raw_code_t *mp_raw_code_load_file(const char *filename) {
     mp_reader_t reader;
     mp_reader_new_file(&reader, filename);
-    return mp_raw_code_load(&reader);
+    return raw_code_load(&reader, filename);
 }
 
 #endif // MICROPY_HAS_FILE_READER
@@ -555,7 +783,9 @@ STATIC void save_qstr(mp_print_t *print, qstr_window_t *qw, qstr qst) {
     mp_print_bytes(print, str, len);
 }
 
-STATIC void save_obj(mp_print_t *print, mp_obj_t o) {
+// If nul_term is true then any data of the object is followed by a NUL byte,
+// as needed by the in-place layout
+STATIC void save_obj(mp_print_t *print, mp_obj_t o, bool nul_term) {
     if (mp_obj_is_str_or_bytes(o)) {
         byte obj_type;
         if (mp_obj_is_str(o)) {
@@ -571,6 +801,7 @@ STATIC void save_obj(mp_print_t *print, mp_obj_t o) {
     } else if (MP_OBJ_TO_PTR(o) == &mp_const_ellipsis_obj) {
         byte obj_type = 'e';
         mp_print_bytes(print, &obj_type, 1);
+        return;
     } else {
         // we save numbers using a simplistic text representation
         // TODO could be improved
@@ -594,6 +825,9 @@ STATIC void save_obj(mp_print_t *print, mp_obj_t o) {
         mp_print_bytes(print, (const byte*)vstr.buf, vstr.len);
         vstr_clear(&vstr);
     }
+    if (nul_term) {
+        mp_print_bytes(print, (const byte*)"", 1);
+    }
 }
 
 STATIC void save_bytecode(mp_print_t *print, qstr_window_t *qw, const byte *ip, const byte *ip_top) {
@@ -690,7 +924,7 @@ STATIC void save_raw_code(mp_print_t *print, mp_raw_code_t *rc, qstr_window_t *q
 
         // Save constant objects and raw code children
         for (size_t i = 0; i < rc->n_obj; ++i) {
-            save_obj(print, (mp_obj_t)*const_table++);
+            save_obj(print, (mp_obj_t)*const_table++, false);
         }
         for (size_t i = 0; i < rc->n_raw_code; ++i) {
             save_raw_code(print, (mp_raw_code_t*)(uintptr_t)*const_table++, qstr_window);
@@ -721,13 +955,128 @@ STATIC bool mp_raw_code_has_native(mp_raw_code_t *rc) {
     return false;
 }
 
+#if MICROPY_DYNAMIC_COMPILER
+
+// The in-place layout stores the bytecode in the form in which it's executed,
+// so that it can run directly from the memory holding the .mpy image.  All
+// qstrs are gathered into a table at the start of the image and everything
+// else refers to them by id, see MP_BC_INPLACE_QSTR.  The layout is:
+//  uint  0 (in place of the qstr window size)
+//  uint  number of qstrs, then for each: uint len, len bytes of data
+//  raw code, recursively:
+//      uint  length of bytecode, then the bytecode
+//      uint  number of constant objects
+//      uint  number of raw code children
+//      uint  qstr id of each argument name
+//      constant objects as for the normal layout, with a NUL after their data
+//      raw code children
+
+typedef struct _inplace_qstrs_t {
+    size_t len;
+    size_t alloc;
+    qstr *table;
+} inplace_qstrs_t;
+
+STATIC void null_print_strn(void *env, const char *str, size_t len) {
+    (void)env;
+    (void)str;
+    (void)len;
+}
+
+STATIC size_t inplace_qstr_id(inplace_qstrs_t *qs, qstr qst) {
+    if (qst <= QSTR_LAST_STATIC) {
+        return qst;
+    }
+    size_t i = 0;
+    while (i < qs->len && qs->table[i] != qst) {
+        ++i;
+    }
+    if (i == qs->len) {
+        if (QSTR_LAST_STATIC + 1 + i > 0xffff) {
+            mp_raise_ValueError("too many qstrs for in-place .mpy");
+        }
+        if (qs->len == qs->alloc) {
+            qs->table = m_renew(qstr, qs->table, qs->alloc, qs->alloc * 2);
+            qs->alloc *= 2;
+        }
+        qs->table[qs->len++] = qst;
+    }
+    return QSTR_LAST_STATIC + 1 + i;
+}
+
+STATIC void inplace_encode_qstr(inplace_qstrs_t *qs, byte *ip) {
+    size_t id = inplace_qstr_id(qs, ip[0] | (ip[1] << 8));
+    ip[0] = id;
+    ip[1] = id >> 8;
+}
+
+STATIC void save_raw_code_inplace(mp_print_t *print, mp_raw_code_t *rc, inplace_qstrs_t *qs) {
+    // Save bytecode with its qstrs turned into ids
+    byte *buf = m_new(byte, rc->fun_data_len);
+    memcpy(buf, rc->fun_data, rc->fun_data_len);
+    const byte *ip = buf;
+    const byte *ip2;
+    bytecode_prelude_t prelude;
+    extract_prelude(&ip, &ip2, &prelude);
+    inplace_encode_qstr(qs, (byte*)ip2); // simple_name
+    inplace_encode_qstr(qs, (byte*)ip2 + 2); // source_file
+    for (byte *ip_top = buf + rc->fun_data_len, *bc = (byte*)ip; bc < ip_top;) {
+        size_t sz;
+        if (mp_opcode_format(bc, &sz, true) == MP_OPCODE_QSTR) {
+            inplace_encode_qstr(qs, bc + 1);
+        }
+        bc += sz;
+    }
+    mp_print_uint(print, rc->fun_data_len);
+    mp_print_bytes(print, buf, rc->fun_data_len);
+    m_del(byte, buf, rc->fun_data_len);
+
+    // Save constant table
+    mp_print_uint(print, rc->n_obj);
+    mp_print_uint(print, rc->n_raw_code);
+    const mp_uint_t *const_table = rc->const_table;
+    for (size_t i = 0; i < prelude.n_pos_args + prelude.n_kwonly_args; ++i) {
+        mp_obj_t o = (mp_obj_t)*const_table++;
+        mp_print_uint(print, inplace_qstr_id(qs, MP_OBJ_QSTR_VALUE(o)));
+    }
+    for (size_t i = 0; i < rc->n_obj; ++i) {
+        save_obj(print, (mp_obj_t)*const_table++, true);
+    }
+    for (size_t i = 0; i < rc->n_raw_code; ++i) {
+        save_raw_code_inplace(print, (mp_raw_code_t*)(uintptr_t)*const_table++, qs);
+    }
+}
+
+STATIC void save_inplace(mp_raw_code_t *rc, mp_print_t *print) {
+    if (mp_raw_code_has_native(rc)) {
+        mp_raise_ValueError("native code can't be saved in place");
+    }
+
+    // Do a dry run to gather the qstrs, then save them followed by the code
+    inplace_qstrs_t qs = {0, 16, m_new(qstr, 16)};
+    mp_print_t null_print = {NULL, null_print_strn};
+    save_raw_code_inplace(&null_print, rc, &qs);
+    mp_print_uint(print, 0);
+    mp_print_uint(print, qs.len);
+    for (size_t i = 0; i < qs.len; ++i) {
+        size_t len;
+        const byte *str = qstr_data(qs.table[i], &len);
+        mp_print_uint(print, len);
+        mp_print_bytes(print, str, len);
+    }
+    save_raw_code_inplace(print, rc, &qs);
+    m_del(qstr, qs.table, qs.alloc);
+}
+
+#endif // MICROPY_DYNAMIC_COMPILER
+
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print) {
     // header contains:
     //  byte  'M'
     //  byte  version
     //  byte  feature flags
     //  byte  number of bits in a small int
-    //  uint  size of qstr window
+    //  uint  size of qstr window (0 for the in-place layout)
     byte header[4] = {
         'M',
         MPY_VERSION,
@@ -742,6 +1091,14 @@ void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print) {
         header[2] |= MPY_FEATURE_ENCODE_ARCH(MPY_FEATURE_ARCH_DYNAMIC);
     }
     mp_print_bytes(print, header, sizeof(header));
+
+    #if MICROPY_DYNAMIC_COMPILER
+    if (mp_dynamic_compiler.persistent_code_inplace) {
+        save_inplace(rc, print);
+        return;
+    }
+    #endif
+
     mp_print_uint(print, QSTR_WINDOW_SIZE);
 
     qstr_window_t qw;
@@ -753,7 +1110,20 @@ void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print) {
 // here we define mp_raw_code_save_file depending on the port
 // TODO abstract this away properly
 
-#if defined(__i386__) || defined(__x86_64__) || defined(__unix__)
+#if MICROPY_VFS
+
+#include "py/stream.h"
+#include "extmod/vfs.h"
+
+void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename) {
+    mp_obj_t args[2] = {mp_obj_new_str(filename, strlen(filename)), MP_OBJ_NEW_QSTR(MP_QSTR_wb)};
+    mp_obj_t file = mp_vfs_open(MP_ARRAY_SIZE(args), args, (mp_map_t*)&mp_const_empty_map);
+    mp_print_t file_print = {MP_OBJ_TO_PTR(file), mp_stream_write_adaptor};
+    mp_raw_code_save(rc, &file_print);
+    mp_stream_close(file);
+}
+
+#elif defined(__i386__) || defined(__x86_64__) || defined(__unix__)
 
 #include <unistd.h>
 #include <sys/stat.h>
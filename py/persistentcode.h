@@ -31,7 +31,7 @@
 #include "py/emitglue.h"
 
 // The current version of .mpy files
-#define MPY_VERSION 4
+#define MPY_VERSION 5
 
 enum {
     MP_NATIVE_ARCH_NONE = 0,
@@ -49,6 +49,12 @@ enum {
 mp_raw_code_t *mp_raw_code_load(mp_reader_t *reader);
 mp_raw_code_t *mp_raw_code_load_mem(const byte *buf, size_t len);
 mp_raw_code_t *mp_raw_code_load_file(const char *filename);
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+// Load a .mpy image that stays valid and unchanged for the life of the VM, eg
+// one in memory-mapped flash; if it is in the in-place layout its bytecode is
+// executed directly from buf, otherwise it is loaded as normal.
+mp_raw_code_t *mp_raw_code_load_inplace(const byte *buf, size_t len);
+#endif
 
 void mp_raw_code_save(mp_raw_code_t *rc, mp_print_t *print);
 void mp_raw_code_save_file(mp_raw_code_t *rc, const char *filename);
@@ -537,6 +537,17 @@ STATIC const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->arg = unum;
             break;
 
+        case MP_BC_LOAD_FAST_LOAD_FAST:
+            instruction->qstr_opname = MP_QSTR_LOAD_FAST_LOAD_FAST;
+            instruction->arg = *ip++;
+            break;
+
+        case MP_BC_LOAD_FAST_ACCUM:
+            DECODE_UINT;
+            instruction->qstr_opname = MP_QSTR_LOAD_FAST_ACCUM;
+            instruction->arg = unum;
+            break;
+
         case MP_BC_LOAD_DEREF:
             DECODE_UINT;
             instruction->qstr_opname = MP_QSTR_LOAD_DEREF;
@@ -591,6 +602,16 @@ STATIC const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->qstr_opname = MP_QSTR_LOAD_BUILD_CLASS;
             break;
 
+        case MP_BC_BINARY_OP_SMALL_INT:
+            instruction->qstr_opname = MP_QSTR_BINARY_OP_SMALL_INT;
+            instruction->arg = *ip++;
+            break;
+
+        case MP_BC_BINARY_OP_TEMP:
+            instruction->qstr_opname = MP_QSTR_BINARY_OP_TEMP;
+            instruction->arg = *ip++;
+            break;
+
         case MP_BC_LOAD_SUBSCR:
             instruction->qstr_opname = MP_QSTR_LOAD_SUBSCR;
             break;
@@ -607,6 +628,12 @@ STATIC const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->arg = unum;
             break;
 
+        case MP_BC_INPLACE_ADD_FAST:
+            DECODE_UINT;
+            instruction->qstr_opname = MP_QSTR_INPLACE_ADD_FAST;
+            instruction->arg = unum;
+            break;
+
         case MP_BC_STORE_NAME:
             DECODE_QSTR;
             instruction->qstr_opname = MP_QSTR_STORE_NAME;
@@ -711,6 +738,27 @@ STATIC const byte *mp_prof_opcode_decode(const byte *ip, const mp_uint_t *const_
             instruction->arg = unum;
             break;
 
+        case MP_BC_BINARY_OP_POP_JUMP_IF_TRUE:
+            DECODE_SLABEL;
+            instruction->qstr_opname = MP_QSTR_BINARY_OP_POP_JUMP_IF_TRUE;
+            instruction->arg = unum;
+            instruction->argobj = MP_OBJ_NEW_QSTR(mp_binary_op_method_name[*ip++]);
+            break;
+
+        case MP_BC_BINARY_OP_POP_JUMP_IF_FALSE:
+            DECODE_SLABEL;
+            instruction->qstr_opname = MP_QSTR_BINARY_OP_POP_JUMP_IF_FALSE;
+            instruction->arg = unum;
+            instruction->argobj = MP_OBJ_NEW_QSTR(mp_binary_op_method_name[*ip++]);
+            break;
+
+        case MP_BC_FOR_RANGE:
+            DECODE_SLABEL;
+            instruction->qstr_opname = MP_QSTR_FOR_RANGE;
+            instruction->arg = unum;
+            instruction->argobj = MP_OBJ_NEW_SMALL_INT((int8_t)*ip++);
+            break;
+
         case MP_BC_SETUP_WITH:
             DECODE_ULABEL; // loop-like labels are always forward
             instruction->qstr_opname = MP_QSTR_SETUP_WITH;
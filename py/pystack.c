@@ -34,23 +34,91 @@ void mp_pystack_init(void *start, void *end) {
     MP_STATE_THREAD(pystack_start) = start;
     MP_STATE_THREAD(pystack_end) = end;
     MP_STATE_THREAD(pystack_cur) = start;
+    MP_STATE_THREAD(pystack_peak) = 0;
+    #if MICROPY_PYSTACK_GROW
+    MP_STATE_THREAD(pystack_base) = 0;
+    MP_STATE_THREAD(pystack_chunk) = NULL;
+    MP_STATE_THREAD(pystack_spare) = NULL;
+    #endif
+}
+
+#if MICROPY_PYSTACK_GROW
+
+// Size of the chunk header, keeping the data that follows it aligned.
+#define CHUNK_HEADER_SIZE ((sizeof(mp_pystack_chunk_t) + (MICROPY_PYSTACK_ALIGN - 1)) & ~(MICROPY_PYSTACK_ALIGN - 1))
+
+// Continue the pystack in a chunk on the heap with room for at least n_bytes.
+STATIC void mp_pystack_grow(size_t n_bytes) {
+    size_t len = CHUNK_HEADER_SIZE + MAX(n_bytes, MICROPY_PYSTACK_CHUNK_SIZE);
+    mp_pystack_chunk_t *chunk = MP_STATE_THREAD(pystack_spare);
+    if (chunk != NULL && chunk->len >= len) {
+        MP_STATE_THREAD(pystack_spare) = NULL;
+    } else {
+        chunk = (mp_pystack_chunk_t*)m_new_maybe(uint8_t, len);
+        if (chunk == NULL) {
+            nlr_raise(mp_obj_new_exception_arg1(&mp_type_RuntimeError,
+                MP_OBJ_NEW_QSTR(MP_QSTR_pystack_space_exhausted)));
+        }
+        chunk->len = len;
+    }
+    chunk->prev = MP_STATE_THREAD(pystack_chunk);
+    chunk->prev_start = MP_STATE_THREAD(pystack_start);
+    chunk->prev_end = MP_STATE_THREAD(pystack_end);
+    chunk->prev_cur = MP_STATE_THREAD(pystack_cur);
+    MP_STATE_THREAD(pystack_base) += MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start);
+    MP_STATE_THREAD(pystack_chunk) = chunk;
+    MP_STATE_THREAD(pystack_start) = (uint8_t*)chunk + CHUNK_HEADER_SIZE;
+    MP_STATE_THREAD(pystack_end) = (uint8_t*)chunk + chunk->len;
+    MP_STATE_THREAD(pystack_cur) = MP_STATE_THREAD(pystack_start);
 }
 
+// Free all blocks from ptr onwards, returning to the region that ptr is in.
+void mp_pystack_unwind(void *ptr) {
+    uint8_t *p = ptr;
+    while (p < MP_STATE_THREAD(pystack_start) || p > MP_STATE_THREAD(pystack_end)) {
+        mp_pystack_chunk_t *chunk = MP_STATE_THREAD(pystack_chunk);
+        assert(chunk != NULL);
+        MP_STATE_THREAD(pystack_chunk) = chunk->prev;
+        MP_STATE_THREAD(pystack_start) = chunk->prev_start;
+        MP_STATE_THREAD(pystack_end) = chunk->prev_end;
+        MP_STATE_THREAD(pystack_base) -= chunk->prev_cur - chunk->prev_start;
+        // Keep the chunk nearest the remaining stack for reuse, so a call chain
+        // that goes back and forth across the end of a region doesn't allocate
+        // a new chunk each time.
+        mp_pystack_chunk_t *spare = MP_STATE_THREAD(pystack_spare);
+        if (spare != NULL) {
+            m_del(uint8_t, spare, spare->len);
+        }
+        MP_STATE_THREAD(pystack_spare) = chunk;
+    }
+    MP_STATE_THREAD(pystack_cur) = p;
+}
+
+#endif
+
 void *mp_pystack_alloc(size_t n_bytes) {
     n_bytes = (n_bytes + (MICROPY_PYSTACK_ALIGN - 1)) & ~(MICROPY_PYSTACK_ALIGN - 1);
     #if MP_PYSTACK_DEBUG
     n_bytes += MICROPY_PYSTACK_ALIGN;
     #endif
     if (MP_STATE_THREAD(pystack_cur) + n_bytes > MP_STATE_THREAD(pystack_end)) {
+        #if MICROPY_PYSTACK_GROW
+        mp_pystack_grow(n_bytes);
+        #else
         // out of memory in the pystack
         nlr_raise(mp_obj_new_exception_arg1(&mp_type_RuntimeError,
             MP_OBJ_NEW_QSTR(MP_QSTR_pystack_space_exhausted)));
+        #endif
     }
     void *ptr = MP_STATE_THREAD(pystack_cur);
     MP_STATE_THREAD(pystack_cur) += n_bytes;
     #if MP_PYSTACK_DEBUG
     *(size_t*)(MP_STATE_THREAD(pystack_cur) - MICROPY_PYSTACK_ALIGN) = n_bytes;
     #endif
+    size_t use = mp_pystack_usage();
+    if (use > MP_STATE_THREAD(pystack_peak)) {
+        MP_STATE_THREAD(pystack_peak) = use;
+    }
     return ptr;
 }
 
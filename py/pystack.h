@@ -26,6 +26,8 @@
 #ifndef MICROPY_INCLUDED_PY_PYSTACK_H
 #define MICROPY_INCLUDED_PY_PYSTACK_H
 
+#include <string.h>
+
 #include "py/mpstate.h"
 
 // Enable this debugging option to check that the amount of memory freed is
@@ -34,13 +36,37 @@
 
 #if MICROPY_ENABLE_PYSTACK
 
+#if MICROPY_PYSTACK_GROW
+// Header of a chunk on the GC heap that the pystack has grown into.  It records
+// the state of the region below it, so that region can be returned to when all
+// the blocks in the chunk are freed.
+typedef struct _mp_pystack_chunk_t {
+    struct _mp_pystack_chunk_t *prev;
+    uint8_t *prev_start;
+    uint8_t *prev_end;
+    uint8_t *prev_cur;
+    size_t len;
+} mp_pystack_chunk_t;
+#endif
+
 void mp_pystack_init(void *start, void *end);
 void *mp_pystack_alloc(size_t n_bytes);
 
+#if MICROPY_PYSTACK_GROW
+void mp_pystack_unwind(void *ptr);
+#endif
+
 // This function can free multiple continuous blocks at once: just pass the
 // pointer to the block that was allocated first and it and all subsequently
 // allocated blocks will be freed.
 static inline void mp_pystack_free(void *ptr) {
+    #if MICROPY_PYSTACK_GROW
+    if ((uint8_t*)ptr < MP_STATE_THREAD(pystack_start) || (uint8_t*)ptr > MP_STATE_THREAD(pystack_cur)) {
+        // the block is in a region below the current chunk
+        mp_pystack_unwind(ptr);
+        return;
+    }
+    #endif
     assert((uint8_t*)ptr >= MP_STATE_THREAD(pystack_start));
     assert((uint8_t*)ptr <= MP_STATE_THREAD(pystack_cur));
     #if MP_PYSTACK_DEBUG
@@ -58,17 +84,58 @@ static inline void mp_pystack_free(void *ptr) {
     MP_STATE_THREAD(pystack_cur) = (uint8_t*)ptr;
 }
 
-static inline void mp_pystack_realloc(void *ptr, size_t n_bytes) {
+// The block being resized must be the one that was allocated last.
+static inline void *mp_pystack_realloc(void *ptr, size_t old_n_bytes, size_t n_bytes) {
+    #if MICROPY_PYSTACK_GROW
+    size_t n = (n_bytes + (MICROPY_PYSTACK_ALIGN - 1)) & ~(MICROPY_PYSTACK_ALIGN - 1);
+    if ((uint8_t*)ptr + n > MP_STATE_THREAD(pystack_end)) {
+        // Move the block to a new chunk.  The old block stays allocated until
+        // the new one is freed, so it is still traced if the allocation does a GC.
+        void *new_ptr = mp_pystack_alloc(n_bytes);
+        memcpy(new_ptr, ptr, old_n_bytes < n_bytes ? old_n_bytes : n_bytes);
+        return new_ptr;
+    }
+    #else
+    (void)old_n_bytes;
+    #endif
     mp_pystack_free(ptr);
     mp_pystack_alloc(n_bytes);
+    return ptr;
 }
 
 static inline size_t mp_pystack_usage(void) {
+    #if MICROPY_PYSTACK_GROW
+    return MP_STATE_THREAD(pystack_base) + (MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start));
+    #else
     return MP_STATE_THREAD(pystack_cur) - MP_STATE_THREAD(pystack_start);
+    #endif
 }
 
 static inline size_t mp_pystack_limit(void) {
+    #if MICROPY_PYSTACK_GROW
+    return MP_STATE_THREAD(pystack_base) + (MP_STATE_THREAD(pystack_end) - MP_STATE_THREAD(pystack_start));
+    #else
     return MP_STATE_THREAD(pystack_end) - MP_STATE_THREAD(pystack_start);
+    #endif
+}
+
+// Get the part of the pystack that is in use and not on the GC heap, which
+// must be traced explicitly by the garbage collector.
+static inline void **mp_pystack_roots(size_t *len) {
+    uint8_t *start = MP_STATE_THREAD(pystack_start);
+    uint8_t *cur = MP_STATE_THREAD(pystack_cur);
+    #if MICROPY_PYSTACK_GROW
+    mp_pystack_chunk_t *chunk = MP_STATE_THREAD(pystack_chunk);
+    if (chunk != NULL) {
+        while (chunk->prev != NULL) {
+            chunk = chunk->prev;
+        }
+        start = chunk->prev_start;
+        cur = chunk->prev_cur;
+    }
+    #endif
+    *len = (cur - start) / sizeof(void*);
+    return (void**)(void*)start;
 }
 
 #endif
@@ -108,9 +175,7 @@ static inline void *mp_nonlocal_alloc(size_t n_bytes) {
 }
 
 static inline void *mp_nonlocal_realloc(void *ptr, size_t old_n_bytes, size_t new_n_bytes) {
-    (void)old_n_bytes;
-    mp_pystack_realloc(ptr, new_n_bytes);
-    return ptr;
+    return mp_pystack_realloc(ptr, old_n_bytes, new_n_bytes);
 }
 
 static inline void mp_nonlocal_free(void *ptr, size_t n_bytes) {
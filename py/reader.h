@@ -33,14 +33,30 @@
 // it can be called again after returning MP_READER_EOF, and in that case must return MP_READER_EOF
 #define MP_READER_EOF ((mp_uint_t)(-1))
 
+// the readblock function is optional (it can be NULL) and is used instead of
+// readbyte by consumers that can take many bytes at once, eg the lexer
+// it must return a pointer to the next bytes in the input stream and store
+// their number in *len, which must be 0 if end of stream
+// the bytes only need to stay valid until the next call to the reader
+
 typedef struct _mp_reader_t {
     void *data;
     mp_uint_t (*readbyte)(void *data);
     void (*close)(void *data);
+    const byte *(*readblock)(void *data, size_t *len);
 } mp_reader_t;
 
 void mp_reader_new_mem(mp_reader_t *reader, const byte *buf, size_t len, size_t free_len);
 void mp_reader_new_file(mp_reader_t *reader, const char *filename);
 void mp_reader_new_file_from_fd(mp_reader_t *reader, int fd, bool close_fd);
 
+#if MICROPY_READER_MAP_FILE
+// Map the whole of a file read-only into memory; returns NULL if the file can't
+// be mapped.  Code loaded in place from the mapping may be referenced by any
+// object created from it, so a mapping that was loaded stays for the rest of
+// the life of the process, and is only unmapped if loading it failed.
+const byte *mp_reader_map_file(const char *filename, size_t *len);
+void mp_reader_unmap_file(const byte *buf, size_t len);
+#endif
+
 #endif // MICROPY_INCLUDED_PY_READER_H
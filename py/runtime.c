@@ -88,11 +88,19 @@ void mp_init(void) {
     #if MICROPY_ENABLE_COMPILER
     // optimization disabled by default
     MP_STATE_VM(mp_optimise_value) = 0;
+    #if MICROPY_PERSISTENT_CODE_CACHE
+    MP_STATE_VM(mp_import_cache) = false;
+    #endif
     #if MICROPY_EMIT_NATIVE
     MP_STATE_VM(default_emit_opt) = MP_EMIT_OPT_NONE;
     #endif
     #endif
 
+    #if MICROPY_OPT_CACHE_TYPE_LOOKUP
+    // invalidate any type lookup cache entries left from a previous session
+    ++MP_STATE_VM(type_cache_epoch);
+    #endif
+
     // init global module dict
     mp_obj_dict_init(&MP_STATE_VM(mp_loaded_modules_dict), 3);
 
@@ -115,6 +123,18 @@ void mp_init(void) {
     }
     #endif
 
+    #if MICROPY_PY_URE && MICROPY_PY_URE_CACHE
+    for (size_t i = 0; i < MICROPY_PY_URE_CACHE; ++i) {
+        MP_STATE_VM(ure_cache)[i] = MP_OBJ_NULL;
+    }
+    #endif
+
+    #if MICROPY_PY_UZLIB && MICROPY_PY_UZLIB_WINDOW_POOL
+    for (size_t i = 0; i < MICROPY_PY_UZLIB_WINDOW_POOL; ++i) {
+        MP_STATE_VM(uzlib_window_pool)[i] = NULL;
+    }
+    #endif
+
     #if MICROPY_VFS
     // initialise the VFS sub-system
     MP_STATE_VM(vfs_cur) = NULL;
@@ -1467,6 +1487,46 @@ mp_obj_t mp_parse_compile_execute(mp_lexer_t *lex, mp_parse_input_kind_t parse_i
     }
 }
 
+#if MICROPY_COMP_STREAM
+void mp_parse_compile_execute_stream(mp_lexer_t *lex, mp_obj_dict_t *globals, mp_obj_dict_t *locals, bool is_repl) {
+    // save context
+    mp_obj_dict_t *volatile old_globals = mp_globals_get();
+    mp_obj_dict_t *volatile old_locals = mp_locals_get();
+
+    // set new context
+    mp_globals_set(globals);
+    mp_locals_set(locals);
+
+    mp_parse_stream_t *volatile stream = NULL;
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        qstr source_name = lex->source_name;
+        stream = mp_parse_stream_new(lex);
+        mp_parse_tree_t parse_tree;
+        while (mp_parse_stream_next(stream, &parse_tree)) {
+            // the compiler frees the parse tree, and the function for the
+            // statement is garbage once it has been executed
+            mp_obj_t module_fun = mp_compile(&parse_tree, source_name, is_repl);
+            mp_call_function_0(module_fun);
+        }
+        mp_parse_stream_free(stream);
+
+        // finish nlr block, restore context
+        nlr_pop();
+        mp_globals_set(old_globals);
+        mp_locals_set(old_locals);
+    } else {
+        // exception; close the input, restore context and re-raise same exception
+        if (stream != NULL) {
+            mp_parse_stream_free(stream);
+        }
+        mp_globals_set(old_globals);
+        mp_locals_set(old_locals);
+        nlr_jump(nlr.ret_val);
+    }
+}
+#endif
+
 #endif // MICROPY_ENABLE_COMPILER
 
 NORETURN void m_malloc_fail(size_t num_bytes) {
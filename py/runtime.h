@@ -173,6 +173,14 @@ int mp_native_type_from_qstr(qstr qst);
 mp_uint_t mp_native_from_obj(mp_obj_t obj, mp_uint_t type);
 mp_obj_t mp_native_to_obj(mp_uint_t val, mp_uint_t type);
 
+#if MICROPY_EMIT_NATIVE_FLOAT
+// viper code holds a float as its raw bits in a machine word
+typedef union _mp_native_float_t {
+    mp_float_t f;
+    mp_uint_t u;
+} mp_native_float_t;
+#endif
+
 #define mp_sys_path (MP_OBJ_FROM_PTR(&MP_STATE_VM(mp_sys_path_obj)))
 #define mp_sys_argv (MP_OBJ_FROM_PTR(&MP_STATE_VM(mp_sys_argv_obj)))
 
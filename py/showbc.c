@@ -211,6 +211,16 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("LOAD_FAST_N " UINT_FMT, unum);
             break;
 
+        case MP_BC_LOAD_FAST_LOAD_FAST:
+            unum = *ip++;
+            printf("LOAD_FAST_LOAD_FAST " UINT_FMT " " UINT_FMT, unum >> 4, unum & 0xf);
+            break;
+
+        case MP_BC_LOAD_FAST_ACCUM:
+            DECODE_UINT;
+            printf("LOAD_FAST_ACCUM " UINT_FMT, unum);
+            break;
+
         case MP_BC_LOAD_DEREF:
             DECODE_UINT;
             printf("LOAD_DEREF " UINT_FMT, unum);
@@ -254,6 +264,25 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("LOAD_BUILD_CLASS");
             break;
 
+        case MP_BC_BINARY_OP_SMALL_INT: {
+            unum = *ip++;
+            static const byte small_int_op[4] = {
+                MP_BINARY_OP_ADD, MP_BINARY_OP_SUBTRACT, MP_BINARY_OP_INPLACE_ADD, MP_BINARY_OP_INPLACE_SUBTRACT
+            };
+            mp_uint_t op = small_int_op[unum >> 6];
+            printf("BINARY_OP_SMALL_INT " UINT_FMT " %s " INT_FMT, op,
+                qstr_str(mp_binary_op_method_name[op]), (mp_int_t)(unum & 0x3f) - 16);
+            break;
+        }
+
+        case MP_BC_BINARY_OP_TEMP: {
+            unum = *ip++;
+            mp_uint_t op = unum & 0x3f;
+            printf("BINARY_OP_TEMP " UINT_FMT " %s%s%s", op, qstr_str(mp_binary_op_method_name[op]),
+                unum & MP_BC_BINARY_OP_TEMP_LHS ? " lhs" : "", unum & MP_BC_BINARY_OP_TEMP_RHS ? " rhs" : "");
+            break;
+        }
+
         case MP_BC_LOAD_SUBSCR:
             printf("LOAD_SUBSCR");
             break;
@@ -268,6 +297,11 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("STORE_DEREF " UINT_FMT, unum);
             break;
 
+        case MP_BC_INPLACE_ADD_FAST:
+            DECODE_UINT;
+            printf("INPLACE_ADD_FAST " UINT_FMT, unum);
+            break;
+
         case MP_BC_STORE_NAME:
             DECODE_QSTR;
             printf("STORE_NAME %s", qstr_str(qst));
@@ -355,6 +389,26 @@ const byte *mp_bytecode_print_str(const byte *ip) {
             printf("JUMP_IF_FALSE_OR_POP " UINT_FMT, (mp_uint_t)(ip + unum - mp_showbc_code_start));
             break;
 
+        case MP_BC_BINARY_OP_POP_JUMP_IF_TRUE:
+            DECODE_SLABEL;
+            printf("BINARY_OP_POP_JUMP_IF_TRUE " UINT_FMT " %s", (mp_uint_t)(ip + unum - mp_showbc_code_start),
+                qstr_str(mp_binary_op_method_name[*ip]));
+            ip += 1;
+            break;
+
+        case MP_BC_BINARY_OP_POP_JUMP_IF_FALSE:
+            DECODE_SLABEL;
+            printf("BINARY_OP_POP_JUMP_IF_FALSE " UINT_FMT " %s", (mp_uint_t)(ip + unum - mp_showbc_code_start),
+                qstr_str(mp_binary_op_method_name[*ip]));
+            ip += 1;
+            break;
+
+        case MP_BC_FOR_RANGE:
+            DECODE_SLABEL;
+            printf("FOR_RANGE " UINT_FMT " %d", (mp_uint_t)(ip + unum - mp_showbc_code_start), (int)(int8_t)*ip);
+            ip += 1;
+            break;
+
         case MP_BC_SETUP_WITH:
             DECODE_ULABEL; // loop-like labels are always forward
             printf("SETUP_WITH " UINT_FMT, (mp_uint_t)(ip + unum - mp_showbc_code_start));
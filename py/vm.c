@@ -30,8 +30,10 @@
 #include <assert.h>
 
 #include "py/emitglue.h"
+#include "py/objstr.h"
 #include "py/objtype.h"
 #include "py/runtime.h"
+#include "py/smallint.h"
 #include "py/bc0.h"
 #include "py/bc.h"
 #include "py/profile.h"
@@ -59,9 +61,16 @@
 
 #if MICROPY_PERSISTENT_CODE
 
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+#define DECODE_QSTR \
+    qstr qst = ip[0] | ip[1] << 8; \
+    ip += 2; \
+    qst = MP_BC_INPLACE_QSTR(inplace_qstr, qst);
+#else
 #define DECODE_QSTR \
     qstr qst = ip[0] | ip[1] << 8; \
     ip += 2;
+#endif
 #define DECODE_PTR \
     DECODE_UINT; \
     void *ptr = (void*)(uintptr_t)code_state->fun_bc->const_table[unum]
@@ -86,6 +95,14 @@
 
 #endif
 
+#if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+// bytecode that is executed in place may be in read-only memory, so the map
+// lookup cache in it is only read, never updated
+#define STORE_CACHE_INDEX(idx) do { if (inplace_qstr == NULL) { *(byte*)ip = (idx); } } while (0)
+#else
+#define STORE_CACHE_INDEX(idx) (*(byte*)ip = (idx))
+#endif
+
 #define PUSH(val) *++sp = (val)
 #define POP() (*sp--)
 #define TOP() (*sp)
@@ -215,6 +232,9 @@ FRAME_SETUP();
         fastn = &code_state->state[n_state - 1];
         exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
     }
+    #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+    const uint16_t *inplace_qstr = code_state->fun_bc->inplace_qstr;
+    #endif
 
     // variables that are visible to the exception handler (declared volatile)
     mp_exc_stack_t *volatile exc_sp = MP_TAGPTR_PTR(code_state->exc_sp); // stack grows up, exc_sp points to top of stack
@@ -234,6 +254,10 @@ outer_dispatch_loop:
             const byte *ip = code_state->ip;
             mp_obj_t *sp = code_state->sp;
             mp_obj_t obj_shared;
+            #if MP_OBJ_FLOAT_TEMP
+            // the float pushed by the last BINARY_OP_TEMP, if it made a new one
+            mp_obj_t float_temp = MP_OBJ_NULL;
+            #endif
             MICROPY_VM_HOOK_INIT
 
             // If we have exception to inject, now that we finish setting up
@@ -316,6 +340,29 @@ dispatch_loop:
                     DISPATCH();
                 }
 
+                ENTRY(MP_BC_LOAD_FAST_LOAD_FAST): {
+                    mp_uint_t locals = *ip++;
+                    obj_shared = fastn[-(mp_int_t)(locals >> 4)];
+                    if (obj_shared == MP_OBJ_NULL) {
+                        goto local_name_error;
+                    }
+                    PUSH(obj_shared);
+                    obj_shared = fastn[-(mp_int_t)(locals & 0xf)];
+                    goto load_check;
+                }
+
+                ENTRY(MP_BC_LOAD_FAST_ACCUM): {
+                    DECODE_UINT;
+                    obj_shared = fastn[-unum];
+                    if (obj_shared != MP_OBJ_NULL && mp_obj_is_type(obj_shared, &mp_type_str_accum)) {
+                        // turn the accumulated string into a str for good
+                        MARK_EXC_IP_SELECTIVE();
+                        obj_shared = mp_obj_str_accum_finish(obj_shared);
+                        fastn[-unum] = obj_shared;
+                    }
+                    goto load_check;
+                }
+
                 ENTRY(MP_BC_LOAD_DEREF): {
                     DECODE_UINT;
                     obj_shared = mp_obj_cell_get(fastn[-unum]);
@@ -340,7 +387,7 @@ dispatch_loop:
                     } else {
                         mp_map_elem_t *elem = mp_map_lookup(&mp_locals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
                         if (elem != NULL) {
-                            *(byte*)ip = (elem - &mp_locals_get()->map.table[0]) & 0xff;
+                            STORE_CACHE_INDEX((elem - &mp_locals_get()->map.table[0]) & 0xff);
                             PUSH(elem->value);
                         } else {
                             PUSH(mp_load_name(MP_OBJ_QSTR_VALUE(key)));
@@ -369,7 +416,7 @@ dispatch_loop:
                     } else {
                         mp_map_elem_t *elem = mp_map_lookup(&mp_globals_get()->map, MP_OBJ_NEW_QSTR(qst), MP_MAP_LOOKUP);
                         if (elem != NULL) {
-                            *(byte*)ip = (elem - &mp_globals_get()->map.table[0]) & 0xff;
+                            STORE_CACHE_INDEX((elem - &mp_globals_get()->map.table[0]) & 0xff);
                             PUSH(elem->value);
                         } else {
                             PUSH(mp_load_global(MP_OBJ_QSTR_VALUE(key)));
@@ -404,7 +451,7 @@ dispatch_loop:
                         } else {
                             elem = mp_map_lookup(&self->members, key, MP_MAP_LOOKUP);
                             if (elem != NULL) {
-                                *(byte*)ip = elem - &self->members.table[0];
+                                STORE_CACHE_INDEX(elem - &self->members.table[0]);
                             } else {
                                 goto load_attr_cache_fail;
                             }
@@ -436,6 +483,31 @@ dispatch_loop:
                     DISPATCH();
                 }
 
+                ENTRY(MP_BC_BINARY_OP_SMALL_INT): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_uint_t arg = *ip++;
+                    mp_int_t rhs_val = (mp_int_t)(arg & 0x3f) - 16;
+                    mp_obj_t lhs = TOP();
+                    if (mp_obj_is_small_int(lhs)) {
+                        // fast path for small int arithmetic that doesn't overflow
+                        mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+                        if (arg & (1 << 6)) {
+                            lhs_val -= rhs_val;
+                        } else {
+                            lhs_val += rhs_val;
+                        }
+                        if (MP_SMALL_INT_FITS(lhs_val)) {
+                            SET_TOP(MP_OBJ_NEW_SMALL_INT(lhs_val));
+                            DISPATCH();
+                        }
+                    }
+                    MP_STATIC_ASSERT(MP_BINARY_OP_ADD + 1 == MP_BINARY_OP_SUBTRACT);
+                    MP_STATIC_ASSERT(MP_BINARY_OP_INPLACE_ADD + 1 == MP_BINARY_OP_INPLACE_SUBTRACT);
+                    mp_binary_op_t op = ((arg >> 7) ? MP_BINARY_OP_INPLACE_ADD : MP_BINARY_OP_ADD) + ((arg >> 6) & 1);
+                    SET_TOP(mp_binary_op(op, lhs, MP_OBJ_NEW_SMALL_INT(rhs_val)));
+                    DISPATCH();
+                }
+
                 ENTRY(MP_BC_LOAD_BUILD_CLASS):
                     MARK_EXC_IP_SELECTIVE();
                     PUSH(mp_load_build_class());
@@ -460,6 +532,19 @@ dispatch_loop:
                     DISPATCH();
                 }
 
+                ENTRY(MP_BC_INPLACE_ADD_FAST): {
+                    MARK_EXC_IP_SELECTIVE();
+                    DECODE_UINT;
+                    mp_obj_t rhs = POP();
+                    // The value under rhs was loaded only to check that the
+                    // local is bound.  It may be stale if loading the local
+                    // while evaluating rhs turned it into a str, so use the
+                    // local itself.
+                    sp--;
+                    mp_obj_str_accum_add(&fastn[-unum], rhs);
+                    DISPATCH();
+                }
+
                 ENTRY(MP_BC_STORE_NAME): {
                     MARK_EXC_IP_SELECTIVE();
                     DECODE_QSTR;
@@ -504,7 +589,7 @@ dispatch_loop:
                         } else {
                             elem = mp_map_lookup(&self->members, key, MP_MAP_LOOKUP);
                             if (elem != NULL) {
-                                *(byte*)ip = elem - &self->members.table[0];
+                                STORE_CACHE_INDEX(elem - &self->members.table[0]);
                             } else {
                                 goto store_attr_cache_fail;
                             }
@@ -615,6 +700,67 @@ dispatch_loop:
                     DISPATCH_WITH_PEND_EXC_CHECK();
                 }
 
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_TRUE):
+                ENTRY(MP_BC_BINARY_OP_POP_JUMP_IF_FALSE): {
+                    MARK_EXC_IP_SELECTIVE();
+                    bool jump_if = ip[-1] == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE;
+                    DECODE_SLABEL;
+                    mp_binary_op_t op = *ip;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = POP();
+                    bool cond;
+                    if (op <= MP_BINARY_OP_NOT_EQUAL && mp_obj_is_small_int(lhs) && mp_obj_is_small_int(rhs)) {
+                        // fast path for the comparison of two small ints
+                        mp_int_t lhs_val = MP_OBJ_SMALL_INT_VALUE(lhs);
+                        mp_int_t rhs_val = MP_OBJ_SMALL_INT_VALUE(rhs);
+                        switch (op) {
+                            case MP_BINARY_OP_LESS: cond = lhs_val < rhs_val; break;
+                            case MP_BINARY_OP_MORE: cond = lhs_val > rhs_val; break;
+                            case MP_BINARY_OP_EQUAL: cond = lhs_val == rhs_val; break;
+                            case MP_BINARY_OP_LESS_EQUAL: cond = lhs_val <= rhs_val; break;
+                            case MP_BINARY_OP_MORE_EQUAL: cond = lhs_val >= rhs_val; break;
+                            default: cond = lhs_val != rhs_val; break;
+                        }
+                    } else {
+                        cond = mp_obj_is_true(mp_binary_op(op, lhs, rhs));
+                    }
+                    if (cond == jump_if) {
+                        ip += slab;
+                    } else {
+                        ip += 1;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
+                ENTRY(MP_BC_FOR_RANGE): {
+                    // stack is: end, var
+                    // increment var by step and loop again if it hasn't reached end
+                    MARK_EXC_IP_SELECTIVE();
+                    DECODE_SLABEL;
+                    mp_int_t step = (int8_t)*ip;
+                    mp_obj_t end = sp[-1];
+                    mp_obj_t var = TOP();
+                    bool cond;
+                    if (mp_obj_is_small_int(var) && mp_obj_is_small_int(end)
+                        && MP_SMALL_INT_FITS(MP_OBJ_SMALL_INT_VALUE(var) + step)) {
+                        // fast path for a small int loop counter
+                        mp_int_t var_val = MP_OBJ_SMALL_INT_VALUE(var) + step;
+                        mp_int_t end_val = MP_OBJ_SMALL_INT_VALUE(end);
+                        SET_TOP(MP_OBJ_NEW_SMALL_INT(var_val));
+                        cond = step > 0 ? var_val < end_val : var_val > end_val;
+                    } else {
+                        var = mp_binary_op(MP_BINARY_OP_INPLACE_ADD, var, MP_OBJ_NEW_SMALL_INT(step));
+                        SET_TOP(var);
+                        cond = mp_obj_is_true(mp_binary_op(step > 0 ? MP_BINARY_OP_MORE : MP_BINARY_OP_LESS, end, var));
+                    }
+                    if (cond) {
+                        ip += slab;
+                    } else {
+                        ip += 1;
+                    }
+                    DISPATCH_WITH_PEND_EXC_CHECK();
+                }
+
                 ENTRY(MP_BC_JUMP_IF_TRUE_OR_POP): {
                     DECODE_SLABEL;
                     if (mp_obj_is_true(TOP())) {
@@ -1308,6 +1454,31 @@ yield:
                     SET_TOP(mp_unary_op(ip[-1] - MP_BC_UNARY_OP_MULTI, TOP()));
                     DISPATCH();
 
+                ENTRY(MP_BC_BINARY_OP_TEMP): {
+                    MARK_EXC_IP_SELECTIVE();
+                    mp_uint_t arg = *ip++;
+                    mp_obj_t rhs = POP();
+                    mp_obj_t lhs = TOP();
+                    #if MP_OBJ_FLOAT_TEMP
+                    // An operand flagged as temporary was pushed by another
+                    // BINARY_OP_TEMP.  If it's the float that op created then
+                    // nothing else refers to it and it can hold the result.
+                    mp_obj_t temp = MP_OBJ_NULL;
+                    if ((arg & MP_BC_BINARY_OP_TEMP_LHS) && lhs == float_temp) {
+                        temp = lhs;
+                    } else if ((arg & MP_BC_BINARY_OP_TEMP_RHS) && rhs == float_temp) {
+                        temp = rhs;
+                    }
+                    float_temp = mp_obj_float_binary_op_temp(arg & 0x3f, lhs, rhs, temp);
+                    if (float_temp != MP_OBJ_NULL) {
+                        SET_TOP(float_temp);
+                        DISPATCH();
+                    }
+                    #endif
+                    SET_TOP(mp_binary_op(arg & 0x3f, lhs, rhs));
+                    DISPATCH();
+                }
+
                 ENTRY(MP_BC_BINARY_OP_MULTI): {
                     MARK_EXC_IP_SELECTIVE();
                     mp_obj_t rhs = POP();
@@ -1467,6 +1638,10 @@ unwind_loop:
                 qstr block_name = ip[0] | (ip[1] << 8);
                 qstr source_file = ip[2] | (ip[3] << 8);
                 ip += 4;
+                #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+                block_name = MP_BC_INPLACE_QSTR(code_state->fun_bc->inplace_qstr, block_name);
+                source_file = MP_BC_INPLACE_QSTR(code_state->fun_bc->inplace_qstr, source_file);
+                #endif
                 #else
                 qstr block_name = mp_decode_uint_value(ip);
                 ip = mp_decode_uint_skip(ip);
@@ -1515,6 +1690,9 @@ unwind_loop:
                 size_t n_state = mp_decode_uint_value(code_state->fun_bc->bytecode);
                 fastn = &code_state->state[n_state - 1];
                 exc_stack = (mp_exc_stack_t*)(code_state->state + n_state);
+                #if MICROPY_PERSISTENT_CODE_LOAD_INPLACE
+                inplace_qstr = code_state->fun_bc->inplace_qstr;
+                #endif
                 // variables that are visible to the exception handler (declared volatile)
                 exc_sp = MP_TAGPTR_PTR(code_state->exc_sp); // stack grows up, exc_sp points to top of stack
                 goto unwind_loop;
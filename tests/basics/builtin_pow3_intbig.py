@@ -20,3 +20,7 @@ print(hex(pow(2, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, x-1, x))) # Should be 1, since x is prime
 print(hex(pow(y, y-1, x))) # Should be a 'big value'
 print(hex(pow(y, y-1, y))) # Should be a 'big value'
+
+# odd and even moduli of various sizes, with bases larger than and negative to them
+for m in (3, 0xffffffff, (1 << 64) + 1, (1 << 64) + 2, x * y, x * y + 1, (1 << 2000) - 1):
+    print(hex(pow(y, x, m)), hex(pow(-y, 65537, m)), hex(pow(x * y * y, 3, m)))
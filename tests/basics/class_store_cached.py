@@ -0,0 +1,41 @@
+# store to a class after its attributes have been looked up, to check that
+# any cached lookups are invalidated
+
+class A:
+    x = 1
+    def f(self):
+        return 'A.f'
+
+class B(A):
+    pass
+
+b = B()
+for i in range(2):
+    print(B.x, b.x, b.f())
+
+# store to a base class
+A.x = 2
+A.f = lambda self: 'A.f2'
+print(B.x, b.x, b.f())
+
+# shadow in the subclass
+B.x = 3
+B.f = lambda self: 'B.f'
+print(A.x, B.x, b.x, b.f())
+
+# delete from the subclass, lookup falls back to the base class
+del B.x
+del B.f
+print(B.x, b.x, b.f())
+
+# instance member shadows class attribute
+b.x = 4
+print(B.x, b.x)
+
+# class with the same attribute created after a collection
+import gc
+for i in range(4):
+    class C:
+        y = i
+    gc.collect()
+    print(C.y, C().y)
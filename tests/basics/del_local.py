@@ -23,3 +23,18 @@ def g():
     except NameError:
         print("NameError");
 g()
+
+# delete a local that strings are added to, then try to add to it and reference it
+def h():
+    s = ""
+    s += "a"
+    del s
+    try:
+        s += "b"
+    except NameError:
+        print("NameError")
+    try:
+        print(s)
+    except NameError:
+        print("NameError")
+h()
@@ -19,3 +19,14 @@ for n in range(20):
             else:
                 if j != i:
                     print(j, 'not in d, but it should be')
+
+# repeatedly add and delete keys, including the most recently added one
+d = {}
+for i in range(100):
+    d[i] = i
+    d[i + 1000] = i
+    del d[i + 1000]
+    if i % 2:
+        del d[i - 1]
+        del d[i]
+print(len(d), d)
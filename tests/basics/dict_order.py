@@ -0,0 +1,39 @@
+# test that dicts preserve insertion order, when the map layout supports it
+
+d = {}
+for k in (3, 2, 1, 'b', 'a', 1 << 20, 0):
+    d[k] = k
+if list(d) != [3, 2, 1, 'b', 'a', 1 << 20, 0]:
+    print('SKIP')
+    raise SystemExit
+
+# growing keeps order
+d = {}
+for i in range(50):
+    d[(i * 37) % 101] = i
+print(list(d.values()) == list(range(50)))
+
+# deleting and re-inserting moves a key to the end
+d = {'x': 1, 'y': 2, 'z': 3}
+del d['x']
+d['x'] = 4
+print(list(d.items()))
+
+# overwriting a value keeps its position
+d['y'] = 5
+print(list(d.items()))
+
+# popitem removes the most recent item
+print(d.popitem(), d)
+
+# copy preserves order
+d = {}
+for i in range(10, 0, -1):
+    d[str(i)] = i
+del d['5']
+print(list(d.copy()))
+
+# keyword arguments are collected in order
+def f(**kw):
+    return list(kw)
+print(f(c=1, b=2, a=3))
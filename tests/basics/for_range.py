@@ -68,3 +68,61 @@ try:
         print(x)
 except TypeError:
     print('TypeError')
+
+# loop variable is not a simple name
+class A:
+    pass
+a = A()
+for a.x in range(2):
+    print(a.x)
+l = [0, 0]
+for l[1] in range(3, 0, -1):
+    print(l)
+try:
+    for x, y in range(2):
+        pass
+except TypeError:
+    print('TypeError')
+
+# various steps, including ones that don't fit in a byte
+for step in (1, 2, 127, 128, 1000, -1, -3, -128, -129, -1000):
+    print(step, [x for x in range(-300, 300, step)][:3])
+    n = 0
+    for x in range(-300, 300, step):
+        n += 1
+    for x in range(300, -300, step):
+        n += 1
+    print(n)
+
+# loop counter that goes beyond a small int
+big = 1 << 40
+for x in range(big - 2, big + 1):
+    print(x)
+for x in range(0x3fffffff - 1, 0x3fffffff + 2):
+    print(x)
+for x in range(-0x40000000 + 1, -0x40000000 - 2, -1):
+    print(x)
+
+# assignment to the loop variable doesn't alter the loop
+for x in range(3):
+    print(x)
+    x = 10
+
+# else, break and continue
+for x in range(3):
+    if x == 1:
+        continue
+    print(x)
+else:
+    print('else')
+for x in range(10):
+    if x == 2:
+        break
+else:
+    print('else')
+print(x)
+x = None
+for x in range(0):
+    print(x)
+else:
+    print('else', x)
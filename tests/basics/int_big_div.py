@@ -8,3 +8,7 @@ x = 0x8000000000000000
 print((x + 1) // x)
 x = 0x86c60128feff5330
 print((x + 1) // x)
+
+# check an edge case where the quotient estimate overflows the borrow
+x = (1 << 100) - 1
+print(((x - 3) << 128) // x, ((x - 3) << 128) % x)
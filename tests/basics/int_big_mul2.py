@@ -0,0 +1,24 @@
+# test multiplication and squaring of large ints, of balanced and unbalanced sizes
+
+def check(a, b):
+    p = a * b
+    q = p // b
+    # print a digest of the product, and check it against division
+    h = hex(p)
+    print(len(h), h[:20], h[-16:], q == a, p % b)
+
+a = (1 << 3000) // 7 + 12345
+b = (1 << 2500) // 3 - 1
+for n in (100, 600, 1000, 1500, 2000, 3000):
+    x = a >> (3000 - n)
+    check(x, x)
+    check(x, x + 1)
+    check(x, b >> (2500 - n // 2))
+    check(x, b >> (2500 - n // 7))
+    check(-x, x)
+    check(x, -(x >> 1))
+
+# squaring a value with all digits set
+x = (1 << 4096) - 1
+print(x * x == (1 << 8192) - (1 << 4097) + 1)
+print(x ** 3 == x * x * x)
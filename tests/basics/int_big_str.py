@@ -0,0 +1,21 @@
+# test conversion of large ints to and from strings in various bases
+
+x = 3 ** 2500 + 12345
+for base in (2, 3, 7, 8, 10, 16, 32, 36):
+    digits = '0123456789abcdefghijklmnopqrstuvwxyz'
+    s = ''
+    y = x
+    while y:
+        s = digits[y % base] + s
+        y //= base
+    print(base, len(s), int(s, base) == x, int(s.upper(), base) == x, int('-000' + s, base) == -x)
+
+# formatting, including leading and trailing zero digits
+for y in (x, -x, x << 300, 10 ** 1500, 10 ** 1500 - 1):
+    print(str(y)[:20], str(y)[-20:], len(str(y)))
+    print(hex(y)[:20], hex(y)[-20:], oct(y)[-20:], bin(y)[-20:])
+    print('{:,}'.format(y)[-20:], '{:X}'.format(y)[-20:])
+    print(int(str(y)) == y, int(hex(y), 16) == y, int(oct(y), 8) == y, int(bin(y), 2) == y)
+
+# long runs of zero digits
+print(int('1' + '0' * 1000) == 10 ** 1000, int('0' * 1000 + '1' * 1000) == int('1' * 1000))
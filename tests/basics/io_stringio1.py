@@ -43,3 +43,16 @@ for f in [a.read, a.getvalue, lambda:a.write("")]:
         print("ValueError")
     except ValueError:
         print("ValueError")
+
+# getvalue shares its buffer with the returned value until the next write
+a = io.StringIO()
+a.write("abc")
+v = a.getvalue()
+a.write("def")
+print(v, a.getvalue(), a.getvalue())
+a.seek(1)
+a.write("X")
+print(v, a.getvalue(), a.read())
+a.seek(8)
+a.write("Y")
+print(v, repr(a.getvalue()))
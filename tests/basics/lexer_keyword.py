@@ -0,0 +1,25 @@
+# test that keywords are recognised, and names that are similar to them are not
+
+kws = (
+    'False', 'None', 'True', '__debug__', 'and', 'as', 'assert', 'async', 'await',
+    'break', 'class', 'continue', 'def', 'del', 'elif', 'else', 'except', 'finally',
+    'for', 'from', 'global', 'if', 'import', 'in', 'is', 'lambda', 'nonlocal', 'not',
+    'or', 'pass', 'raise', 'return', 'try', 'while', 'with', 'yield',
+)
+
+# async and await are optional in MicroPython
+try:
+    exec('async def f(): pass')
+except SyntaxError:
+    kws = tuple(kw for kw in kws if kw not in ('async', 'await'))
+
+for kw in kws:
+    for name in (kw, kw + '_', '_' + kw, kw[:-1], kw[1:], kw.upper(), kw.lower()):
+        try:
+            exec(name + ' = 1')
+            is_kw = False
+        except SyntaxError:
+            is_kw = True
+        if is_kw != (name in kws):
+            print('wrong:', name)
+print('done')
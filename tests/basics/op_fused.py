@@ -0,0 +1,65 @@
+# test sequences that the bytecode emitter may fuse into a single opcode
+
+def add_sub(x, y):
+    a = x + 1
+    b = x - 16
+    c = y + 47
+    a += 3
+    b -= 5
+    return a, b, c
+
+print(add_sub(1, 2))
+print(add_sub(-10, 10))
+
+# result no longer fits in a small int
+print(add_sub(0x3fffffff, 0x3fffffff))
+print(add_sub(0x3fffffffffffffff, -0x4000000000000000))
+
+# non-int operands
+print(add_sub(1.5, 2.5))
+print(add_sub(True, False))
+try:
+    add_sub('a', 'b')
+except TypeError:
+    print('TypeError')
+
+def load_two(x, y):
+    return x, y
+
+print(load_two(1, 2))
+
+def unbound():
+    if False:
+        a = 1
+    b = 2
+    return a, b
+
+try:
+    unbound()
+except NameError:
+    print('NameError')
+
+def compare_jump(x, y):
+    n = 0
+    if x < y:
+        n += 1
+    if x == y:
+        n += 10
+    if not x > y:
+        n += 100
+    while x < y:
+        x += 1
+        n += 1000
+    return n
+
+print(compare_jump(1, 3))
+print(compare_jump(3, 1))
+print(compare_jump(2, 2))
+print(compare_jump(1 << 70, (1 << 70) + 2))
+print(compare_jump(1.0, 3))
+print(compare_jump('b', 'a'))
+print(compare_jump([1], [1]))
+try:
+    compare_jump(1, 'a')
+except TypeError:
+    print('TypeError')
@@ -0,0 +1,69 @@
+# test building up strings in a local variable with +=
+
+def f(n):
+    s = ""
+    for i in range(n):
+        s += "ab" + str(i)
+    return s
+print(f(5), len(f(1000)))
+
+# the value can be read back between additions
+def f():
+    s = "x"
+    s += "y"
+    t = s
+    s += "z"
+    print(t, s, s is t)
+    s += s
+    print(s)
+    s += "%d" % len(s)
+    print(s)
+    d = {s: 1}
+    print(d, s == "xyzxyz6", hash(s) == hash("xyzxyz6"))
+    try:
+        s += 5
+    except TypeError:
+        print("TypeError", s)
+    s += "w"
+    print(s)
+f()
+
+# the local can hold other types
+def f():
+    s = [1]
+    s += "ab"
+    print(s)
+    s = 1
+    s += "a" if 0 else 2
+    print(s)
+    s = b"a"
+    s += b"b"
+    print(s)
+f()
+
+# str subclass
+class S(str):
+    pass
+def f():
+    s = S("a")
+    s += "b"
+    print(type(s) is str, s)
+f()
+
+# in a generator
+def f():
+    s = ""
+    for c in "abc":
+        s += "<" + c
+        yield s
+print(list(f()))
+
+# in a closure the local is a cell
+def f():
+    s = ""
+    def g():
+        return s
+    for c in "abc":
+        s += repr(c)
+    return g()
+print(f())
@@ -0,0 +1,44 @@
+try:
+    import btree
+    import uio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+f = uio.BytesIO()
+db = btree.open(f, pagesize=512)
+
+# a batch from an iterable of pairs, with keys in ascending order
+db.update((bytes("%04d" % i, "ascii"), bytes("val%d" % i, "ascii")) for i in range(100))
+print(len(list(db.keys())))
+print(db[b"0000"], db[b"0042"], db[b"0099"])
+print(len(f.getvalue()) > 0)
+
+# a batch from a dict, replacing an existing value
+db.update({b"0001": b"one", b"zz": b"last"})
+print(db[b"0001"], db[b"zz"])
+
+# a batch from a list of pairs, with keys not in order
+db.update([(b"b", b"2"), (b"a", b"1")])
+print(list(db.items(b"a", b"c")))
+
+# items must be pairs of str or bytes
+try:
+    db.update([(b"x",)])
+except ValueError:
+    print("ValueError")
+try:
+    db.update([(b"x", 1)])
+except TypeError:
+    print("TypeError")
+
+# items() with REUSE returns the same tuple each time
+for k, v in db.items(b"a", None, btree.REUSE):
+    print(k, v)
+items = [kv for kv in db.items(b"a", None, btree.REUSE)]
+print(len(items), items[0] is items[-1])
+items = list(db.items(b"a"))
+print(len(items), items[0] is items[-1], items)
+
+db.close()
+f.close()
@@ -0,0 +1,133 @@
+# test FrameBuffer.blit, fill_rect and scroll against drawing pixel by pixel
+
+try:
+    import framebuf
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+formats = (
+    ('MVLSB', framebuf.MONO_VLSB, 1),
+    ('MHLSB', framebuf.MONO_HLSB, 1),
+    ('MHMSB', framebuf.MONO_HMSB, 1),
+    ('GS2', framebuf.GS2_HMSB, 3),
+    ('GS4', framebuf.GS4_HMSB, 15),
+    ('GS8', framebuf.GS8, 255),
+    ('RGB565', framebuf.RGB565, 0xffff),
+)
+
+def new(fmt, w, h):
+    return framebuf.FrameBuffer(bytearray(2 * (w + 8) * (h + 8)), w, h, fmt)
+
+def pattern(fb, w, h, mask, seed):
+    for y in range(h):
+        for x in range(w):
+            fb.pixel(x, y, ((x + seed) * 7 + y * 13 + x * y) & mask)
+
+def pixels(fb, w, h):
+    return [fb.pixel(x, y) for y in range(h) for x in range(w)]
+
+def ref_blit(dest, src, x, y, sw, sh, key=-1, pal=None):
+    todo = []
+    for sy in range(sh):
+        for sx in range(sw):
+            c = src.pixel(sx, sy)
+            if pal is not None and c < 4:
+                c = pal.pixel(c, 0)
+            if c != key:
+                todo.append((x + sx, y + sy, c))
+    for px, py, c in todo:
+        dest.pixel(px, py, c)
+
+W, H = 21, 19
+
+# blit between framebuffers of the same format, at offsets which do and
+# do not fall on byte boundaries
+for name, fmt, mask in formats:
+    ok = True
+    src = new(fmt, 13, 11)
+    pattern(src, 13, 11, mask, 1)
+    for x, y in ((0, 0), (8, 8), (3, 5), (-8, -8), (-3, 2), (16, 16), (4, -5)):
+        for key in (-1, 2):
+            dest = new(fmt, W, H)
+            ref = new(fmt, W, H)
+            pattern(dest, W, H, mask, 5)
+            pattern(ref, W, H, mask, 5)
+            dest.blit(src, x, y, key)
+            ref_blit(ref, src, x, y, 13, 11, key)
+            ok = ok and pixels(dest, W, H) == pixels(ref, W, H)
+    print('blit', name, ok)
+
+# blit within the same framebuffer, where source and destination overlap
+for name, fmt, mask in formats:
+    ok = True
+    for x, y in ((0, 8), (0, -8), (8, 0), (-8, 0), (3, 1), (-1, -3), (8, 16), (2, 0)):
+        for key in (-1, 2):
+            fb = new(fmt, W, H)
+            ref = new(fmt, W, H)
+            copy = new(fmt, W, H)
+            for b in (fb, ref, copy):
+                pattern(b, W, H, mask, 3)
+            fb.blit(fb, x, y, key)
+            ref_blit(ref, copy, x, y, W, H, key)
+            ok = ok and pixels(fb, W, H) == pixels(ref, W, H)
+    print('blit self', name, ok)
+
+# fill_rect
+for name, fmt, mask in formats:
+    ok = True
+    for x, y, w, h in ((0, 0, W, H), (1, 2, 3, 4), (3, 0, 17, 9), (-2, 7, 30, 1), (8, 8, 8, 8), (5, -3, 1, 30)):
+        fb = new(fmt, W, H)
+        ref = new(fmt, W, H)
+        pattern(fb, W, H, mask, 2)
+        pattern(ref, W, H, mask, 2)
+        col = 0x5a5a & mask
+        fb.fill_rect(x, y, w, h, col)
+        for py in range(max(y, 0), min(y + h, H)):
+            for px in range(max(x, 0), min(x + w, W)):
+                ref.pixel(px, py, col)
+        ok = ok and pixels(fb, W, H) == pixels(ref, W, H)
+    print('fill_rect', name, ok)
+
+# scroll
+for name, fmt, mask in formats:
+    ok = True
+    for xstep, ystep in ((0, 1), (0, -3), (8, 0), (-8, 2), (1, 1), (-5, -4), (W, 0), (0, -H - 1)):
+        fb = new(fmt, W, H)
+        ref = new(fmt, W, H)
+        copy = new(fmt, W, H)
+        for b in (fb, ref, copy):
+            pattern(b, W, H, mask, 4)
+        fb.scroll(xstep, ystep)
+        for y in range(H):
+            for x in range(W):
+                if 0 <= x - xstep < W and 0 <= y - ystep < H:
+                    ref.pixel(x, y, copy.pixel(x - xstep, y - ystep))
+        ok = ok and pixels(fb, W, H) == pixels(ref, W, H)
+    print('scroll', name, ok)
+
+# blit through a 4 colour palette, colours outside it are drawn unchanged
+pal = framebuf.FrameBuffer(bytearray(2 * 4), 4, 1, framebuf.RGB565)
+for i, c in enumerate((0x0000, 0xf800, 0x07e0, 0x001f)):
+    pal.pixel(i, 0, c)
+for name, fmt, mask in formats[:5]:
+    ok = True
+    src = new(fmt, 13, 11)
+    pattern(src, 13, 11, mask, 1)
+    for x, y in ((0, 0), (3, 5), (-4, -2)):
+        for key in (-1, 0xf800):
+            dest = new(framebuf.RGB565, W, H)
+            ref = new(framebuf.RGB565, W, H)
+            dest.fill(0x1234)
+            ref.fill(0x1234)
+            dest.blit(src, x, y, key, pal)
+            ref_blit(ref, src, x, y, 13, 11, key, pal)
+            ok = ok and pixels(dest, W, H) == pixels(ref, W, H)
+    print('blit palette', name, ok)
+
+# palette with None is the same as no palette
+fb = new(framebuf.RGB565, 4, 2)
+src = new(framebuf.RGB565, 2, 2)
+src.fill(0xabcd)
+fb.blit(src, 1, 0, -1, None)
+print(bytes(fb)[:16])
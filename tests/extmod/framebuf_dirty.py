@@ -0,0 +1,49 @@
+# test FrameBuffer.dirty, which returns the region drawn to since the last call
+
+try:
+    import framebuf
+    framebuf.FrameBuffer.dirty
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+w = 32
+h = 16
+fbuf = framebuf.FrameBuffer(bytearray(w * h * 2), w, h, framebuf.RGB565)
+print(fbuf.dirty())
+
+fbuf.pixel(3, 4, 1)
+print(fbuf.dirty())
+print(fbuf.dirty())
+
+# regions are merged
+fbuf.pixel(3, 4, 1)
+fbuf.hline(10, 2, 5, 1)
+fbuf.vline(1, 9, 3, 1)
+print(fbuf.dirty())
+
+# clipped to the framebuffer
+fbuf.fill_rect(-5, -5, 10, 8, 1)
+print(fbuf.dirty())
+fbuf.rect(20, 10, 40, 40, 1)
+print(fbuf.dirty())
+fbuf.line(30, -4, 2, 6, 1)
+print(fbuf.dirty())
+fbuf.text('ab', 28, 12)
+print(fbuf.dirty())
+
+# nothing drawn
+fbuf.pixel(w, 0, 1)
+fbuf.fill_rect(0, h, 4, 4, 1)
+fbuf.pixel(0, 0)
+print(fbuf.dirty())
+
+# blit and scroll
+src = framebuf.FrameBuffer(bytearray(4 * 4 * 2), 4, 4, framebuf.RGB565)
+fbuf.blit(src, 30, -1)
+print(fbuf.dirty())
+print(src.dirty())
+fbuf.scroll(2, -3)
+print(fbuf.dirty())
+fbuf.fill(0)
+print(fbuf.dirty())
@@ -0,0 +1,47 @@
+try:
+    import ubinascii
+    ubinascii.b2a_base64_into
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# the _into functions write the same output as their allocating versions,
+# returning the number of bytes written
+buf = bytearray(20)
+for data in (b"", b"f", b"fo", b"foo", b"foob", b"\x00\xff\x80\x7f\x3e\x3f"):
+    n = ubinascii.b2a_base64_into(data, buf)
+    print(n, buf[:n] == ubinascii.b2a_base64(data))
+    n = ubinascii.hexlify_into(data, buf)
+    print(n, buf[:n] == ubinascii.hexlify(data))
+
+for data in (b"", b"Zg==", b"Zm9v", b"Zm9vYmE=", b"Zm9v\nYmFy\n", b"Zm9v===YmFy", b"AP+Afz4/"):
+    n = ubinascii.a2b_base64_into(data, buf)
+    print(n, buf[:n])
+
+# a larger buffer is left untouched past the output
+buf = bytearray(b"-" * 12)
+print(ubinascii.b2a_base64_into(b"12345", buf), buf)
+buf = bytearray(b"-" * 12)
+print(ubinascii.hexlify_into(b"\x12\xab", buf), buf)
+
+# the buffer must be large enough
+for f, data in (
+    (ubinascii.b2a_base64_into, b"12345"),
+    (ubinascii.hexlify_into, b"12345"),
+    (ubinascii.a2b_base64_into, b"MTIzNDU="),
+):
+    try:
+        f(data, bytearray(4))
+    except ValueError:
+        print("ValueError")
+
+# padding errors are still reported
+try:
+    ubinascii.a2b_base64_into(b"abc", bytearray(4))
+except ValueError:
+    print("ValueError")
+
+# the output can be a slice of a larger buffer
+buf = bytearray(16)
+n = ubinascii.b2a_base64_into(b"sensor", memoryview(buf)[4:])
+print(n, buf)
@@ -0,0 +1,31 @@
+try:
+    import uhashlib
+    uhashlib.sha256_into
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# sha256_into writes the digest into the given buffer
+buf = bytearray(32)
+for data in (b"", b"123", b"abcd" * 1000, b"\xff" * 56, bytearray(b"\xff" * 64)):
+    print(uhashlib.sha256_into(data, buf), buf == uhashlib.sha256(data).digest())
+
+# a larger buffer is filled at the start
+buf = bytearray(b"-" * 36)
+uhashlib.sha256_into(b"123", buf)
+print(buf)
+
+# and the buffer must be large enough
+try:
+    uhashlib.sha256_into(b"123", bytearray(31))
+except ValueError:
+    print("ValueError")
+
+# test vectors from RFC 4231
+print(uhashlib.hmac_sha256(b"\x0b" * 20, b"Hi There"))
+print(uhashlib.hmac_sha256(b"Jefe", b"what do ya want for nothing?"))
+print(uhashlib.hmac_sha256(b"\xaa" * 131, b"Test Using Larger Than Block-Size Key - Hash Key First"))
+
+# keys of exactly a block, and empty keys and messages
+print(uhashlib.hmac_sha256(b"k" * 64, b"x" * 200))
+print(uhashlib.hmac_sha256(b"", b""))
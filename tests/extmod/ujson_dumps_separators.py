@@ -0,0 +1,45 @@
+try:
+    from uio import StringIO
+    import ujson as json
+except ImportError:
+    try:
+        from io import StringIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+obj = {"a": [1, -2, {"b": None}], "c": "x"}
+
+for args in (
+    {},
+    {"separators": (",", ":")},
+    {"separators": (" , ", " : ")},
+    {"indent": 2},
+    {"indent": 0},
+    {"indent": "\t"},
+    {"indent": 1, "separators": (",", ":")},
+):
+    print(json.dumps(obj, **args))
+    s = StringIO()
+    json.dump(obj, s, **args)
+    print(s.getvalue() == json.dumps(obj, **args))
+
+# empty containers with indent
+print(json.dumps([[], {}, [[]]], indent=2))
+
+# the fast paths for ints, strs and floats
+print(json.dumps([0, 1, -1, 123456789, -1073741824, 2 ** 100, -(2 ** 100)]))
+print(json.dumps(["", "abc", 'a"b\\c', "\n\r\t\x01\x1f"]))
+print(json.dumps([0.5, -2.25, 10.0, 1.1, 9.3, 123456.789, 0.0001, 99999.999999]))
+
+# a long document written through the stream in many blocks
+obj = [{"id": i, "v": i / 4} for i in range(200)]
+s = StringIO()
+json.dump(obj, s, separators=(",", ":"))
+print(len(s.getvalue()), json.loads(s.getvalue()) == obj)
+
+try:
+    json.dumps(1, separators=(","))
+except (ValueError, TypeError):
+    print("Exception")
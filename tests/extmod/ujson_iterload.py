@@ -0,0 +1,39 @@
+try:
+    from uio import StringIO
+    import ujson as json
+    json.iterload
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+def events(s):
+    try:
+        for ev in json.iterload(StringIO(s)):
+            print(ev)
+    except ValueError:
+        print("ValueError")
+
+
+events("1")
+events('"abc"')
+events("[]")
+events("{}")
+events('{"a": [1, 2.5, {"b": null}], "c": {"d": true}}')
+events('[[], [false, "x"], {}]')
+
+# the events can be consumed one at a time
+it = json.iterload(StringIO('{"a": 1, "b": 2}'))
+print(next(it))
+print(next(it), next(it))
+print(list(it))
+
+# malformed documents
+events("")
+events("[1")
+events("[1}")
+events('{"a"}')
+events('{[1]: 2}')
+events("1 2")
+events("[] []")
+events("]")
@@ -0,0 +1,44 @@
+# test ujson.load with tokens that straddle the chunks read from the stream
+
+try:
+    from uio import StringIO
+    import ujson as json
+except:
+    try:
+        from io import StringIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+doc = '{"key": "%s", "esc": "a\\nb\\u0041%s", "num": [12345678, -1.25e3, 0.000125, %s]}' % (
+    "x" * 70,
+    "y" * 40,
+    "9" * 30,
+)
+ref = json.loads(doc)
+print(ref["key"] == "x" * 70, ref["esc"][:4], ref["num"])
+
+# shift the document through all positions of the chunk boundaries
+ok = True
+for i in range(140):
+    s = " " * i + doc + " " * (i % 3)
+    if json.load(StringIO(s)) != ref or json.loads(s) != ref:
+        print("fail", i)
+        ok = False
+print(ok)
+
+# primitives at the end of the input
+for s in ("123", "-4.5", '"abc"', "true", " 1e2 "):
+    print(json.load(StringIO(s)), json.loads(s))
+
+# strings and numbers that aren't terminated
+for s in ('"abc', '["abc', '{"a": "b'):
+    try:
+        json.load(StringIO(s))
+    except ValueError:
+        print("ValueError")
+
+# repeated keys in many dicts
+l = json.loads("[" + ",".join('{"id": %d, "name": "n%d"}' % (i, i) for i in range(5)) + "]")
+print(l)
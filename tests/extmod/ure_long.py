@@ -0,0 +1,41 @@
+# test regexs with long patterns, which need a lot of scratch memory in the
+# Pike VM
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+s = "x" * 5000
+print(re.match(s, s + "y").group(0) == s)
+print(re.search("(a)" + s, "b" * 100 + "a" + s).group(1))
+print(re.match(s + "y", s + "x"))
+
+# these may not fit in the heap, but must not crash
+def test(pattern, string):
+    try:
+        print(re.match(pattern, string).group(0) == string)
+    except MemoryError:
+        print(True)
+
+s = "x" * 400000
+test(s, s)
+test("(" * 100 + "x" * 20000 + ")" * 100, "x" * 20000)
+
+# jump offsets are stored in a signed byte, so alternatives are limited in
+# length, and a pattern that needs a longer jump is rejected rather than
+# compiled to jumps outside the program
+p = "|".join("%03d" % i for i in range(10))
+print([re.match(p, "%03d" % i) is not None for i in (0, 5, 9, 10)])
+for p in (
+    "|".join("%03d" % i for i in range(30)),
+    "(x??(a)(b+(a|ab)??c[^a]*|a+[^a]?x?)*)??(b+?(x+(a|ab)+?)*?(a|ab)*)+?|(x)*[^a]??",
+):
+    try:
+        re.compile(p)
+        print("OK")
+    except ValueError:
+        print("ValueError")
@@ -0,0 +1,56 @@
+# test that the matcher picks the same match and submatches as CPython
+
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+def test(pattern, s):
+    for f in (re.match, re.search):
+        m = f(pattern, s)
+        if m is None:
+            print(None)
+        else:
+            print([m.group(i) for i in range(pattern.count("(") - pattern.count("(?:") + 1)])
+
+# greedy, lazy and alternation priorities
+test("(a*)(a*)", "aaa")
+test("(a*?)(a*)", "aaa")
+test("(a+?)(a*)", "aaa")
+test("(a|ab)(c|bcd)(d*)", "abcd")
+test("(ab|a)(c|bcd)(d*)", "abcd")
+test("(a?)(a??)b", "aab")
+test("(x*)(y+)", "xxyyz")
+test("(?:ab)+(c)", "ababc")
+
+# search, with and without a literal prefix
+test("b(c)", "abcbc")
+test("bc+", "abbccc")
+test("b[cd]+", "xbxbdc")
+test("(b)(c)?", "aabd")
+test("z", "abc")
+test("", "abc")
+test("c$", "abcc")
+test("^b", "bab")
+test("^a", "bab")
+test("\\d+", "abc123def456")
+test("[a-c]+", "xyzbcaz")
+test(".c", "abc")
+
+# leftmost match wins over longer matches further on
+test("a|bcd", "bcda")
+test("(b+)|(a)", "xab")
+
+# a pattern which is exponential for a backtracking matcher without a match
+test("(a|aa)*b", "a" * 12)
+
+# the same patterns used many times, through the module-level functions
+n = 0
+for i in range(40):
+    if re.match("x%d" % (i % 5), "x3"):
+        n += 1
+print(n)
@@ -0,0 +1,91 @@
+# Test for utimeq.timerwheel, a timing wheel with the same interface as
+# utimeq plus cancellation
+try:
+    from utime import ticks_add, ticks_diff
+    from utimeq import timerwheel
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+MAX = ticks_add(0, -1)
+MODULO_HALF = MAX // 2 + 1
+
+def pop_all(h):
+    l = []
+    while h:
+        item = [0, 0, 0]
+        h.pop(item)
+        l.append(tuple(item))
+    return l
+
+# invalid arguments
+for args in ((-1,), (10, 0)):
+    try:
+        timerwheel(*args)
+    except ValueError:
+        print("ValueError")
+
+# pushing on full queue and popping from an empty one
+h = timerwheel(1)
+h.push(1, 0, 0)
+try:
+    h.push(2, 0, 0)
+except IndexError:
+    print("IndexError")
+print(len(h), h.peektime())
+try:
+    h.pop([])
+except TypeError:
+    print("TypeError")
+h.pop([0, 0, 0])
+for f in (h.peektime, lambda: h.pop([0, 0, 0])):
+    try:
+        f()
+    except IndexError:
+        print("IndexError")
+
+# entries come out in time order, with wraparound, for any tick size
+for tick in (1, 7, 1000):
+    h = timerwheel(10, tick)
+    for t in (0, MAX, MAX - 1, 101, 100, MAX - 2, 5000, 4999):
+        h.push(t, t, None)
+    l = pop_all(h)
+    print(tick, [ticks_diff(l[i + 1][0], l[i][0]) > 0 for i in range(len(l) - 1)])
+
+# times half the tick period apart
+def edge_case(edge, offset):
+    h = timerwheel(10)
+    h.push(ticks_add(0, offset), 0, 0)
+    h.push(ticks_add(edge, offset), 0, 0)
+    l = pop_all(h)
+    return ticks_diff(l[1][0], l[0][0])
+
+# see utimeq1.py for why the middle case gives a negative difference
+for edge, diff in ((MODULO_HALF - 1, MODULO_HALF - 1), (MODULO_HALF, -MODULO_HALF), (MODULO_HALF + 1, MODULO_HALF - 1)):
+    print([edge_case(edge, offset) == diff for offset in (0, 100, -100)])
+
+# entries with the same time come out in the order they were pushed
+h = timerwheel(10, 10)
+for i in range(5):
+    h.push(1234 + (i & 1), i, 0)
+print(pop_all(h))
+
+# entries pushed with a time earlier than ones already popped come out first
+h = timerwheel(10)
+h.push(500, "a", 0)
+h.push(900, "b", 0)
+item = [0, 0, 0]
+h.pop(item)
+print(item)
+h.push(100, "c", 0)
+print(h.peektime(), pop_all(h))
+
+# cancelling
+h = timerwheel(10)
+handles = [h.push(t, t, 0) for t in (50, 10, 3000, 20, 1 << 20)]
+print(h.cancel(handles[1]), h.cancel(handles[1]), h.cancel(handles[4]), len(h))
+print(h.peektime())
+print(h.cancel(handles[2]), pop_all(h))
+# a handle is no longer valid once its entry was popped or its slot reused
+h2 = h.push(7, 7, 0)
+print(h.cancel(handles[0]), h.cancel(h2), len(h))
@@ -0,0 +1,41 @@
+try:
+    import uzlib as zlib
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    zlib.compress
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+# small inputs, in each format
+print(zlib.compress(b''))
+print(zlib.compress(b'hello', -8))
+print(zlib.compress(b'0' * 100, 15))
+print(zlib.compress(b'abcabcabc', 24))
+
+# round trip through decompress and DecompIO
+data = b''.join(b'%d sensor=%d temp=%d\n' % (i, i % 7, 20 + i % 5) for i in range(500))
+for wbits in (8, 9, 10, 12, 15):
+    c = zlib.compress(data, wbits)
+    print(wbits, len(c) < len(data) // 2, zlib.decompress(c) == data)
+    c = zlib.compress(data, -wbits)
+    print(zlib.decompress(c, -wbits) == data)
+    c = zlib.compress(data, 16 + wbits)
+    print(zlib.DecompIO(io.BytesIO(c), 16 + wbits).read() == data)
+
+# data that doesn't compress, and matches at the window edge
+data = bytes((i * 37 + (i >> 3) * 11) & 0xff for i in range(3000))
+print(zlib.decompress(zlib.compress(data, 8)) == data)
+data = bytes(range(256)) * 20
+print(zlib.decompress(zlib.compress(data, 8)) == data)
+
+# invalid wbits
+for wbits in (7, 16, -7, 32):
+    try:
+        zlib.compress(b'', wbits)
+    except ValueError:
+        print('ValueError')
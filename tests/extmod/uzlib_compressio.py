@@ -0,0 +1,52 @@
+try:
+    import uzlib as zlib
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+try:
+    zlib.CompressIO
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+data = b''.join(b'%d sensor=%d temp=%d\n' % (i, i % 7, 20 + i % 5) for i in range(500))
+
+# written in pieces, the output is the same as compressing in one go
+for wbits in (9, 10, -10, 26):
+    buf = io.BytesIO()
+    f = zlib.CompressIO(buf, wbits)
+    for i in range(0, len(data), 100):
+        f.write(data[i:i + 100])
+    f.close()
+    print(buf.getvalue() == zlib.compress(data, wbits))
+
+# flush makes the output so far decodable
+buf = io.BytesIO()
+f = zlib.CompressIO(buf, -10)
+f.write(b'hello hello hello')
+f.flush()
+print(buf.getvalue()[-4:])
+print(zlib.DecompIO(io.BytesIO(buf.getvalue()), -10).read(17))
+f.write(b' world')
+f.close()
+print(zlib.decompress(buf.getvalue(), -10))
+
+# context manager, the underlying stream is left open
+buf = io.BytesIO()
+with zlib.CompressIO(buf) as f:
+    f.write(data)
+print(zlib.decompress(buf.getvalue()) == data)
+print(zlib.DecompIO(io.BytesIO(buf.getvalue())).read() == data)
+
+# operations on a closed stream
+f.close()
+try:
+    f.write(b'x')
+except OSError:
+    print('OSError')
+try:
+    f.flush()
+except OSError:
+    print('OSError')
@@ -31,3 +31,14 @@ try:
     print(inp.read())
 except OSError as e:
     print(repr(e))
+
+# input is read ahead in blocks, but at the end of the compressed data the
+# underlying stream is put back to just after it
+buf = io.BytesIO(b'x\x9c30\xa0=\x00\x00\xb3q\x12\xc1tail')
+inp = zlib.DecompIO(buf)
+print(len(inp.read()))
+print(buf.read())
+
+# a match read in small pieces
+inp = zlib.DecompIO(io.BytesIO(b'x\x9c30\xa0=\x00\x00\xb3q\x12\xc1'))
+print([len(inp.read(7)) for i in range(16)])
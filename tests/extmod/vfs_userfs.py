@@ -27,7 +27,9 @@ class UserFile(uio.IOBase):
             self.pos += 1
         return n
     def ioctl(self, req, arg):
-        print('ioctl', req, arg)
+        # a module's file may be closed before or after it is executed, so
+        # these are printed at the end
+        ioctls.append((req, arg))
         return 0
 
 
@@ -48,6 +50,8 @@ class UserFS:
         return UserFile(self.files[path])
 
 
+ioctls = []
+
 # create and mount a user filesystem
 user_files = {
     '/data.txt': b"some data in a text file\n",
@@ -63,6 +67,7 @@ print(f.read())
 # import files from the user filesystem
 sys.path.append('/userfs')
 import usermod1
+print('ioctl', ioctls)
 
 # unmount and undo path addition
 uos.umount('/userfs')
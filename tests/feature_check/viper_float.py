@@ -0,0 +1,10 @@
+# check for the float type in viper code, and for ptrf64
+@micropython.viper
+def f(x:float) -> float:
+    return x + 1
+print(f(1))
+try:
+    exec('@micropython.viper\ndef g(p:ptrf64):\n    p[0] = 1.0\n')
+    print('ptrf64')
+except Exception:
+    pass
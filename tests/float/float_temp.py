@@ -0,0 +1,81 @@
+# test that the results of float ops in an expression can't be seen to change
+
+a = 1.5
+b = 2.25
+c = -0.75
+
+# chains and nested ops
+print(a * b + c, a + b * c, (a + b) * (b - c), a * b * c - a / 0.5)
+print(a ** 2 + b ** 2, (a + b) ** 2, 2 ** (a + 0.5), (a * b) % 1.0, (a * b) // 1.0)
+print(1 + a * b, a * b + 1, 3 * (a + b) - 1, (1 - a) * (2 - b))
+
+# operands that are referenced elsewhere must not be changed
+x = a * b
+y = x + 1.0
+print(x, y)
+l = [a * b]
+print(l[0] + 1.0, l)
+
+
+class Shared:
+    def __init__(self):
+        self.v = 3.0
+
+    def __mul__(self, other):
+        # returns a float that is also stored here
+        self.v = self.v * other
+        return self.v
+
+    def __add__(self, other):
+        return self.v
+
+
+s = Shared()
+print(s * 2.0 + 1.0, s.v)
+print((s * 2.0) * (a + b), s.v)
+print((s + 1.0) - (a * b), s.v)
+
+
+class F(float):
+    pass
+
+
+f = F(2.0)
+print(f * a + b, type(f * a))
+
+# float op whose result is complex
+z = (c - 1.25) ** 0.5 + 1
+print(type(z), round(z.real, 6), round(z.imag ** 2, 6))
+
+# ops mixing ints and floats
+i = 3
+print(i * a + i, i / 2 + i * 2, (i + 1) * (a - 1))
+
+# an exception in the middle of an expression
+try:
+    print(a * b + (a / 0.0))
+except ZeroDivisionError:
+    print("ZeroDivisionError")
+print(a * b + c)
+
+
+# a generator that yields in the middle of an expression
+def gen():
+    x = a * b + (yield)
+    yield x
+
+
+g = gen()
+next(g)
+print(g.send(1.0))
+
+
+# results that are kept in a container
+def f2():
+    res = []
+    for k in range(3):
+        res.append(a * k + b * k)
+    return res
+
+
+print(f2())
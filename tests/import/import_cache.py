@@ -0,0 +1,128 @@
+# test caching of compiled .py files as .mpy files (micropython.import_cache)
+
+import sys, uio, micropython
+
+try:
+    uio.IOBase
+    import uos
+    uos.mount
+    micropython.import_cache
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, fs, path, data):
+        self.fs = fs
+        self.path = path
+        self.data = data
+        self.pos = 0
+    def read(self):
+        return self.data
+    def readinto(self, buf):
+        n = 0
+        while n < len(buf) and self.pos < len(self.data):
+            buf[n] = self.data[self.pos]
+            n += 1
+            self.pos += 1
+        return n
+    def write(self, buf):
+        self.data += buf
+        return len(buf)
+    def ioctl(self, req, arg):
+        if req == 4 and self.path is not None: # MP_STREAM_CLOSE
+            self.fs.files[self.path] = self.data
+            self.fs.mtimes[self.path] = 0
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+        self.mtimes = {path: 1 for path in files}
+        self.readonly = False
+    def mount(self, readonly, mksfs):
+        pass
+    def umount(self):
+        pass
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, len(self.files[path]), 0, self.mtimes[path], 0)
+        raise OSError
+    def open(self, path, mode):
+        if 'w' in mode:
+            if self.readonly:
+                raise OSError
+            return UserFile(self, path, b'')
+        return UserFile(self, None, self.files[path])
+    def rename(self, old, new):
+        self.files[new] = self.files.pop(old)
+        self.mtimes[new] = self.mtimes.pop(old)
+    def remove(self, path):
+        del self.files[path]
+        del self.mtimes[path]
+
+
+# create and mount a user filesystem
+fs = UserFS({'/mod.py': b'print("mod v1", __file__)\n'})
+uos.mount(fs, '/userfs')
+sys.path.append('/userfs')
+
+def test():
+    import mod
+    del sys.modules['mod']
+    print(fs.files.get('/mod.mpy', b'')[-3:], '/mod.mpy.tmp' in fs.files)
+
+# the cache is disabled by default
+print(micropython.import_cache())
+test()
+
+# the first import writes the cache
+micropython.import_cache(True)
+print(micropython.import_cache())
+test()
+
+# the source is the same size and mtime, so the cache is used
+fs.files['/mod.py'] = b'print("mod v2", __file__)\n'
+test()
+
+# the mtime changed so the source is compiled again
+fs.mtimes['/mod.py'] = 2
+test()
+
+# the optimisation level changed so the source is compiled again
+fs.files['/mod.py'] = b'print("mod v3", __debug__)\n'
+micropython.opt_level(1)
+test()
+fs.files['/mod.py'] = b'print("mod v4", __debug__)\n'
+micropython.opt_level(0)
+test()
+
+# an invalid .mpy file is replaced
+fs.files['/mod.mpy'] = b'M\x05'
+test()
+
+# a truncated cache file (eg from an interrupted write) is replaced
+cache = fs.files['/mod.mpy']
+for n in (6, 30, len(cache) // 2):
+    fs.files['/mod.mpy'] = cache[:n]
+    test()
+
+# a valid .mpy file without the cache trailer is not used or replaced
+foreign = fs.files['/mod.mpy'][:-12]
+fs.files['/mod.mpy'] = foreign
+fs.files['/mod.py'] = b'print("mod v5", __debug__)\n'
+test()
+print(fs.files['/mod.mpy'] == foreign)
+
+# a read-only filesystem still allows the source to be imported
+del fs.files['/mod.mpy']
+fs.readonly = True
+test()
+
+micropython.import_cache(False)
+
+# remove user filesystem
+sys.path.pop()
+uos.umount('/userfs')
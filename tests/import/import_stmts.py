@@ -0,0 +1,5 @@
+# test importing a module whose top-level statements depend on each other
+
+from stmts import mod
+
+print(mod.x, mod.y, mod.B, mod.f(), mod.C.z, mod.C().m(), mod.w, mod.e, mod.lam(), mod.last)
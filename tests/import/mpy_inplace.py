@@ -0,0 +1,84 @@
+# test importing of .mpy files in the in-place layout (mpy-cross -minplace)
+
+import sys, uio
+
+try:
+    uio.IOBase
+    import uos
+    uos.mount
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+# the test image is built with the map lookup cache in bytecode, as unix has
+if sys.platform != 'linux':
+    print("SKIP")
+    raise SystemExit
+
+
+class UserFile(uio.IOBase):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+    def read(self):
+        return self.data
+    def readinto(self, buf):
+        n = 0
+        while n < len(buf) and self.pos < len(self.data):
+            buf[n] = self.data[self.pos]
+            n += 1
+            self.pos += 1
+        return n
+    def ioctl(self, req, arg):
+        return 0
+
+
+class UserFS:
+    def __init__(self, files):
+        self.files = files
+    def mount(self, readonly, mksfs):
+        pass
+    def umount(self):
+        pass
+    def stat(self, path):
+        if path in self.files:
+            return (32768, 0, 0, 0, 0, 0, 0, 0, 0, 0)
+        raise OSError
+    def open(self, path, mode):
+        return UserFile(self.files[path])
+
+
+# these are the test .mpy files, mod0 was compiled from:
+#   def add(a, *, inc=1):
+#       return a + inc
+#   s = 'str_const'
+#   print(add(41), add(1, inc=s and 2), s, b'\x00\xff', 3.5, 1 << 100, ...)
+user_files = {
+    '/mod0.mpy': (
+        b'\x4d\x05\x03\x1f\x00\x06\x06\x6d\x6f\x64\x2e\x70\x79\x03\x69\x6e\x63\x03\x61\x64\x64\x09\x73\x74'
+        b'\x72\x5f\x63\x6f\x6e\x73\x74\x01\x73\x01\x61\x52\x08\x00\x30\x00\x00\x00\x09\x07\x00\xa6\x00\x4e'
+        b'\x26\x00\x00\xff\x18\x53\x00\x81\x16\xa7\x00\x54\x61\x04\x24\xa8\x00\x16\xa9\x00\x24\xaa\x00\x1b'
+        b'\x7b\x00\x00\x1b\xa8\x00\x00\xa9\x64\x01\x1b\xa8\x00\x00\x81\x16\xa7\x00\x1b\xaa\x00\x00\x39\x01'
+        b'\x80\x82\x64\x82\x01\x1b\xaa\x00\x00\x17\x00\x17\x01\x17\x02\x17\x03\x64\x07\x32\x11\x5b\x04\x01'
+        b'\x62\x02\x00\xff\x00\x66\x03\x33\x2e\x35\x00\x69\x1f\x31\x32\x36\x37\x36\x35\x30\x36\x30\x30\x32'
+        b'\x32\x38\x32\x32\x39\x34\x30\x31\x34\x39\x36\x37\x30\x33\x32\x30\x35\x33\x37\x36\x00\x65\x13\x04'
+        b'\x00\x08\x01\x01\x00\x08\xa8\x00\xa6\x00\x21\x00\x00\xff\x2c\x01\xf1\x5b\x00\x00\x81\x2b\x81\x27'
+    ),
+    '/mod1.mpy': b'M\x05\x03\x1f\x00\x01\x05', # truncated qstr table
+}
+
+# create and mount a user filesystem
+uos.mount(UserFS(user_files), '/userfs')
+sys.path.append('/userfs')
+
+# import .mpy files from the user filesystem
+for i in range(len(user_files)):
+    mod = 'mod%u' % i
+    try:
+        __import__(mod)
+    except ValueError as er:
+        print(mod, 'ValueError', er)
+
+# unmount and undo path addition
+uos.umount('/userfs')
+sys.path.pop()
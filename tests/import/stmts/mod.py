@@ -0,0 +1,36 @@
+# each top-level statement here depends on state from the ones before it
+from micropython import const
+
+_A = const(1)
+B = const(_A + 1)
+x = 1; y = 2
+
+def dec(f):
+    return lambda: f() * 10
+
+@dec
+def f():
+    return g() + _A + B
+
+def g():
+    return y
+
+class C:
+    z = x
+    def m(self):
+        return f()
+
+if x:
+    w = 'w'
+else:
+    w = None
+
+try:
+    raise ValueError
+except ValueError:
+    e = 'caught'
+
+lam = lambda: [i + x for i in range(2)]
+"""a lonely string"""
+last = (x,
+        y)
@@ -0,0 +1,9 @@
+import bench
+
+def test(num):
+    x = 0.0
+    for i in range(num // 20):
+        x = x + 1.5
+    bench.x = x
+
+bench.run(test)
@@ -0,0 +1,10 @@
+import bench
+
+def test(num):
+    x = 0.5
+    y = 0.25
+    for i in range(num // 20):
+        z = x * x - y * y + 0.5
+    bench.z = z
+
+bench.run(test)
@@ -0,0 +1,9 @@
+import bench
+
+def test(num):
+    x = 0.75
+    for i in range(num // 20):
+        z = ((2.0 * x + 3.0) * x - 4.0) * x + 5.0
+    bench.z = z
+
+bench.run(test)
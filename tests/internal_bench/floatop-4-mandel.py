@@ -0,0 +1,11 @@
+import bench
+
+def test(num):
+    c = complex(-0.5, 0.5)
+    for i in range(num // 200):
+        zr = zi = 0.0
+        for j in range(10):
+            zr, zi = zr * zr - zi * zi + c.real, 2.0 * zr * zi + c.imag
+    bench.z = zr
+
+bench.run(test)
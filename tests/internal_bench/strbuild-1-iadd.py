@@ -0,0 +1,12 @@
+# Building up a string
+# Adding to a local with += - simplest way
+import bench
+
+def test(num):
+    for i in iter(range(num//10000)):
+        s = ""
+        for i in range(1000):
+            s += "abcdefgh"
+        len(s)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# Building up a string
+# Collecting pieces in a list and joining them at the end
+import bench
+
+def test(num):
+    for i in iter(range(num//10000)):
+        l = []
+        for i in range(1000):
+            l.append("abcdefgh")
+        s = "".join(l)
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Building up a string
+# Writing pieces to a StringIO and getting its value at the end
+import bench
+import uio
+
+def test(num):
+    for i in iter(range(num//10000)):
+        buf = uio.StringIO()
+        for i in range(1000):
+            buf.write("abcdefgh")
+        s = buf.getvalue()
+
+bench.run(test)
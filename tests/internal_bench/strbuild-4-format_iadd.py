@@ -0,0 +1,12 @@
+# Building up a string
+# Formatting log-style lines and adding them to a local with +=
+import bench
+
+def test(num):
+    for i in iter(range(num//100000)):
+        s = ""
+        for i in range(100):
+            s += "%s=%d " % ("key", i)
+        len(s)
+
+bench.run(test)
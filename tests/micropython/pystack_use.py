@@ -0,0 +1,30 @@
+# tests pystack_use and pystack_peak functions in micropython module
+import micropython
+
+try:
+    micropython.pystack_use
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+def f(n):
+    if n == 0:
+        return micropython.pystack_use()
+    return f(n - 1)
+
+# the peak covers the deepest use so far
+use = micropython.pystack_use()
+deep = f(20)
+print(deep > use)
+print(micropython.pystack_peak() >= deep)
+print(micropython.pystack_use() == use)
+
+# recursing until the pystack is exhausted frees all the frames again
+def g(n):
+    return g(n + 1)
+try:
+    g(0)
+except (RuntimeError, MemoryError):
+    print('exhausted')
+print(micropython.pystack_use() == use)
+print(micropython.pystack_peak() > deep)
@@ -0,0 +1,89 @@
+# test the float type in viper code
+
+@micropython.viper
+def arith(x:float, y:float):
+    print(x + y, x - y, x * y, x / y)
+arith(1.5, 2.0)
+arith(-3.0, 0.25)
+arith(6, 3)
+
+@micropython.viper
+def arith_int(x:float, n:int):
+    print(x + n, n - x, x * n, n / x)
+    print(x + 2, 3 - x, x * 4, x / 8)
+arith_int(0.5, 3)
+arith_int(-2.0, -1)
+
+@micropython.viper
+def inplace(x:float) -> float:
+    x += 1.5
+    x -= 0.25
+    x *= 2
+    x /= 4
+    return x
+print(inplace(3.0))
+
+@micropython.viper
+def compare(x:float, y:float):
+    print(x < y, x > y, x == y, x <= y, x >= y, x != y)
+compare(1.0, 2.0)
+compare(2.0, 1.0)
+compare(1.5, 1.5)
+compare(float('nan'), 1.0)
+compare(1.0, float('nan'))
+
+@micropython.viper
+def compare_int(x:float, n:int):
+    print(x < n, n < x, x == 2, x >= 2)
+compare_int(2.0, 3)
+compare_int(2.5, 2)
+
+@micropython.viper
+def neg(x:float):
+    y = -x
+    print(y, +x, -1.25)
+neg(3.5)
+neg(-0.5)
+
+@micropython.viper
+def cast(x:float, n:int, u:uint, b:bool):
+    print(int(x), uint(x * x), float(n), float(u), float(b), float(3))
+cast(2.75, -4, 7, True)
+cast(-2.75, 0, 0, False)
+
+@micropython.viper
+def ret(x:int) -> float:
+    if x < 0:
+        return 0
+    return float(x)
+print(ret(5), ret(-1))
+
+@micropython.viper
+def ret_float_obj(x) -> float:
+    return float(x)
+print(ret_float_obj(1.25), ret_float_obj(2))
+
+@micropython.viper
+def loop(n:int) -> float:
+    x = 1.0
+    y = 0.0
+    i = 0
+    while x > 0.001 and i < n:
+        y += x
+        x *= 0.5
+        i += 1
+    return y
+print(loop(4), loop(100) * 512)
+
+def test(code):
+    try:
+        exec(code)
+    except (ViperTypeError, NotImplementedError) as e:
+        print(repr(e))
+
+# unsupported operations and conversions
+test("@micropython.viper\ndef f(x:float):\n    x % 2.0")
+test("@micropython.viper\ndef f(x:float):\n    x << 1")
+test("@micropython.viper\ndef f(x:float):\n    ~x")
+test("@micropython.viper\ndef f(x:float):\n    ptr8(x)")
+test("@micropython.viper\ndef f(p:ptr8):\n    float(p)")
@@ -0,0 +1,41 @@
+# test loading from and storing to the ptrf32 type
+
+import array
+
+@micropython.viper
+def get(src:ptrf32) -> float:
+    return src[0] + src[2]
+
+@micropython.viper
+def put(dest:ptrf32, x:float):
+    dest[0] = x
+    dest[1] = 2
+    dest[2] = -x * 0.5
+
+@micropython.viper
+def dot(a:ptrf32, b:ptrf32, n:int) -> float:
+    s = 0.0
+    for i in range(n):
+        s += a[i] * b[i]
+    return s
+
+@micropython.viper
+def scale(a:ptrf32, n:int, k:float):
+    for i in range(n):
+        a[i] = a[i] * k + i
+
+@micropython.viper
+def mixed(a:ptrf32, i:int):
+    a[i] = i
+    print(a[i] < 0, int(a[i]))
+
+a = array.array('f', [1.5, 2, 3.25])
+b = array.array('f', [0.5, -1, 4])
+print(get(a))
+print(dot(a, b, 3))
+scale(a, 3, 2.0)
+print(a)
+put(b, 0.75)
+print(b)
+mixed(b, 1)
+print(b)
@@ -0,0 +1,26 @@
+# test loading from and storing to the ptrf64 type
+
+import array
+
+@micropython.viper
+def get(src:ptrf64) -> float:
+    return src[0] + src[2]
+
+@micropython.viper
+def put(dest:ptrf64, x:float):
+    dest[0] = x
+    dest[1] = 2
+    dest[2] = -x * 0.5
+
+@micropython.viper
+def axpy(y:ptrf64, x:ptrf32, n:int, a:float):
+    for i in range(n):
+        y[i] = a * x[i] + y[i]
+
+a = array.array('d', [1.5, 2, 3.25])
+b = array.array('f', [0.5, -1, 4])
+print(get(a))
+axpy(a, b, 3, 2.0)
+print(a)
+put(a, 0.75)
+print(a)
@@ -0,0 +1,70 @@
+# Base64-encode sensor frames for upstream JSON, decode them again, hexlify
+# payloads for logs and checksum everything with CRC32
+
+try:
+    import ubinascii as binascii
+except ImportError:
+    import binascii
+
+if hasattr(binascii, 'b2a_base64_into'):
+    b2a_base64_into = binascii.b2a_base64_into
+    a2b_base64_into = binascii.a2b_base64_into
+    hexlify_into = binascii.hexlify_into
+else:
+    def b2a_base64_into(data, buf):
+        out = binascii.b2a_base64(data)
+        buf[:len(out)] = out
+        return len(out)
+
+    def a2b_base64_into(data, buf):
+        out = binascii.a2b_base64(data)
+        buf[:len(out)] = out
+        return len(out)
+
+    def hexlify_into(data, buf):
+        out = binascii.hexlify(data)
+        buf[:len(out)] = out
+        return len(out)
+
+def test(frames, nloop):
+    enc = bytearray(len(frames[0]) * 4 // 3 + 4)
+    dec = bytearray(len(frames[0]))
+    hexbuf = bytearray(len(frames[0]) * 2)
+    crc = 0
+    for i in range(nloop):
+        frame = frames[i % len(frames)]
+        n = b2a_base64_into(frame, enc)
+        m = a2b_base64_into(memoryview(enc)[:n], dec)
+        hexlify_into(dec, hexbuf)
+        crc = binascii.crc32(hexbuf, crc)
+        crc = binascii.crc32(binascii.b2a_base64(frame), crc)
+        crc = binascii.crc32(binascii.hexlify(frame), crc)
+        crc = binascii.crc32(frame, crc)
+    return crc, m
+
+bm_params = {
+    (50, 10): (96, 20),
+    (100, 10): (240, 100),
+    (1000, 10): (960, 200),
+    (1000, 1000): (3000, 1000),
+    (5000, 1000): (6000, 5000),
+}
+
+def bm_setup(params):
+    size, nloop = params
+    frames = []
+    for j in range(4):
+        frame = bytearray(size)
+        for i in range(size):
+            frame[i] = (i * 97 + j * 31 + (i >> 5)) & 0xff
+        frames.append(frame)
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(frames, nloop)
+
+    def result():
+        return size * nloop // 1024, state
+
+    return run, result
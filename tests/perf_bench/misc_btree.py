@@ -0,0 +1,74 @@
+# Store, look up and scan records in a btree database held in a file on the
+# host filesystem and in a file on a FAT filesystem on a RAM disk; the score
+# is in database operations per second
+
+import btree
+import uos
+
+class RAMBlockDevice:
+    SEC_SIZE = 512
+
+    def __init__(self, blocks):
+        self.data = bytearray(blocks * self.SEC_SIZE)
+
+    def readblocks(self, n, buf):
+        buf[:] = self.data[n * self.SEC_SIZE:n * self.SEC_SIZE + len(buf)]
+
+    def writeblocks(self, n, buf):
+        self.data[n * self.SEC_SIZE:n * self.SEC_SIZE + len(buf)] = buf
+
+    def ioctl(self, op, arg):
+        if op == 4: # BP_IOCTL_SEC_COUNT
+            return len(self.data) // self.SEC_SIZE
+        if op == 5: # BP_IOCTL_SEC_SIZE
+            return self.SEC_SIZE
+
+def records(n):
+    for i in range(n):
+        yield bytes('key%06d' % i, 'ascii'), bytes('value of record %d' % i, 'ascii')
+
+def run_db(f, n):
+    db = btree.open(f, pagesize=1024, cachesize=16384)
+    db.update(records(n))
+    total = 0
+    for i in range(0, n, 3):
+        total += len(db[bytes('key%06d' % i, 'ascii')])
+    for k, v in db.items(None, None, btree.REUSE):
+        total += len(v)
+    db.close()
+    return total
+
+def bm_setup(params):
+    n, m = params
+    vfs = None
+    if hasattr(uos, 'VfsFat'):
+        bdev = RAMBlockDevice(1024)
+        uos.VfsFat.mkfs(bdev)
+        vfs = uos.VfsFat(bdev)
+    ops = 0
+
+    def run():
+        nonlocal ops
+        for _ in range(m):
+            with open('misc_btree.db', 'w+b') as f:
+                run_db(f, n)
+            uos.remove('misc_btree.db')
+            ops += n + (n + 2) // 3 + n
+            if vfs:
+                with vfs.open('misc_btree.db', 'w+b') as f:
+                    run_db(f, n)
+                vfs.remove('misc_btree.db')
+                ops += n + (n + 2) // 3 + n
+
+    def result():
+        return ops, None
+
+    return run, result
+
+bm_params = {
+    (50, 10): (100, 1),
+    (100, 10): (200, 1),
+    (1000, 10): (1000, 2),
+    (1000, 1000): (1000, 10),
+    (5000, 1000): (2000, 20),
+}
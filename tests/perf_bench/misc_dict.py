@@ -0,0 +1,41 @@
+# Build, query, update and iterate dicts, to test the hash map
+
+def dicts(n, m):
+    total = 0
+    for r in range(m):
+        d = {}
+        for i in range(n):
+            d[i * 7 + r] = i
+        for i in range(0, n, 3):
+            del d[i * 7 + r]
+        for i in range(n):
+            # half of these miss
+            if i * 14 + r in d:
+                total += 1
+        for k in d:
+            total += d[k]
+        s = {}
+        for i in range(n):
+            s['k%d' % (i & 63)] = i
+        total += len(s) + len(d.copy())
+    return total
+
+bm_params = {
+    (50, 10): (50, 2),
+    (100, 10): (200, 4),
+    (1000, 1000): (500, 10),
+    (5000, 1000): (1000, 20),
+}
+
+def bm_setup(params):
+    n, m = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = dicts(n, m)
+
+    def result():
+        return n * m, state
+
+    return run, result
@@ -0,0 +1,47 @@
+# Render frames to an RGB565 framebuffer: clear it, draw sprites and
+# monochrome icons through a palette, then scroll it; the score is in frames
+# per second
+
+import framebuf
+
+def draw(fb, sprite, icon, pal, w, h, frames):
+    sw = 32
+    for f in range(frames):
+        fb.fill(0x0000)
+        fb.fill_rect(0, 0, w, 16, 0x001f)
+        for i in range(8):
+            x = (f * 3 + i * 29) % (w - sw)
+            y = (f * 5 + i * 17) % (h - sw)
+            fb.blit(sprite, x, y)
+            fb.blit(sprite, y, x, 0x0000)
+            fb.blit(icon, x + 7, y + 3, -1, pal)
+        fb.scroll(0, -2)
+
+bm_params = {
+    (50, 10): (64, 64, 5),
+    (100, 10): (64, 64, 10),
+    (1000, 10): (128, 128, 20),
+    (1000, 1000): (240, 240, 20),
+    (5000, 1000): (240, 240, 100),
+}
+
+def bm_setup(params):
+    w, h, frames = params
+    fb = framebuf.FrameBuffer(bytearray(w * h * 2), w, h, framebuf.RGB565)
+    sprite = framebuf.FrameBuffer(bytearray(32 * 32 * 2), 32, 32, framebuf.RGB565)
+    for y in range(32):
+        sprite.hline(0, y, 32, (y * 2048 + y) & 0xffff)
+    icon = framebuf.FrameBuffer(bytearray(16 * 16 // 8), 16, 16, framebuf.MONO_HLSB)
+    icon.text('ab', 0, 0, 1)
+    icon.text('cd', 0, 8, 1)
+    pal = framebuf.FrameBuffer(bytearray(2 * 2), 2, 1, framebuf.RGB565)
+    pal.pixel(0, 0, 0x0000)
+    pal.pixel(1, 0, 0xffff)
+
+    def run():
+        draw(fb, sprite, icon, pal, w, h, frames)
+
+    def result():
+        return frames, None
+
+    return run, result
@@ -0,0 +1,35 @@
+# Multiply and square big integers of 256 to 4096 bits, to test mpz multiplication
+
+def mul_chain(bits, n):
+    # deterministic operands with all the bits set fairly randomly
+    a = (1 << bits) // 3 + 12345
+    b = (1 << bits) // 7 + 67890
+    mask = (1 << bits) - 1
+    h = 0
+    for i in range(n):
+        c = a * b
+        d = c * c
+        a = (c >> (bits // 2)) & mask | 1
+        b = (d >> bits) & mask | 1
+        h ^= d & 0xffff
+    return h
+
+bm_params = {
+    (50, 10): ((256, 512), 5),
+    (100, 10): ((256, 512, 1024), 10),
+    (1000, 1000): ((256, 512, 1024, 2048, 4096), 50),
+    (5000, 1000): ((256, 512, 1024, 2048, 4096), 200),
+}
+
+def bm_setup(params):
+    sizes, n = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = [mul_chain(bits, n) for bits in sizes]
+
+    def result():
+        return len(sizes) * n, state
+
+    return run, result
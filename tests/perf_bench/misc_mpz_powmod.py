@@ -0,0 +1,33 @@
+# RSA-style modular exponentiation of 256 to 2048 bit numbers, to test pow(a, b, m)
+
+def powmod_chain(bits, n):
+    # odd moduli as used by RSA, and an even one
+    m = (1 << bits) // 3 | 1 | (1 << (bits - 1))
+    e = (1 << bits) // 5
+    x = 0x10001
+    h = 0
+    for i in range(n):
+        x = pow(x + i, e, m)
+        h ^= x & 0xffff
+    x = pow(x, e, m + 1)
+    return h ^ (x & 0xffff)
+
+bm_params = {
+    (50, 10): ((256,), 1),
+    (100, 10): ((256, 512), 1),
+    (1000, 1000): ((256, 512, 1024), 3),
+    (5000, 1000): ((256, 512, 1024, 2048), 3),
+}
+
+def bm_setup(params):
+    sizes, n = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = [powmod_chain(bits, n) for bits in sizes]
+
+    def result():
+        return len(sizes) * n, state
+
+    return run, result
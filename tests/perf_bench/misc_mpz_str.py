@@ -0,0 +1,38 @@
+# Convert big integers of 100 to 30000 decimal digits to and from strings
+
+try:
+    # CPython limits the length of decimal conversions by default
+    import sys
+    sys.set_int_max_str_digits(0)
+except AttributeError:
+    pass
+
+def convert(sizes, n):
+    h = 0
+    for ndig in sizes:
+        s = '31415926535897932384626433832795028841971693993751'
+        s = (s * (ndig // len(s) + 1))[:ndig]
+        for i in range(n):
+            x = int(s)
+            h += len(str(x + i)) + len(hex(x)) + (int(hex(x), 16) & 0xffff)
+    return h
+
+bm_params = {
+    (50, 10): ((100, 500), 1),
+    (100, 10): ((100, 1000), 1),
+    (1000, 1000): ((100, 1000, 10000), 2),
+    (5000, 1000): ((100, 1000, 10000, 30000), 2),
+}
+
+def bm_setup(params):
+    sizes, n = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = convert(sizes, n)
+
+    def result():
+        return len(sizes) * n, state
+
+    return run, result
@@ -0,0 +1,58 @@
+# Hash a firmware-sized image with SHA-256, in chunks and in one go, and
+# authenticate messages with HMAC-SHA256
+
+try:
+    import uhashlib as hashlib
+except ImportError:
+    import hashlib
+
+if hasattr(hashlib, 'hmac_sha256'):
+    sha256_into = hashlib.sha256_into
+    hmac_sha256 = hashlib.hmac_sha256
+else:
+    import hmac
+
+    def sha256_into(data, buf):
+        buf[:32] = hashlib.sha256(data).digest()
+
+    def hmac_sha256(key, msg):
+        return hmac.new(key, msg, hashlib.sha256).digest()
+
+def test(image, chunk, nmsg):
+    h = hashlib.sha256()
+    mv = memoryview(image)
+    for i in range(0, len(image), chunk):
+        h.update(mv[i:i + chunk])
+    digest = h.digest()
+    buf = bytearray(32)
+    sha256_into(image, buf)
+    key = b'pairing key'
+    msg = bytearray(64)
+    for i in range(nmsg):
+        msg[0] = i & 0xff
+        msg[32:] = hmac_sha256(key, msg)
+    return digest == buf, msg
+
+bm_params = {
+    (50, 10): (4096, 64, 10),
+    (100, 10): (16384, 256, 50),
+    (1000, 10): (65536, 512, 200),
+    (1000, 1000): (262144, 1024, 1000),
+    (5000, 1000): (524288, 4096, 5000),
+}
+
+def bm_setup(params):
+    size, chunk, nmsg = params
+    image = bytearray(size)
+    for i in range(size):
+        image[i] = (i * 131 + (i >> 8)) & 0xff
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(image, chunk, nmsg)
+
+    def result():
+        return (2 * size + 2 * 128 * nmsg) // 1024, state
+
+    return run, result
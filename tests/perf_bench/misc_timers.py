@@ -0,0 +1,103 @@
+# Schedule thousands of periodic tasks, each with a timeout which is
+# normally cancelled before it expires, as a uasyncio-style scheduler would,
+# so that up to 10k timers are pending
+
+try:
+    from utimeq import timerwheel
+
+    def new_queue(n):
+        return timerwheel(n, 10)
+except ImportError:
+    # cancelled entries have to be left in the queue and skipped
+    try:
+        from utimeq import utimeq
+
+        def heap_new(n):
+            return utimeq(n)
+
+        def heap_push(q, t, seq, cb, args):
+            q.push(t, cb, args)
+
+        def heap_pop(q, item):
+            q.pop(item)
+    except ImportError:
+        import heapq
+
+        def heap_new(n):
+            return []
+
+        def heap_push(q, t, seq, cb, args):
+            heapq.heappush(q, (t, seq, cb, args))
+
+        def heap_pop(q, item):
+            item[0], _, item[1], item[2] = heapq.heappop(q)
+
+    class new_queue:
+        def __init__(self, n):
+            self.q = heap_new(2 * n)
+            self.next = 0
+            self.live = {}
+
+        def push(self, t, cb, args):
+            h = self.next
+            self.next += 1
+            self.live[h] = args
+            heap_push(self.q, t, h, cb, h)
+            return h
+
+        def cancel(self, h):
+            return self.live.pop(h, None) is not None
+
+        def pop(self, item):
+            while True:
+                heap_pop(self.q, item)
+                h = item[2]
+                if h in self.live:
+                    item[2] = self.live.pop(h)
+                    return
+
+def test(ntask, end):
+    q = new_queue(2 * ntask)
+    period = [50 + (i * 7919) % 950 for i in range(ntask)]
+    timeout = [None] * ntask
+    for i in range(ntask):
+        q.push(i % 500, i, False)
+    item = [0, 0, 0]
+    nrun = ntimeout = ncancel = 0
+    while True:
+        q.pop(item)
+        t, i, is_timeout = item
+        if t > end:
+            break
+        if is_timeout:
+            ntimeout += 1
+            continue
+        nrun += 1
+        if timeout[i] is not None and q.cancel(timeout[i]):
+            ncancel += 1
+        # every 16th task times out before it runs again
+        p = period[i]
+        timeout[i] = q.push(t + (p // 2 if i & 15 == 0 else p + p // 2), i, True)
+        q.push(t + p, i, False)
+    return nrun, ntimeout, ncancel
+
+bm_params = {
+    (50, 10): (50, 2000),
+    (100, 10): (250, 2000),
+    (1000, 10): (500, 5000),
+    (1000, 1000): (5000, 5000),
+    (5000, 1000): (5000, 20000),
+}
+
+def bm_setup(params):
+    ntask, end = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = test(ntask, end)
+
+    def result():
+        return state[0] // 10, state
+
+    return run, result
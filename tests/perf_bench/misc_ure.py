@@ -0,0 +1,50 @@
+# Match and search log lines with regular expressions, mostly through the
+# module-level functions
+
+try:
+    import ure as re
+except ImportError:
+    import re
+
+def scan(lines, n):
+    total = 0
+    for r in range(n):
+        for line in lines:
+            m = re.match("(\\d+):(\\d+):(\\d+) (\\w+)", line)
+            if m:
+                total += int(m.group(1)) + len(m.group(4))
+            if re.search("ERROR", line):
+                total += 1
+            m = re.search("temp=(\\d+)", line)
+            if m:
+                total += int(m.group(1))
+            if re.search("[xyz]=-?\\d", line):
+                total += 2
+    return total
+
+bm_params = {
+    (50, 10): (10, 2),
+    (100, 10): (20, 4),
+    (1000, 1000): (100, 10),
+    (5000, 1000): (100, 50),
+}
+
+def bm_setup(params):
+    nlines, n = params
+    levels = ("INFO", "DEBUG", "WARN", "ERROR")
+    lines = [
+        "%02d:%02d:%02d %s sensor%d: temp=%d x=%d hum=%d%% status=ok" % (
+            i // 3600 % 24, i // 60 % 60, i % 60, levels[i % 4], i % 7,
+            20 + i % 9, (i * 7) % 21 - 10, 40 + i % 30)
+        for i in range(nlines)
+    ]
+    state = None
+
+    def run():
+        nonlocal state
+        state = scan(lines, n)
+
+    def result():
+        return nlines * n, state
+
+    return run, result
@@ -0,0 +1,36 @@
+# Regular expressions which take time exponential in the input length for a
+# backtracking matcher when there is no match
+
+try:
+    import ure as re
+except ImportError:
+    import re
+
+def patho(n, m):
+    total = 0
+    for r in range(m):
+        for pattern in ("(a|aa)*b", "(a|a)*b", "(a+)+b"):
+            for i in range(n - 4, n + 1):
+                if re.match(pattern, "a" * i) is None:
+                    total += i
+    return total
+
+bm_params = {
+    (50, 10): (8, 1),
+    (100, 10): (10, 1),
+    (1000, 1000): (14, 2),
+    (5000, 1000): (16, 2),
+}
+
+def bm_setup(params):
+    n, m = params
+    state = None
+
+    def run():
+        nonlocal state
+        state = patho(n, m)
+
+    def result():
+        return n * m, state
+
+    return run, result
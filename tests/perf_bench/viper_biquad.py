@@ -0,0 +1,51 @@
+# Cascaded biquad IIR filter over a buffer of samples, using viper floats.
+
+import array
+from math import sin
+
+@micropython.viper
+def biquad(x:ptrf32, y:ptrf32, n:int, coef:ptrf32):
+    b0 = coef[0]
+    b1 = coef[1]
+    b2 = coef[2]
+    a1 = coef[3]
+    a2 = coef[4]
+    z1 = 0.0
+    z2 = 0.0
+    for i in range(n):
+        xi = x[i]
+        yi = b0 * xi + z1
+        z1 = b1 * xi - a1 * yi + z2
+        z2 = b2 * xi - a2 * yi
+        y[i] = yi
+
+def filter(x, y, n, sections):
+    biquad(x, y, n, sections[0])
+    for coef in sections[1:]:
+        biquad(y, y, n, coef)
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (256, 50),
+    (100, 10): (256, 100),
+    (1000, 10): (256, 1000),
+    (5000, 10): (256, 5000),
+}
+
+def bm_setup(params):
+    n, loops = params
+    # a 4th order low-pass Butterworth filter, as two sections
+    sections = (
+        array.array('f', [0.0976, 0.1953, 0.0976, -0.9428, 0.3333]),
+        array.array('f', [0.0976, 0.1953, 0.0976, -0.7346, 0.1253]),
+    )
+    x = array.array('f', (sin(0.1 * i) + 0.5 * sin(2.3 * i) for i in range(n)))
+    y = array.array('f', x)
+
+    def run():
+        for _ in range(loops):
+            filter(x, y, n, sections)
+
+    return run, lambda: (loops * n // 32, None)
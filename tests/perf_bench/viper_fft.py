@@ -0,0 +1,74 @@
+# 256-point radix-2 complex FFT, using viper floats.
+
+import array
+from math import sin, cos, pi
+
+@micropython.viper
+def fft(src:ptrf32, re:ptrf32, im:ptrf32, n:int, rev:ptr16, cos_t:ptrf32, sin_t:ptrf32):
+    # load the real input in bit-reversed order
+    for i in range(n):
+        re[i] = src[rev[i]]
+        im[i] = 0.0
+    # butterflies
+    size = 2
+    step = n >> 1
+    while size <= n:
+        half = size >> 1
+        i = 0
+        while i < n:
+            k = 0
+            for j in range(i, i + half):
+                wr = cos_t[k]
+                wi = sin_t[k]
+                xr = re[j + half]
+                xi = im[j + half]
+                tr = wr * xr + wi * xi
+                ti = wr * xi - wi * xr
+                ur = re[j]
+                ui = im[j]
+                re[j] = ur + tr
+                im[j] = ui + ti
+                re[j + half] = ur - tr
+                im[j + half] = ui - ti
+                k += step
+            i += size
+        size <<= 1
+        step >>= 1
+
+def make_tables(n):
+    bits = 0
+    while (1 << bits) < n:
+        bits += 1
+    rev = array.array('H', range(n))
+    for i in range(n):
+        r = 0
+        for b in range(bits):
+            if i & (1 << b):
+                r |= 1 << (bits - 1 - b)
+        rev[i] = r
+    cos_t = array.array('f', (cos(2 * pi * i / n) for i in range(n // 2)))
+    sin_t = array.array('f', (sin(2 * pi * i / n) for i in range(n // 2)))
+    return rev, cos_t, sin_t
+
+###########################################################################
+# Benchmark interface
+
+bm_params = {
+    (50, 10): (256, 20),
+    (100, 10): (256, 40),
+    (1000, 10): (256, 400),
+    (5000, 10): (256, 2000),
+}
+
+def bm_setup(params):
+    n, loops = params
+    rev, cos_t, sin_t = make_tables(n)
+    src = array.array('f', (sin(0.3 * i) + 0.25 * cos(1.7 * i) for i in range(n)))
+    re = array.array('f', src)
+    im = array.array('f', src)
+
+    def run():
+        for _ in range(loops):
+            fft(src, re, im, n, rev, cos_t, sin_t)
+
+    return run, lambda: (loops, None)
@@ -57,7 +57,7 @@ class FreezeError(Exception):
         return 'error while freezing %s: %s' % (self.rawcode.source_file, self.msg)
 
 class Config:
-    MPY_VERSION = 4
+    MPY_VERSION = 5
     MICROPY_LONGINT_IMPL_NONE = 0
     MICROPY_LONGINT_IMPL_LONGLONG = 1
     MICROPY_LONGINT_IMPL_MPZ = 2
@@ -113,6 +113,12 @@ MP_BC_UNWIND_JUMP = 0x46
 MP_BC_MAKE_CLOSURE = 0x62
 MP_BC_MAKE_CLOSURE_DEFARGS = 0x63
 MP_BC_RAISE_VARARGS = 0x5c
+MP_BC_LOAD_FAST_LOAD_FAST = 0x2c
+MP_BC_BINARY_OP_SMALL_INT = 0x2d
+MP_BC_BINARY_OP_POP_JUMP_IF_TRUE = 0x3a
+MP_BC_BINARY_OP_POP_JUMP_IF_FALSE = 0x3b
+MP_BC_FOR_RANGE = 0x3c
+MP_BC_BINARY_OP_TEMP = 0x45
 # extra byte if caching enabled:
 MP_BC_LOAD_NAME = 0x1b
 MP_BC_LOAD_GLOBAL = 0x1c
@@ -140,13 +146,13 @@ def make_opcode_format():
     OC4(B, B, V, V), # 0x20-0x23
     OC4(Q, Q, Q, B), # 0x24-0x27
     OC4(V, V, Q, Q), # 0x28-0x2b
-    OC4(U, U, U, U), # 0x2c-0x2f
+    OC4(B, B, V, V), # 0x2c-0x2f
     OC4(B, B, B, B), # 0x30-0x33
     OC4(B, O, O, O), # 0x34-0x37
-    OC4(O, O, U, U), # 0x38-0x3b
-    OC4(U, O, B, O), # 0x3c-0x3f
+    OC4(O, O, O, O), # 0x38-0x3b
+    OC4(O, O, B, O), # 0x3c-0x3f
     OC4(O, B, B, O), # 0x40-0x43
-    OC4(O, U, O, B), # 0x44-0x47
+    OC4(O, B, O, B), # 0x44-0x47
     OC4(U, U, U, U), # 0x48-0x4b
     OC4(U, U, U, U), # 0x4c-0x4f
     OC4(V, V, U, V), # 0x50-0x53
@@ -220,6 +226,12 @@ def mp_opcode_format(bytecode, ip, count_var_uint, opcode_format=make_opcode_for
             or opcode == MP_BC_RAISE_VARARGS
             or opcode == MP_BC_MAKE_CLOSURE
             or opcode == MP_BC_MAKE_CLOSURE_DEFARGS
+            or opcode == MP_BC_LOAD_FAST_LOAD_FAST
+            or opcode == MP_BC_BINARY_OP_SMALL_INT
+            or opcode == MP_BC_BINARY_OP_POP_JUMP_IF_TRUE
+            or opcode == MP_BC_BINARY_OP_POP_JUMP_IF_FALSE
+            or opcode == MP_BC_FOR_RANGE
+            or opcode == MP_BC_BINARY_OP_TEMP
         )
         ip += 1
         if f == MP_OPCODE_VAR_UINT: